@@ -38,6 +38,7 @@
 #define __LOS_ARCH_MMU_H__
 
 #include "los_typedef.h"
+#include "los_atomic.h"
 #include "los_vm_phys.h"
 #ifndef LOSCFG_PAGE_TABLE_FINE_LOCK
 #include "los_spinlock.h"
@@ -55,7 +56,7 @@ typedef struct ArchMmu {
 #endif
     VADDR_T             *virtTtb;       /**< translation table base virtual addr */
     PADDR_T             physTtb;        /**< translation table base phys addr */
-    UINT32              asid;           /**< TLB asid */
+    Atomic64            asid;           /**< TLB asid generation and hardware asid */
     LOS_DL_LIST         ptList;         /**< page table vm page list */
 } LosArchMmu;
 
@@ -63,8 +64,11 @@ BOOL OsArchMmuInit(LosArchMmu *archMmu, VADDR_T *virtTtb);
 STATUS_T LOS_ArchMmuQuery(const LosArchMmu *archMmu, VADDR_T vaddr, PADDR_T *paddr, UINT32 *flags);
 STATUS_T LOS_ArchMmuUnmap(LosArchMmu *archMmu, VADDR_T vaddr, size_t count);
 STATUS_T LOS_ArchMmuMap(LosArchMmu *archMmu, VADDR_T vaddr, PADDR_T paddr, size_t count, UINT32 flags);
+STATUS_T LOS_ArchMmuMapReplace(LosArchMmu *archMmu, VADDR_T vaddr, const PADDR_T *oldPaddr, PADDR_T paddr,
+                               UINT32 flags);
 STATUS_T LOS_ArchMmuChangeProt(LosArchMmu *archMmu, VADDR_T vaddr, size_t count, UINT32 flags);
 STATUS_T LOS_ArchMmuMove(LosArchMmu *archMmu, VADDR_T oldVaddr, VADDR_T newVaddr, size_t count, UINT32 flags);
+STATUS_T LOS_ArchMmuCowClone(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, size_t count);
 VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu);
 STATUS_T LOS_ArchMmuDestroy(LosArchMmu *archMmu);
 VOID OsArchMmuInitPerCPU(VOID);
@@ -38,6 +38,7 @@
 #define __LOS_ASID_H__
 
 #include "los_typedef.h"
+#include "los_atomic.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -46,10 +47,14 @@ extern "C" {
 #endif /* __cplusplus */
 
 #define MMU_ARM_ASID_BITS           8
+#define MMU_ARM_ASID_MASK           ((1UL << MMU_ARM_ASID_BITS) - 1)
+#define MMU_ARM_ASID_KERNEL         0
 
-/* allocate and free asid */
-STATUS_T OsAllocAsid(UINT32 *asid);
-VOID OsFreeAsid(UINT32 asid);
+/* hardware asid of a context id, 0 for a space that has never been switched in */
+#define OS_ASID_HW(contextId)       ((UINT32)((UINT64)(contextId) & MMU_ARM_ASID_MASK))
+
+/* make sure the context id belongs to the current asid generation and return its hardware asid */
+UINT32 OsAsidCheck(Atomic64 *contextId);
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -49,6 +49,7 @@
 #ifdef __LP64__
 
 #define TIMER_REG_CNTFRQ            cntfrq_el0
+#define TIMER_REG_CNTKCTL           cntkctl_el1
 
 /* CNTP AArch64 registers */
 #define TIMER_REG_CNTP_CTL          cntp_ctl_el0
@@ -70,6 +71,7 @@
 #else /* Aarch32 */
 
 #define TIMER_REG_CNTFRQ            CP15_REG(c14, 0, c0, 0)
+#define TIMER_REG_CNTKCTL           CP15_REG(c14, 0, c1, 0)
 
 /* CNTP AArch32 registers */
 #define TIMER_REG_CNTP_CTL          CP15_REG(c14, 0, c2, 1)
@@ -87,6 +89,8 @@
 
 #endif
 
+#define CNTKCTL_PL0PCTEN            (1U << 0)   /* user mode may read the physical count */
+
 UINT32 HalClockFreqRead(VOID)
 {
     return READ_TIMER_REG32(TIMER_REG_CNTFRQ);
@@ -140,6 +144,11 @@ LITE_OS_SEC_TEXT_INIT VOID HalClockStart(VOID)
 {
     HalIrqUnmask(OS_TICK_INT_NUM);
 
+#ifdef LOSCFG_KERNEL_VDSO
+    /* the vdso reads the counter to interpolate between ticks */
+    WRITE_TIMER_REG32(TIMER_REG_CNTKCTL, READ_TIMER_REG32(TIMER_REG_CNTKCTL) | CNTKCTL_PL0PCTEN);
+#endif
+
     /* triggle the first tick */
     TimerCtlWrite(0);
     TimerTvalWrite(OS_CYCLE_PER_TICK);
@@ -496,10 +496,8 @@ STATIC UINT32 OsUnmapSection(LosArchMmu *archMmu, PTE_T *l1Entry, vaddr_t *vaddr
 BOOL OsArchMmuInit(LosArchMmu *archMmu, VADDR_T *virtTtb)
 {
 #ifdef LOSCFG_KERNEL_VM
-    if (OsAllocAsid(&archMmu->asid) != LOS_OK) {
-        VM_ERR("alloc arch mmu asid failed");
-        return FALSE;
-    }
+    /* user spaces get an asid the first time they are switched in */
+    LOS_Atomic64Set(&archMmu->asid, 0);
 #endif
 
 #ifndef LOSCFG_PAGE_TABLE_FINE_LOCK
@@ -847,6 +845,84 @@ status_t LOS_ArchMmuMap(LosArchMmu *archMmu, VADDR_T vaddr, PADDR_T paddr, size_
     return mapped;
 }
 
+STATIC BOOL OsPte2Match(PTE_T pte2, const PADDR_T *oldPaddr)
+{
+    if (oldPaddr == NULL) {
+        return (pte2 == 0);
+    }
+    return (OsIsPte2SmallPage(pte2) || OsIsPte2SmallPageXN(pte2)) &&
+           (MMU_DESCRIPTOR_L2_SMALL_PAGE_ADDR(pte2) == *oldPaddr);
+}
+
+/*
+ * Map one 4K page at vaddr only while the entry still maps oldPaddr, or nothing at all when oldPaddr is NULL.
+ * The check and the store are done under the pte2 lock, so page faults running concurrently on the same page
+ * install it once, and a loser gets LOS_ERRNO_VM_BUSY instead of overwriting the winner's mapping.
+ */
+STATUS_T LOS_ArchMmuMapReplace(LosArchMmu *archMmu, VADDR_T vaddr, const PADDR_T *oldPaddr, PADDR_T paddr,
+                               UINT32 flags)
+{
+    PTE_T *l1Entry = NULL;
+    PTE_T *pte2Ptr = NULL;
+    PTE_T pte1Val;
+    SPIN_LOCK_S *lock = NULL;
+    UINT32 intSave;
+    UINT32 count = 1;
+    INT32 checkRst;
+    MmuMapInfo mmuMapInfo = {
+        .archMmu = archMmu,
+        .vaddr = &vaddr,
+        .paddr = &paddr,
+        .flags = &flags,
+    };
+
+    checkRst = OsMapParamCheck(flags, vaddr, paddr);
+    if (checkRst < 0) {
+        return checkRst;
+    }
+
+    l1Entry = OsGetPte1Ptr(archMmu->virtTtb, vaddr);
+    pte1Val = *l1Entry;
+    if (OsIsPte1Invalid(pte1Val)) {
+        if (oldPaddr != NULL) {
+            return LOS_ERRNO_VM_BUSY;
+        }
+        /* a brand new l2 table has nothing mapped yet */
+        if (OsMapL1PTE(&mmuMapInfo, l1Entry, &count) == 1) {
+            return LOS_OK;
+        }
+        pte1Val = *l1Entry;
+    }
+    if (!OsIsPte1PageTable(pte1Val)) {
+        return LOS_ERRNO_VM_BUSY;
+    }
+
+    lock = OsGetPte2Lock(archMmu, pte1Val, &intSave);
+    if (lock == NULL) {
+        return LOS_ERRNO_VM_NOT_FOUND;
+    }
+    /* the l2 table may have been freed by an unmap between reading the l1 entry and taking its lock */
+    if (*l1Entry != pte1Val) {
+        OsUnlockPte2(lock, intSave);
+        return LOS_ERRNO_VM_BUSY;
+    }
+    pte2Ptr = OsGetPte2BasePtr(pte1Val) + OsGetPte2Index(vaddr);
+    if (!OsPte2Match(*pte2Ptr, oldPaddr)) {
+        OsUnlockPte2(lock, intSave);
+        return LOS_ERRNO_VM_BUSY;
+    }
+
+    OsSavePte2(pte2Ptr, paddr | OsCvtPte2FlagsToAttrs(flags));
+    if (oldPaddr != NULL) {
+        OsArmInvalidateTlbMvaNoBarrier(vaddr);
+    }
+    OsUnlockPte2(lock, intSave);
+    if (oldPaddr != NULL) {
+        OsArmInvalidateTlbBarrier();
+    }
+    return LOS_OK;
+}
+
 STATUS_T LOS_ArchMmuChangeProt(LosArchMmu *archMmu, VADDR_T vaddr, size_t count, UINT32 flags)
 {
     STATUS_T status;
@@ -922,10 +998,176 @@ STATUS_T LOS_ArchMmuMove(LosArchMmu *archMmu, VADDR_T oldVaddr, VADDR_T newVaddr
     return LOS_OK;
 }
 
+STATIC STATUS_T OsCowCloneL1PTE(LosArchMmu *dstMmu, PTE_T srcPte1, VADDR_T vaddr, PTE_T *dstPte1)
+{
+    PADDR_T pte2Base = 0;
+    PADDR_T pte1Paddr;
+    SPIN_LOCK_S *lock = NULL;
+    PTE_T *l1Entry = OsGetPte1Ptr(dstMmu->virtTtb, vaddr);
+    UINT32 intSave;
+
+    pte1Paddr = OsGetPte1Paddr(dstMmu->physTtb, vaddr);
+    lock = OsGetPte1Lock(dstMmu, pte1Paddr, &intSave);
+    if (OsIsPte1Invalid(*l1Entry)) {
+        if (OsGetL2Table(dstMmu, OsGetPte1Index(vaddr), &pte2Base) != LOS_OK) {
+            OsUnlockPte1(lock, intSave);
+            return LOS_ERRNO_VM_NO_MEMORY;
+        }
+
+        *l1Entry = pte2Base | MMU_DESCRIPTOR_L1_TYPE_PAGE_TABLE;
+        *l1Entry |= srcPte1 & MMU_DESCRIPTOR_L1_PAGETABLE_NON_SECURE;
+        *l1Entry &= MMU_DESCRIPTOR_L1_SMALL_DOMAIN_MASK;
+        *l1Entry |= MMU_DESCRIPTOR_L1_SMALL_DOMAIN_CLIENT; // use client AP
+        OsSavePte1(l1Entry, *l1Entry);
+    } else if (!OsIsPte1PageTable(*l1Entry)) {
+        LOS_Panic("%s %d, unimplemented tt_entry %x\n", __FUNCTION__, __LINE__, *l1Entry);
+    }
+    *dstPte1 = *l1Entry;
+    OsUnlockPte1(lock, intSave);
+
+    return LOS_OK;
+}
+
+/*
+ * Copy the small pages of one l2 table from srcMmu to dstMmu, both sides read only.
+ * Return the number of pages scanned, 0 if the l2 table of dstMmu can't be allocated.
+ */
+STATIC UINT32 OsCowCloneL2PTE(LosArchMmu *srcMmu, LosArchMmu *dstMmu, PTE_T *srcPte1, VADDR_T vaddr,
+                              UINT32 count, UINT32 *protectCount)
+{
+    PTE_T dstPte1 = 0;
+    PTE_T *srcPte2BasePtr = NULL;
+    PTE_T *dstPte2BasePtr = NULL;
+    SPIN_LOCK_S *srcLock = NULL;
+    SPIN_LOCK_S *dstLock = NULL;
+    UINT32 srcIntSave, dstIntSave;
+    UINT32 pte2Index = OsGetPte2Index(vaddr);
+    UINT32 cloneCount = MIN2(MMU_DESCRIPTOR_L2_NUMBERS_PER_L1 - pte2Index, count);
+    UINT32 index;
+    PTE_T pte2;
+
+    if (OsCowCloneL1PTE(dstMmu, *srcPte1, vaddr, &dstPte1) != LOS_OK) {
+        return 0;
+    }
+
+    srcLock = OsGetPte2Lock(srcMmu, *srcPte1, &srcIntSave);
+    if (srcLock == NULL) {
+        return cloneCount;
+    }
+    dstLock = OsGetPte2Lock(dstMmu, dstPte1, &dstIntSave);
+    if (dstLock == NULL) {
+        OsUnlockPte2(srcLock, srcIntSave);
+        return 0;
+    }
+
+    srcPte2BasePtr = OsGetPte2BasePtr(*srcPte1);
+    dstPte2BasePtr = OsGetPte2BasePtr(dstPte1);
+    DMB;
+    for (index = pte2Index; index < (pte2Index + cloneCount); index++) {
+        pte2 = srcPte2BasePtr[index];
+        if (!OsIsPte2SmallPage(pte2) && !OsIsPte2SmallPageXN(pte2)) {
+            continue;
+        }
+
+#ifdef LOSCFG_KERNEL_VM
+        LosVmPage *page = LOS_VmPageGet(MMU_DESCRIPTOR_L2_SMALL_PAGE_ADDR(pte2));
+        if (page != NULL) {
+            LOS_AtomicInc(&page->refCounts);
+        }
+#endif
+
+        /* any writable ap without AP2 turns into the matching read only one with AP2 set */
+        if (!(pte2 & MMU_DESCRIPTOR_L2_AP2_1) && (pte2 & MMU_DESCRIPTOR_L2_AP01_3)) {
+            pte2 |= MMU_DESCRIPTOR_L2_AP2_1;
+            srcPte2BasePtr[index] = pte2;
+            (*protectCount)++;
+        }
+        dstPte2BasePtr[index] = pte2;
+    }
+    DSB;
+
+    OsUnlockPte2(dstLock, dstIntSave);
+    OsUnlockPte2(srcLock, srcIntSave);
+    return cloneCount;
+}
+
+/* User sections are only created by OsMapSection for device mmaps, the child shares them as they are */
+STATIC UINT32 OsCowCloneSection(LosArchMmu *dstMmu, PTE_T pte1, VADDR_T vaddr, UINT32 count)
+{
+    UINT32 intSave;
+    SPIN_LOCK_S *lock = NULL;
+    UINT32 cloneCount = MIN2(MMU_DESCRIPTOR_L2_NUMBERS_PER_L1 - OsGetPte2Index(vaddr), count);
+
+    lock = OsGetPte1Lock(dstMmu, OsGetPte1Paddr(dstMmu->physTtb, vaddr), &intSave);
+    if (OsIsPte1Invalid(OsGetPte1(dstMmu->virtTtb, vaddr))) {
+        OsSavePte1(OsGetPte1Ptr(dstMmu->virtTtb, vaddr), pte1);
+    }
+    OsUnlockPte1(lock, intSave);
+
+    return cloneCount;
+}
+
+/*
+ * Share the pages mapped in [vaddr, vaddr + count pages) of srcMmu with dstMmu for copy on write:
+ * both mappings become read only and each page gets one more reference. The page tables are
+ * walked once and the tlb of srcMmu is flushed once at the end, instead of one query, unmap and
+ * map per page.
+ */
+STATUS_T LOS_ArchMmuCowClone(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, size_t count)
+{
+    PTE_T *l1Entry = NULL;
+    UINT32 cloneCount;
+    UINT32 protectCount = 0;
+    UINT32 pageCount = count;
+    STATUS_T ret = LOS_OK;
+
+    if ((srcMmu == NULL) || (dstMmu == NULL) || !MMU_DESCRIPTOR_IS_L2_SIZE_ALIGNED(vaddr)) {
+        return LOS_ERRNO_VM_INVALID_ARGS;
+    }
+
+    while (pageCount > 0) {
+        l1Entry = OsGetPte1Ptr(srcMmu->virtTtb, vaddr);
+        if (OsIsPte1Invalid(*l1Entry)) {
+            (VOID)OsUnmapL1Invalid(&vaddr, &pageCount);
+            continue;
+        } else if (OsIsPte1Section(*l1Entry)) {
+            cloneCount = OsCowCloneSection(dstMmu, *l1Entry, vaddr, pageCount);
+        } else if (OsIsPte1PageTable(*l1Entry)) {
+            cloneCount = OsCowCloneL2PTE(srcMmu, dstMmu, l1Entry, vaddr, pageCount, &protectCount);
+        } else {
+            LOS_Panic("%s %d, unimplemented tt_entry %x\n", __FUNCTION__, __LINE__, *l1Entry);
+            ret = LOS_ERRNO_VM_INVALID_ARGS;
+            break;
+        }
+
+        if (cloneCount == 0) {
+            ret = LOS_ERRNO_VM_NO_MEMORY;
+            break;
+        }
+        vaddr += cloneCount << MMU_DESCRIPTOR_L2_SMALL_SHIFT;
+        pageCount -= cloneCount;
+    }
+
+    if (protectCount != 0) {
+        OsArmInvalidateTlbAsidNoBarrier(OS_ASID_HW(LOS_Atomic64Read(&srcMmu->asid)));
+        OsArmInvalidateTlbBarrier();
+    }
+
+    return ret;
+}
+
 VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu)
 {
     UINT32 ttbr;
     UINT32 ttbcr = OsArmReadTtbcr();
+#ifdef LOSCFG_KERNEL_VM
+    UINT32 asid = MMU_ARM_ASID_KERNEL;
+
+    if ((archMmu != NULL) && (archMmu->virtTtb != OsGFirstTableGet())) {
+        asid = OsAsidCheck(&archMmu->asid);
+    }
+#endif
+
     if (archMmu) {
         ttbr = MMU_TTBRx_FLAGS | (archMmu->physTtb);
         /* enable TTBR0 */
@@ -938,7 +1180,7 @@ VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu)
 
 #ifdef LOSCFG_KERNEL_VM
     /* from armv7a arm B3.10.4, we should do synchronization changes of ASID and TTBR. */
-    OsArmWriteContextidr(LOS_GetKVmSpace()->archMmu.asid);
+    OsArmWriteContextidr(MMU_ARM_ASID_KERNEL);
     ISB;
 #endif
     OsArmWriteTtbr0(ttbr);
@@ -947,7 +1189,7 @@ VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu)
     ISB;
 #ifdef LOSCFG_KERNEL_VM
     if (archMmu) {
-        OsArmWriteContextidr(archMmu->asid);
+        OsArmWriteContextidr(asid);
         ISB;
     }
 #endif
@@ -962,8 +1204,7 @@ STATUS_T LOS_ArchMmuDestroy(LosArchMmu *archMmu)
         LOS_PhysPageFree(page);
     }
 
-    OsArmWriteTlbiasidis(archMmu->asid);
-    OsFreeAsid(archMmu->asid);
+    /* the asid is not reused before every cpu has invalidated its TLB on the next generation rollover */
 #endif
     return LOS_OK;
 }
@@ -37,37 +37,134 @@
 #include "los_asid.h"
 #include "los_bitmap.h"
 #include "los_spinlock.h"
+#include "los_atomic.h"
+#include "los_task.h"
+#include "arm.h"
 #include "los_mmu_descriptor_v6.h"
 
 
 #ifdef LOSCFG_KERNEL_VM
 
+/*
+ * A context id is the asid generation in the upper bits and the hardware asid in the low MMU_ARM_ASID_BITS.
+ * A space keeps its id until the generation rolls over; it is only checked again when the space is switched in.
+ * Rolling over resets the asid pool and makes every cpu invalidate its own TLB once before it runs a new id,
+ * so there is no broadcast invalidation and allocation never fails.
+ */
+#define ASID_NUM                    (1UL << MMU_ARM_ASID_BITS)
+#define ASID_FIRST_GENERATION       ((UINT64)ASID_NUM)
+#define ASID_GENERATION_MATCH(id)   ((((UINT64)(id) ^ (UINT64)LOS_Atomic64Read(&g_asidGeneration)) >> \
+                                     MMU_ARM_ASID_BITS) == 0)
+#define ASID_ALL_CPU_MASK           ((UINT32)((1ULL << LOSCFG_KERNEL_CORE_NUM) - 1))
+
 STATIC SPIN_LOCK_INIT(g_cpuAsidLock);
-STATIC UINTPTR g_asidPool[BITMAP_NUM_WORDS(1UL << MMU_ARM_ASID_BITS)];
+STATIC UINTPTR g_asidPool[BITMAP_NUM_WORDS(ASID_NUM)] = { 1UL << MMU_ARM_ASID_KERNEL };
+STATIC Atomic64 g_asidGeneration = ASID_FIRST_GENERATION;
+STATIC Atomic64 g_activeAsid[LOSCFG_KERNEL_CORE_NUM];    /* id each cpu runs, 0 once a rollover took it over */
+STATIC UINT64 g_reservedAsid[LOSCFG_KERNEL_CORE_NUM];    /* id each cpu was running when the generation rolled */
+STATIC UINT32 g_asidFlushPending;                        /* cpus that have not invalidated since the rollover */
 
-/* allocate and free asid */
-status_t OsAllocAsid(UINT32 *asid)
+STATIC VOID OsAsidRollover(VOID)
 {
-    UINT32 flags;
-    LOS_SpinLockSave(&g_cpuAsidLock, &flags);
-    UINT32 firstZeroBit = LOS_BitmapFfz(g_asidPool, 1UL << MMU_ARM_ASID_BITS);
-    if (firstZeroBit >= 0 && firstZeroBit < (1UL << MMU_ARM_ASID_BITS)) {
-        LOS_BitmapSetNBits(g_asidPool, firstZeroBit, 1);
-        *asid = firstZeroBit;
-        LOS_SpinUnlockRestore(&g_cpuAsidLock, flags);
-        return LOS_OK;
+    UINT64 asid;
+    UINT32 cpu;
+
+    (VOID)memset_s(g_asidPool, sizeof(g_asidPool), 0, sizeof(g_asidPool));
+    LOS_BitmapSetNBits(g_asidPool, MMU_ARM_ASID_KERNEL, 1);
+
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        asid = (UINT64)LOS_AtomicXchg64bits(&g_activeAsid[cpu], 0);
+        /* a cpu that has not switched since the last rollover still runs the id reserved then */
+        if (asid == 0) {
+            asid = g_reservedAsid[cpu];
+        }
+        LOS_BitmapSetNBits(g_asidPool, (UINT32)(asid & MMU_ARM_ASID_MASK), 1);
+        g_reservedAsid[cpu] = asid;
     }
 
-    LOS_SpinUnlockRestore(&g_cpuAsidLock, flags);
-    return firstZeroBit;
+    g_asidFlushPending = ASID_ALL_CPU_MASK;
 }
 
-VOID OsFreeAsid(UINT32 asid)
+STATIC BOOL OsAsidReservedUpdate(UINT64 asid, UINT64 newAsid)
 {
-    UINT32 flags;
-    LOS_SpinLockSave(&g_cpuAsidLock, &flags);
-    LOS_BitmapClrNBits(g_asidPool, asid, 1);
-    LOS_SpinUnlockRestore(&g_cpuAsidLock, flags);
+    BOOL hit = FALSE;
+    UINT32 cpu;
+
+    /* the id may be reserved on several cpus, all of them must follow it into the new generation */
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        if (g_reservedAsid[cpu] == asid) {
+            g_reservedAsid[cpu] = newAsid;
+            hit = TRUE;
+        }
+    }
+
+    return hit;
 }
-#endif
 
+STATIC UINT64 OsAsidNew(UINT64 asid)
+{
+    UINT64 generation = (UINT64)LOS_Atomic64Read(&g_asidGeneration);
+    UINT32 hwAsid = (UINT32)(asid & MMU_ARM_ASID_MASK);
+    INT32 firstZeroBit;
+
+    if (asid != 0) {
+        UINT64 newAsid = generation | hwAsid;
+
+        if (OsAsidReservedUpdate(asid, newAsid)) {
+            return newAsid;
+        }
+
+        /* keep the same hardware asid if nobody took it in this generation */
+        if ((g_asidPool[BITMAP_WORD(hwAsid)] & (1UL << BITMAP_BIT_IN_WORD(hwAsid))) == 0) {
+            LOS_BitmapSetNBits(g_asidPool, hwAsid, 1);
+            return newAsid;
+        }
+    }
+
+    firstZeroBit = LOS_BitmapFfz(g_asidPool, ASID_NUM);
+    if (firstZeroBit < 0) {
+        generation = (UINT64)LOS_Atomic64Add(&g_asidGeneration, (INT64)ASID_FIRST_GENERATION);
+        OsAsidRollover();
+        firstZeroBit = LOS_BitmapFfz(g_asidPool, ASID_NUM);
+    }
+
+    LOS_BitmapSetNBits(g_asidPool, (UINT32)firstZeroBit, 1);
+    return generation | (UINT32)firstZeroBit;
+}
+
+UINT32 OsAsidCheck(Atomic64 *contextId)
+{
+    UINT32 cpuid = ArchCurrCpuid();
+    UINT64 asid = (UINT64)LOS_Atomic64Read(contextId);
+    UINT32 intSave;
+
+    /*
+     * Fast path: the id is current and no rollover has taken this cpu's active id since the generation check.
+     * A rollover racing after the exchange sees the id as active and reserves it.
+     */
+    if (ASID_GENERATION_MATCH(asid) &&
+        (LOS_AtomicXchg64bits(&g_activeAsid[cpuid], (INT64)asid) != 0)) {
+        return (UINT32)(asid & MMU_ARM_ASID_MASK);
+    }
+
+    LOS_SpinLockSave(&g_cpuAsidLock, &intSave);
+    asid = (UINT64)LOS_Atomic64Read(contextId);
+    if (!ASID_GENERATION_MATCH(asid)) {
+        asid = OsAsidNew(asid);
+        LOS_Atomic64Set(contextId, (INT64)asid);
+    }
+
+    if (g_asidFlushPending & CPUID_TO_AFFI_MASK(cpuid)) {
+        g_asidFlushPending &= ~CPUID_TO_AFFI_MASK(cpuid);
+        OsArmWriteTlbiall(0);
+        OsArmWriteBpiall(0);
+        DSB;
+        ISB;
+    }
+
+    LOS_Atomic64Set(&g_activeAsid[cpuid], (INT64)asid);
+    LOS_SpinUnlockRestore(&g_cpuAsidLock, intSave);
+
+    return (UINT32)(asid & MMU_ARM_ASID_MASK);
+}
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "in_cksum.h"
+#include <arm_neon.h>
+#include "los_typedef.h"
+
+#define CSUM_NEON_VECTOR    16
+#define CSUM_NEON_BLOCK     (CSUM_NEON_VECTOR * 4)
+/*
+ * Every vpadal adds at most 2 * 0xFFFF to a 32-bit lane and each block adds twice per
+ * accumulator, so the lanes are widened into the 64-bit sum well before they can wrap.
+ */
+#define CSUM_NEON_WIDEN_BLOCKS  1024
+
+STATIC INLINE UINT32 CsumFold64(UINT64 sum)
+{
+    sum = (sum & 0xFFFFFFFFULL) + (sum >> 32); /* 32: end-around carry */
+    sum = (sum & 0xFFFFFFFFULL) + (sum >> 32); /* 32: end-around carry */
+    return (UINT32)sum;
+}
+
+STATIC INLINE UINT64 CsumTail(const UINT8 *src, UINT8 *dst, INT32 len, UINT64 sum)
+{
+    while (len > 1) {
+        if (dst != NULL) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst += sizeof(UINT16);
+        }
+        sum += (UINT32)src[0] | ((UINT32)src[1] << 8); /* 8: little-endian halfword */
+        src += sizeof(UINT16);
+        len -= sizeof(UINT16);
+    }
+
+    if (len > 0) {
+        if (dst != NULL) {
+            dst[0] = src[0];
+        }
+        sum += src[0];
+    }
+    return sum;
+}
+
+/*
+ * Shared body of both entry points. Unaligned vld1.8/vst1.8 keep the halfword pairing
+ * anchored at src[0] whatever the buffer alignment, which is what the checksum needs.
+ * The copy is folded into the same pass so the data is only pulled through the cache once.
+ */
+STATIC INLINE UINT32 CsumNeon(const UINT8 *src, UINT8 *dst, INT32 len, UINT32 wsum)
+{
+    uint64x2_t acc64 = vdupq_n_u64(0);
+    uint32x4_t acc0;
+    uint32x4_t acc1;
+    uint8x16_t v0, v1, v2, v3;
+    UINT64 sum = wsum;
+    UINT32 blocks;
+
+    while (len >= CSUM_NEON_BLOCK) {
+        acc0 = vdupq_n_u32(0);
+        acc1 = vdupq_n_u32(0);
+        blocks = 0;
+        do {
+            v0 = vld1q_u8(src);
+            v1 = vld1q_u8(src + CSUM_NEON_VECTOR);
+            v2 = vld1q_u8(src + (CSUM_NEON_VECTOR * 2)); /* 2: third vector of the block */
+            v3 = vld1q_u8(src + (CSUM_NEON_VECTOR * 3)); /* 3: fourth vector of the block */
+            if (dst != NULL) {
+                vst1q_u8(dst, v0);
+                vst1q_u8(dst + CSUM_NEON_VECTOR, v1);
+                vst1q_u8(dst + (CSUM_NEON_VECTOR * 2), v2); /* 2: third vector of the block */
+                vst1q_u8(dst + (CSUM_NEON_VECTOR * 3), v3); /* 3: fourth vector of the block */
+                dst += CSUM_NEON_BLOCK;
+            }
+            acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(v0));
+            acc1 = vpadalq_u16(acc1, vreinterpretq_u16_u8(v1));
+            acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(v2));
+            acc1 = vpadalq_u16(acc1, vreinterpretq_u16_u8(v3));
+            src += CSUM_NEON_BLOCK;
+            len -= CSUM_NEON_BLOCK;
+            blocks++;
+        } while ((len >= CSUM_NEON_BLOCK) && (blocks < CSUM_NEON_WIDEN_BLOCKS));
+        acc64 = vpadalq_u32(acc64, acc0);
+        acc64 = vpadalq_u32(acc64, acc1);
+    }
+
+    if (len >= CSUM_NEON_VECTOR) {
+        acc0 = vdupq_n_u32(0);
+        do {
+            v0 = vld1q_u8(src);
+            if (dst != NULL) {
+                vst1q_u8(dst, v0);
+                dst += CSUM_NEON_VECTOR;
+            }
+            acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(v0));
+            src += CSUM_NEON_VECTOR;
+            len -= CSUM_NEON_VECTOR;
+        } while (len >= CSUM_NEON_VECTOR);
+        acc64 = vpadalq_u32(acc64, acc0);
+    }
+
+    sum += vgetq_lane_u64(acc64, 0) + vgetq_lane_u64(acc64, 1);
+    sum = CsumTail(src, dst, len, sum);
+    return CsumFold64(sum);
+}
+
+unsigned int csum_partial_neon(const void *buf, int len, unsigned int wsum)
+{
+    if ((buf == NULL) || (len <= 0)) {
+        return wsum;
+    }
+
+    return CsumNeon((const UINT8 *)buf, NULL, len, wsum);
+}
+
+unsigned int csum_partial_copy_neon(const void *src, void *dst, int len, unsigned int wsum)
+{
+    if ((src == NULL) || (dst == NULL) || (len <= 0)) {
+        return wsum;
+    }
+
+    return CsumNeon((const UINT8 *)src, (UINT8 *)dst, len, wsum);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arm_page_clear.h"
+#include <arm_neon.h>
+
+#define PAGE_CLEAR_NEON_VECTOR  16
+#define PAGE_CLEAR_NEON_BLOCK   (PAGE_CLEAR_NEON_VECTOR * 4)
+
+VOID ArchPageClear(VOID *addr, size_t size)
+{
+    UINT8 *ptr = (UINT8 *)addr;
+    UINT8 *end = ptr + size;
+    uint8x16_t zero = vdupq_n_u8(0);
+
+    while (ptr < end) {
+        vst1q_u8(ptr, zero);
+        vst1q_u8(ptr + PAGE_CLEAR_NEON_VECTOR, zero);
+        vst1q_u8(ptr + (PAGE_CLEAR_NEON_VECTOR * 2), zero); /* 2: third vector of the block */
+        vst1q_u8(ptr + (PAGE_CLEAR_NEON_VECTOR * 3), zero); /* 3: fourth vector of the block */
+        ptr += PAGE_CLEAR_NEON_BLOCK;
+    }
+}
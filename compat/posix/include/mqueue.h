@@ -71,8 +71,8 @@ extern "C" {
 /* CONSTANTS */
 
 #define MQ_USE_MAGIC  0x89abcdef
-/* not support prio */
-#define MQ_PRIO_MAX 1
+/* messages are received in priority order, see LOS_QUEUE_PRIO */
+#define MQ_PRIO_MAX LOS_QUEUE_PRIO_NUM
 
 #ifndef MAX_MQ_FD
 #define MAX_MQ_FD CONFIG_NQUEUE_DESCRIPTORS
@@ -188,7 +188,7 @@ STATIC struct mqpersonal *DoMqueueCreate(const struct mq_attr *attr, const CHAR
         return (struct mqpersonal *)-1;
     }
 #endif
-    UINT32 err = LOS_QueueCreate(NULL, attr->mq_maxmsg, &mqueueID, 0, attr->mq_msgsize);
+    UINT32 err = LOS_QueueCreate(NULL, attr->mq_maxmsg, &mqueueID, LOS_QUEUE_PRIO, attr->mq_msgsize);
     if (map_errno(err) != ENOERR) {
         goto ERROUT;
     }
@@ -816,7 +816,7 @@ int mq_timedsend(mqd_t personal, const char *msg, size_t msgLen, unsigned int ms
         MqSendNotify(mqueueCB);
     }
 
-    err = LOS_QueueWriteCopy(mqueueID, (VOID *)msg, (UINT32)msgLen, (UINT32)absTicks);
+    err = LOS_QueueWriteCopyPrio(mqueueID, (VOID *)msg, (UINT32)msgLen, msgPrio, (UINT32)absTicks);
     if (map_errno(err) != ENOERR) {
         goto ERROUT;
     }
@@ -870,7 +870,7 @@ ssize_t mq_timedreceive(mqd_t personal, char *msg, size_t msgLen, unsigned int *
     mqueueID = mqueueCB->mq_id;
     (VOID)pthread_mutex_unlock(&IPC_QUEUE_MUTEX);
 
-    err = LOS_QueueReadCopy(mqueueID, (VOID *)msg, &receiveLen, (UINT32)absTicks);
+    err = LOS_QueueReadCopyPrio(mqueueID, (VOID *)msg, &receiveLen, msgPrio, (UINT32)absTicks);
     if (map_errno(err) == ENOERR) {
         return (ssize_t)receiveLen;
     } else {
@@ -883,7 +883,6 @@ ERROUT:
     return -1;
 }
 
-/* not support the prio */
 int mq_send(mqd_t personal, const char *msg_ptr, size_t msg_len, unsigned int msg_prio)
 {
     return mq_timedsend(personal, msg_ptr, msg_len, msg_prio, NULL);
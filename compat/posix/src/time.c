@@ -1184,6 +1184,7 @@ int getitimer(int which, struct itimerval *value)
 VOID OsVdsoTimeGet(VdsoDataPage *vdsoDataPage)
 {
     UINT32 intSave;
+    UINT64 cycle;
     struct timespec64 tmp = {0};
     struct timespec64 hwTime = {0};
 
@@ -1191,7 +1192,11 @@ VOID OsVdsoTimeGet(VdsoDataPage *vdsoDataPage)
         return;
     }
 
-    OsGetHwTime(&hwTime);
+    /* same conversion as LOS_CurrNanosec, but keep the cycle value for user space */
+    cycle = HalClockGetCycles();
+    hwTime.tv_sec = cycle / g_sysClock;
+    hwTime.tv_nsec = (cycle % g_sysClock) * OS_SYS_NS_PER_SECOND / g_sysClock;
+    vdsoDataPage->cycleLast = cycle;
 
     LOS_SpinLockSave(&g_timeSpin, &intSave);
     tmp = OsTimeSpecAdd(hwTime, g_accDeltaFromAdj);
@@ -1202,6 +1207,11 @@ VOID OsVdsoTimeGet(VdsoDataPage *vdsoDataPage)
     vdsoDataPage->realTimeSec = tmp.tv_sec;
     vdsoDataPage->realTimeNsec = tmp.tv_nsec;
     LOS_SpinUnlockRestore(&g_timeSpin, intSave);
+
+#ifdef LOSCFG_TIME_CONTAINER
+    /* only the root container exists: every process sees CLOCK_MONOTONIC without offset */
+    vdsoDataPage->monoOffset = (OsGetTimeContainerCount() > 1);
+#endif
 }
 #endif
 
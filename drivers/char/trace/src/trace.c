@@ -61,9 +61,10 @@ static int TraceClose(struct file *filep)
 
 static ssize_t TraceRead(struct file *filep, char *buffer, size_t buflen)
 {
-    /* trace record buffer read */
+    /* trace record buffer read, events of all cpus in timestamp order */
     ssize_t len = buflen;
     OfflineHead *records;
+    char *kbuf = NULL;
     int ret;
     int realLen;
 
@@ -79,7 +80,14 @@ static ssize_t TraceRead(struct file *filep, char *buffer, size_t buflen)
     }
 
     realLen = buflen < records->totalLen ? buflen : records->totalLen;
-    ret = LOS_CopyFromKernel((void *)buffer, buflen, (void *)records, realLen);
+    kbuf = LOS_MemAlloc(m_aucSysMem0, realLen);
+    if (kbuf == NULL) {
+        return -ENOMEM;
+    }
+
+    realLen = LOS_TraceRecordExport(kbuf, realLen);
+    ret = LOS_CopyFromKernel((void *)buffer, buflen, (void *)kbuf, realLen);
+    LOS_MemFree(m_aucSysMem0, kbuf);
     if (ret != 0) {
         return -EINVAL;
     }
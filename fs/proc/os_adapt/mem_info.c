@@ -34,6 +34,7 @@
 #include "los_memory.h"
 #include "los_vm_filemap.h"
 #include "los_memory_pri.h"
+#include "los_vm_phys.h"
 
 static int SysMemInfoFill(struct SeqBuf *seqBuf, void *arg)
 {
@@ -49,6 +50,13 @@ static int SysMemInfoFill(struct SeqBuf *seqBuf, void *arg)
     (void)LosBufPrintf(seqBuf, "FreeNodeNum:     %u\n", mem.freeNodeNum);
 #ifdef LOSCFG_MEM_WATERLINE
     (void)LosBufPrintf(seqBuf, "UsageWaterLine:  %u byte\n", mem.usageWaterLine);
+#endif
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+    UINT32 poolCount, poolHit, poolMiss;
+    OsVmZeroPoolInfoGet(&poolCount, &poolHit, &poolMiss);
+    (void)LosBufPrintf(seqBuf, "ZeroPagePool:    %u page\n", poolCount);
+    (void)LosBufPrintf(seqBuf, "ZeroPageHit:     %u\n", poolHit);
+    (void)LosBufPrintf(seqBuf, "ZeroPageMiss:    %u\n", poolMiss);
 #endif
      return 0;
 }
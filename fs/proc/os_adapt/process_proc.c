@@ -34,6 +34,7 @@
 #include "proc_fs.h"
 #include "internal.h"
 #include "los_process_pri.h"
+#include "los_asid.h"
 #include "user_copy.h"
 #include "los_memory.h"
 
@@ -212,7 +213,7 @@ static int ProcessMemInfoRead(struct SeqBuf *seqBuf, LosProcessCB *pcb)
 
     (void)LosBufPrintf(seqBuf, "\nVMSpaceSize:      %u byte\n", vmSpace->size);
     (void)LosBufPrintf(seqBuf, "VMSpaceMapSize:   %u byte\n", vmSpace->mapSize);
-    (void)LosBufPrintf(seqBuf, "VM TLB Asid:      %u\n", vmSpace->archMmu.asid);
+    (void)LosBufPrintf(seqBuf, "VM TLB Asid:      %u\n", OS_ASID_HW(LOS_Atomic64Read(&vmSpace->archMmu.asid)));
     (void)LosBufPrintf(seqBuf, "VMHeapSize:       %u byte\n", heap->range.size);
     (void)LosBufPrintf(seqBuf, "VMHeapRegionName: %s\n", OsGetRegionNameOrFilePath(heap));
     (void)LosBufPrintf(seqBuf, "VMHeapRegionType: 0x%x\n", heap->regionType);
@@ -43,6 +43,16 @@
 #define BCACHE_STATCK_SIZE 0x3000
 #define ASYNC_EVENT_BIT    0x01
 
+/*
+ * Block I/O states. A block is only read from or written to the device with bcacheMutex dropped,
+ * so other users of the cache keep going meanwhile. A block being read cannot be used by anyone
+ * until the read is done, a block being written back can still be read but not modified, and
+ * neither can be evicted.
+ */
+#define BCACHE_BLOCK_IDLE    0
+#define BCACHE_BLOCK_READING 1
+#define BCACHE_BLOCK_WRITING 2
+
 #ifdef DEBUG
 #define D(args) printf args
 #else
@@ -263,6 +273,19 @@ static INT32 BlockRead(OsBcache *bc, OsBcacheBlock *block, UINT8 *buf)
     return ENOERR;
 }
 
+static inline VOID BlockIoStart(OsBcache *bc, OsBcacheBlock *block, UINT32 ioState)
+{
+    block->ioState = ioState;
+    (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
+}
+
+static inline VOID BlockIoEnd(OsBcache *bc, OsBcacheBlock *block)
+{
+    (VOID)pthread_mutex_lock(&bc->bcacheMutex);
+    block->ioState = BCACHE_BLOCK_IDLE;
+    (VOID)pthread_cond_broadcast(&bc->bcacheCond);
+}
+
 static INT32 BcacheGetFlag(OsBcache *bc, OsBcacheBlock *block)
 {
     UINT32 i, n, f, sectorPos, val, start, pos, currentSize;
@@ -345,7 +368,7 @@ static VOID BcacheSetFlag(const OsBcache *bc, OsBcacheBlock *block, UINT32 pos,
     }
 }
 
-static INT32 BcacheSyncBlock(OsBcache *bc, OsBcacheBlock *block)
+static INT32 BcacheSyncBlock(OsBcache *bc, OsBcacheBlock *block, BOOL dropLock)
 {
     INT32 ret = ENOERR;
     UINT32 len, start, end;
@@ -365,8 +388,14 @@ static INT32 BcacheSyncBlock(OsBcache *bc, OsBcacheBlock *block)
             len = bc->sectorPerBlock;
         }
 
+        if (dropLock) {
+            BlockIoStart(bc, block, BCACHE_BLOCK_WRITING);
+        }
         ret = bc->bwriteFun(bc->priv, (const UINT8 *)(block->data + (start * bc->sectorSize)),
                             len, (block->num * bc->sectorPerBlock) + start);
+        if (dropLock) {
+            BlockIoEnd(bc, block);
+        }
         if (ret == ENOERR) {
             block->modified = FALSE;
             bc->modifiedBlock--;
@@ -411,6 +440,27 @@ static void DelBlock(OsBcache *bc, OsBcacheBlock *block)
     FreeBlock(bc, block);             /* free list add */
 }
 
+/* read the whole block from the device into its data, without holding the bcache mutex */
+static INT32 BlockFill(OsBcache *bc, OsBcacheBlock *block)
+{
+    INT32 ret;
+
+    BlockIoStart(bc, block, BCACHE_BLOCK_READING);
+    ret = bc->breadFun(bc->priv, block->data, bc->sectorPerBlock,
+                       (block->num) << GetValLog2(bc->sectorPerBlock));
+    BlockIoEnd(bc, block);
+    if (ret) {
+        PRINT_ERR("BlockFill, brread_fn error, ret = %d\n", ret);
+        if (block->modified == FALSE) {
+            DelBlock(bc, block);
+        }
+        return ret;
+    }
+
+    block->readFlag = TRUE;
+    return ENOERR;
+}
+
 static BOOL BlockAllDirty(const OsBcache *bc, OsBcacheBlock *block)
 {
     UINT32 start = 0;
@@ -468,9 +518,9 @@ static OsBcacheBlock *GetSlowBlock(OsBcache *bc, BOOL read)
         block = LOS_DL_LIST_ENTRY(node, OsBcacheBlock, listNode);
         node = block->listNode.pstPrev;
 
-        if (block->readBuff == read) {
+        if ((block->readBuff == read) && (block->ioState == BCACHE_BLOCK_IDLE)) {
             if (block->modified == TRUE) {
-                BcacheSyncBlock(bc, block);
+                BcacheSyncBlock(bc, block, FALSE);
             }
 
             DelBlock(bc, block);
@@ -517,7 +567,7 @@ static VOID MergeSyncBlocks(OsBcache *bc, OsBcacheBlock *start)
     OsBcacheBlock *last = NULL;
 
     while (cur <= bc->wEnd) {
-        if (!cur->used || !BlockAllDirty(bc, cur)) {
+        if (!cur->used || (cur->ioState != BCACHE_BLOCK_IDLE) || !BlockAllDirty(bc, cur)) {
             break;
         }
 
@@ -575,6 +625,10 @@ static OsBcacheBlock *AllocNewBlock(OsBcache *bc, BOOL read, UINT64 num)
         prefer = bc->wStart;
     }
 
+    if (prefer->ioState != BCACHE_BLOCK_IDLE) {
+        return NULL;
+    }
+
     /* this is a sync thread synced block! */
     if (prefer->used && !prefer->modified) {
         prefer->used = FALSE;
@@ -586,7 +640,7 @@ static OsBcacheBlock *AllocNewBlock(OsBcache *bc, BOOL read, UINT64 num)
     }
 
     if (prefer->used) {
-        BcacheSyncBlock(bc, prefer);
+        BcacheSyncBlock(bc, prefer, FALSE);
         DelBlock(bc, prefer);
     }
 
@@ -608,12 +662,24 @@ static INT32 BcacheSync(OsBcache *bc)
     node = bc->listHead.pstPrev;
     while (&bc->listHead != node) {
         block = LOS_DL_LIST_ENTRY(node, OsBcacheBlock, listNode);
-        ret = BcacheSyncBlock(bc, block);
+        if (block->ioState == BCACHE_BLOCK_WRITING) {
+            /* someone else is writing it back, the sync is not done until that finishes */
+            (VOID)pthread_cond_wait(&bc->bcacheCond, &bc->bcacheMutex);
+            node = bc->listHead.pstPrev;
+            continue;
+        }
+        if ((block->modified == FALSE) || (block->ioState != BCACHE_BLOCK_IDLE)) {
+            node = node->pstPrev;
+            continue;
+        }
+
+        ret = BcacheSyncBlock(bc, block, TRUE);
         if (ret != ENOERR) {
             PRINT_ERR("BcacheSync error, ret = %d\n", ret);
             break;
         }
-        node = node->pstPrev;
+        /* the list may have changed while the block was written */
+        node = bc->listHead.pstPrev;
     }
     (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
 
@@ -625,6 +691,7 @@ static VOID BlockInit(OsBcache *bc, OsBcacheBlock *block, UINT64 num)
     (VOID)memset_s(block->flag, sizeof(block->flag), 0, sizeof(block->flag));
     block->num = num;
     block->readFlag = FALSE;
+    block->pgHit = 0;
     if (block->modified == TRUE) {
         block->modified = FALSE;
         bc->modifiedBlock--;
@@ -632,12 +699,18 @@ static VOID BlockInit(OsBcache *bc, OsBcacheBlock *block, UINT64 num)
     block->allDirty = FALSE;
 }
 
-static INT32 BcacheGetBlock(OsBcache *bc, UINT64 num, BOOL readData, OsBcacheBlock **dblock)
+/*
+ * Called with bcacheMutex held, which is dropped while a missing block is read from the device
+ * or while every buffer is busy.
+ * A caller that is going to modify the block data waits for any I/O on it to finish.
+ */
+static INT32 BcacheGetBlock(OsBcache *bc, UINT64 num, BOOL readData, BOOL modify, OsBcacheBlock **dblock)
 {
     INT32 ret;
     OsBcacheBlock *block = NULL;
     OsBcacheBlock *first = NULL;
 
+RETRY:
     /*
      * First check if the most recently used block is the requested block,
      * this can improve performance when using byte access functions.
@@ -647,6 +720,15 @@ static INT32 BcacheGetBlock(OsBcache *bc, UINT64 num, BOOL readData, OsBcacheBlo
         block = (first->num == num) ? first : RbFindBlock(bc, num);
     }
 
+    if ((block != NULL) && ((block->ioState == BCACHE_BLOCK_READING) ||
+        (modify && (block->ioState != BCACHE_BLOCK_IDLE)))) {
+        /* the block may be gone once the I/O is done, look it up again */
+        (VOID)pthread_cond_wait(&bc->bcacheCond, &bc->bcacheMutex);
+        block = NULL;
+        first = NULL;
+        goto RETRY;
+    }
+
     if (block != NULL) {
         D(("bcache block = %llu found in cache\n", num));
 #ifdef BCACHE_ANALYSE
@@ -660,9 +742,9 @@ static INT32 BcacheGetBlock(OsBcache *bc, UINT64 num, BOOL readData, OsBcacheBlo
         }
         *dblock = block;
 
-        if ((bc->prereadFun != NULL) && (readData == TRUE) && (block->pgHit == 1)) {
+        if ((bc->prereadFun != NULL) && (readData == TRUE)) {
+            bc->prereadFun(bc, block, TRUE);
             block->pgHit = 0;
-            bc->prereadFun(bc, block);
         }
 
         return ENOERR;
@@ -676,7 +758,10 @@ static INT32 BcacheGetBlock(OsBcache *bc, UINT64 num, BOOL readData, OsBcacheBlo
     }
 
     if (block == NULL) {
-        return -ENOMEM;
+        /* every buffer is under I/O, wait for one to finish; the block may be cached by then */
+        (VOID)pthread_cond_wait(&bc->bcacheCond, &bc->bcacheMutex);
+        first = NULL;
+        goto RETRY;
     }
 #ifdef BCACHE_ANALYSE
     UINT32 index = ((UINT32)(block->data - g_memStart)) / g_dataSize;
@@ -684,32 +769,43 @@ static INT32 BcacheGetBlock(OsBcache *bc, UINT64 num, BOOL readData, OsBcacheBlo
     g_switchTimes[index]++;
 #endif
     BlockInit(bc, block, num);
+    /* make the block visible first, so that others wait for it instead of reading it again */
+    AddBlock(bc, block);
 
     if (readData == TRUE) {
         D(("bcache reading block = %llu\n", block->num));
 
-        ret = BlockRead(bc, block, block->data);
+        ret = BlockFill(bc, block);
         if (ret != ENOERR) {
             return ret;
         }
         if (bc->prereadFun != NULL) {
-            bc->prereadFun(bc, block);
+            bc->prereadFun(bc, block, FALSE);
         }
     }
 
-    AddBlock(bc, block);
-
     *dblock = block;
     return ENOERR;
 }
 
 INT32 BcacheClearCache(OsBcache *bc)
 {
+    LOS_DL_LIST *node = NULL;
     OsBcacheBlock *block = NULL;
-    OsBcacheBlock *next = NULL;
-    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(block, next, &bc->listHead, OsBcacheBlock, listNode) {
+
+    (VOID)pthread_mutex_lock(&bc->bcacheMutex);
+    node = bc->listHead.pstNext;
+    while (node != &bc->listHead) {
+        block = LOS_DL_LIST_ENTRY(node, OsBcacheBlock, listNode);
+        node = node->pstNext;
+        if (block->ioState != BCACHE_BLOCK_IDLE) {
+            (VOID)pthread_cond_wait(&bc->bcacheCond, &bc->bcacheMutex);
+            node = bc->listHead.pstNext;
+            continue;
+        }
         DelBlock(bc, block);
     }
+    (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
     return 0;
 }
 
@@ -818,6 +914,11 @@ INT32 BlockCacheDrvCreate(VOID *handle,
     }
     bc->bcacheMutex.attr.type = PTHREAD_MUTEX_RECURSIVE;
 
+    if (pthread_cond_init(&bc->bcacheCond, NULL) != ENOERR) {
+        (VOID)pthread_mutex_destroy(&bc->bcacheMutex);
+        return VFS_ERROR;
+    }
+
     return ENOERR;
 }
 
@@ -853,7 +954,7 @@ INT32 BlockCacheRead(OsBcache *bc, UINT8 *buf, UINT32 *len, UINT64 sector, BOOL
         (VOID)pthread_mutex_lock(&bc->bcacheMutex);
 
         /* useRead should be FALSE when reading large contiguous data */
-        ret = BcacheGetBlock(bc, num, useRead, &block);
+        ret = BcacheGetBlock(bc, num, useRead, FALSE, &block);
         if (ret != ENOERR) {
             (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
             break;
@@ -866,7 +967,7 @@ INT32 BlockCacheRead(OsBcache *bc, UINT8 *buf, UINT32 *len, UINT64 sector, BOOL
                 return ret;
             }
         } else if ((block->readFlag == FALSE) && (block->modified == FALSE)) {
-            ret = BlockRead(bc, block, block->data);
+            ret = BlockFill(bc, block);
             if (ret != ENOERR) {
                 (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
                 return ret;
@@ -916,7 +1017,7 @@ INT32 BlockCacheWrite(OsBcache *bc, const UINT8 *buf, UINT32 *len, UINT64 sector
         }
 
         (VOID)pthread_mutex_lock(&bc->bcacheMutex);
-        ret = BcacheGetBlock(bc, num, FALSE, &block);
+        ret = BcacheGetBlock(bc, num, FALSE, TRUE, &block);
         if (ret != ENOERR) {
             (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
             break;
@@ -1122,6 +1223,7 @@ ERROR_OUT_WITH_BCACHE:
 VOID BlockCacheDeinit(OsBcache *bcache)
 {
     if (bcache != NULL) {
+        (VOID)pthread_cond_destroy(&bcache->bcacheCond);
         (VOID)pthread_mutex_destroy(&bcache->bcacheMutex);
         free(bcache->memStart);
         bcache->memStart = NULL;
@@ -1131,12 +1233,76 @@ VOID BlockCacheDeinit(OsBcache *bcache)
     }
 }
 
+/* take read buffers for the blocks to read ahead, up to the first one already cached */
+static UINT32 BcachePrereadPrepare(OsBcache *bc, UINT64 start, UINT32 count, OsBcacheBlock **blocks)
+{
+    OsBcacheBlock *block = NULL;
+    UINT32 n;
+
+    for (n = 0; (n < count) && ((start + n) < bc->blockCount); n++) {
+        if (RbFindBlock(bc, start + n) != NULL) {
+            break;
+        }
+        block = GetSlowBlock(bc, TRUE);
+        if (block == NULL) {
+            break;
+        }
+        BlockInit(bc, block, start + n);
+        AddBlock(bc, block);
+        block->ioState = BCACHE_BLOCK_READING;
+        blocks[n] = block;
+    }
+    return n;
+}
+
+static VOID BcachePrereadFinish(OsBcache *bc, OsBcacheBlock **blocks, UINT32 count, INT32 result)
+{
+    UINT32 i;
+
+    for (i = 0; i < count; i++) {
+        blocks[i]->ioState = BCACHE_BLOCK_IDLE;
+        if ((result != ENOERR) || (memcpy_s(blocks[i]->data, bc->blockSize,
+            bc->prereadBuffer + ((size_t)i << bc->blockSizeLog2), bc->blockSize) != EOK)) {
+            DelBlock(bc, blocks[i]);
+            continue;
+        }
+        blocks[i]->readFlag = TRUE;
+    }
+
+    /* a reader getting to this batch asks for the next one */
+    if ((result == ENOERR) && (count > 0)) {
+        blocks[0]->pgHit = 1;
+    }
+    (VOID)pthread_cond_broadcast(&bc->bcacheCond);
+}
+
+/* take the pending preread of the next stream after *index that has one, with bcacheMutex held */
+static BOOL BcachePrereadTake(OsBcache *bc, UINT32 *index, UINT64 *start, UINT32 *count)
+{
+    OsBcacheStream *stream = NULL;
+    UINT32 i;
+
+    for (i = 0; i < PREREAD_STREAM_NUM; i++) {
+        stream = &bc->stream[(*index + i) % PREREAD_STREAM_NUM];
+        if (stream->prereadCount != 0) {
+            *start = stream->prereadStart;
+            *count = stream->prereadCount;
+            stream->prereadCount = 0;
+            *index = (*index + i + 1) % PREREAD_STREAM_NUM;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
 static VOID BcacheAsyncPrereadThread(VOID *arg)
 {
     OsBcache *bc = (OsBcache *)arg;
-    OsBcacheBlock *block = NULL;
+    OsBcacheBlock *blocks[PREREAD_BLOCK_MAX];
+    UINT32 index = 0;
+    UINT64 start;
+    UINT32 count;
     INT32 ret;
-    UINT32 i;
 
     for (;;) {
         ret = (INT32)LOS_EventRead(&bc->bcacheEvent, PREREAD_EVENT_MASK,
@@ -1146,38 +1312,100 @@ static VOID BcacheAsyncPrereadThread(VOID *arg)
             continue;
         }
 
-        for (i = 1; i <= PREREAD_BLOCK_NUM; i++) {
-            if ((bc->curBlockNum + i) >= bc->blockCount) {
-                break;
+        /* one event may stand for the requests of several streams, serve them all in turn */
+        (VOID)pthread_mutex_lock(&bc->bcacheMutex);
+        while (BcachePrereadTake(bc, &index, &start, &count)) {
+            count = BcachePrereadPrepare(bc, start, count, blocks);
+            if (count == 0) {
+                continue;
             }
+            (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
 
-            (VOID)pthread_mutex_lock(&bc->bcacheMutex);
-            ret = BcacheGetBlock(bc, bc->curBlockNum + i, TRUE, &block);
+            /* the blocks are contiguous on the disk, read them in one request */
+            ret = bc->breadFun(bc->priv, bc->prereadBuffer, count * bc->sectorPerBlock,
+                               start << GetValLog2(bc->sectorPerBlock));
             if (ret != ENOERR) {
-                PRINT_ERR("read block %llu error : %d!\n", bc->curBlockNum, ret);
+                PRINT_ERR("read block %llu error : %d!\n", start, ret);
             }
 
-            (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
+            (VOID)pthread_mutex_lock(&bc->bcacheMutex);
+            BcachePrereadFinish(bc, blocks, count, ret);
         }
+        (VOID)pthread_mutex_unlock(&bc->bcacheMutex);
+    }
+}
+
+static OsBcacheStream *BcacheStreamGet(OsBcache *bc, UINT64 num)
+{
+    OsBcacheStream *stream = &bc->stream[0];
+    UINT32 i;
 
-        if (block != NULL) {
-            block->pgHit = 1; /* preread complete */
+    for (i = 0; i < PREREAD_STREAM_NUM; i++) {
+        if (bc->stream[i].next == num) {
+            return &bc->stream[i];
+        }
+        if ((INT32)(bc->stream[i].stamp - stream->stamp) < 0) {
+            stream = &bc->stream[i];
         }
     }
+
+    /* not the continuation of any stream, start a new one in place of the oldest */
+    stream->window = 0;
+    stream->prereadEnd = num + 1;
+    stream->prereadCount = 0;
+    return stream;
 }
 
-VOID ResumeAsyncPreread(OsBcache *arg1, const OsBcacheBlock *arg2)
+/*
+ * Called with bcacheMutex held on every block a reader gets from the cache. Readers going through
+ * the disk block by block are tracked as streams, and each stream is read ahead by a window that
+ * doubles while the reader keeps catching up with it and halves when blocks read ahead were
+ * evicted before they were used.
+ */
+VOID ResumeAsyncPreread(OsBcache *arg1, const OsBcacheBlock *arg2, BOOL hit)
 {
     UINT32 ret;
     OsBcache *bc = arg1;
     const OsBcacheBlock *block = arg2;
+    OsBcacheStream *stream = NULL;
+    BOOL sequential;
+    UINT64 start;
 
-    if (OsCurrTaskGet()->taskID != bc->prereadTaskId) {
-        bc->curBlockNum = block->num;
-        ret = LOS_EventWrite(&bc->bcacheEvent, ASYNC_EVENT_BIT);
-        if (ret != ENOERR) {
-            PRINT_ERR("Write event failed in %s, %d\n", __FUNCTION__, __LINE__);
-        }
+    if (OsCurrTaskGet()->taskID == bc->prereadTaskId) {
+        return;
+    }
+
+    stream = BcacheStreamGet(bc, block->num);
+    sequential = (stream->next == block->num);
+    stream->next = block->num + 1;
+    stream->stamp = ++bc->streamStamp;
+    if (!sequential) {
+        return;
+    }
+
+    if (!hit && (block->num < stream->prereadEnd)) {
+        stream->window = (stream->window > 1) ? (stream->window >> 1) : 1;
+    } else if (!hit || (block->pgHit == 1)) {
+        stream->window = (stream->window == 0) ? PREREAD_BLOCK_NUM : (stream->window << 1);
+        stream->window = (stream->window > bc->prereadMax) ? bc->prereadMax : stream->window;
+    } else {
+        return;
+    }
+
+    start = (stream->prereadEnd > stream->next) ? stream->prereadEnd : stream->next;
+    stream->prereadEnd = start + stream->window;
+    bc->curBlockNum = start;
+    /* a request of this stream not served yet is extended when the new one follows it, else replaced */
+    if ((stream->prereadCount == 0) || (start != (stream->prereadStart + stream->prereadCount))) {
+        stream->prereadStart = start;
+    }
+    if ((stream->prereadEnd - stream->prereadStart) > bc->prereadMax) {
+        stream->prereadEnd = stream->prereadStart + bc->prereadMax;
+    }
+    stream->prereadCount = (UINT32)(stream->prereadEnd - stream->prereadStart);
+    ret = LOS_EventWrite(&bc->bcacheEvent, ASYNC_EVENT_BIT);
+    if (ret != ENOERR) {
+        PRINT_ERR("Write event failed in %s, %d\n", __FUNCTION__, __LINE__);
     }
 }
 
@@ -1186,9 +1414,21 @@ UINT32 BcacheAsyncPrereadInit(OsBcache *bc)
     UINT32 ret;
     TSK_INIT_PARAM_S appTask;
 
+    /* keep half of the read buffers for the blocks being used */
+    bc->prereadMax = (CONFIG_FS_FAT_READ_NUMS / 2 < PREREAD_BLOCK_MAX) ? (CONFIG_FS_FAT_READ_NUMS / 2) :
+                     PREREAD_BLOCK_MAX;
+    bc->prereadMax = (bc->prereadMax < PREREAD_BLOCK_NUM) ? PREREAD_BLOCK_NUM : bc->prereadMax;
+    bc->prereadBuffer = (UINT8 *)memalign(DMA_ALLGN, bc->prereadMax * bc->blockSize);
+    if (bc->prereadBuffer == NULL) {
+        PRINT_ERR("Preread buffer alloc failed in %s, %d\n", __FUNCTION__, __LINE__);
+        return LOS_NOK;
+    }
+
     ret = LOS_EventInit(&bc->bcacheEvent);
     if (ret != ENOERR) {
         PRINT_ERR("Async event init failed in %s, %d\n", __FUNCTION__, __LINE__);
+        free(bc->prereadBuffer);
+        bc->prereadBuffer = NULL;
         return ret;
     }
 
@@ -1202,6 +1442,9 @@ UINT32 BcacheAsyncPrereadInit(OsBcache *bc)
     ret = LOS_TaskCreate(&bc->prereadTaskId, &appTask);
     if (ret != ENOERR) {
         PRINT_ERR("Bcache async task create failed in %s, %d\n", __FUNCTION__, __LINE__);
+        (VOID)LOS_EventDestroy(&bc->bcacheEvent);
+        free(bc->prereadBuffer);
+        bc->prereadBuffer = NULL;
     }
 
     return ret;
@@ -1222,6 +1465,9 @@ UINT32 BcacheAsyncPrereadDeinit(OsBcache *bc)
             PRINT_ERR("Async event destroy failed in %s, %d\n", __FUNCTION__, __LINE__);
             return ret;
         }
+
+        free(bc->prereadBuffer);
+        bc->prereadBuffer = NULL;
     }
 
     return ret;
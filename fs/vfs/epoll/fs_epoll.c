@@ -34,17 +34,36 @@
 #include <errno.h>
 #include <string.h>
 #include "pthread.h"
-
-/* 100, the number of fd one epollfd can control */
-#define EPOLL_DEFAULT_SIZE 100
+#include "los_list.h"
+
+/* 64, the number of hash buckets used to find the registered fd of one epollfd */
+#define EPOLL_HASH_SIZE 64
+
+/* the events that are not passed to poll */
+#define EPOLL_PRIVATE_BITS (EPOLLET | EPOLLONESHOT)
+
+/* One fd registered to an epoll fd */
+struct epoll_item {
+    LOS_DL_LIST hashNode;       /* node in the hash bucket of the fd */
+    LOS_DL_LIST readyNode;      /* node in the ready list, self linked if not ready */
+    int fd;
+    UINT32 events;              /* events of interest, EPOLLERR and EPOLLHUP always included */
+    UINT32 revents;             /* events pending report */
+    UINT32 seen;                /* events found by the last poll, an EPOLLET item only reports the others */
+};
 
 /* Internal data, used to manage each epoll fd */
 struct epoll_head {
-    int size;
     int nodeCount;
-    struct epoll_event *evs;
+    int readyCount;
+    int readyPasses;            /* waits that checked the ready list only since the last full scan */
+    int refCount;               /* protected by g_epollMutex */
+    pthread_mutex_t lock;       /* protects all the items of the epoll fd */
+    LOS_DL_LIST readyList;      /* items that were ready at the last poll, or are still for EPOLLET */
+    LOS_DL_LIST hashList[EPOLL_HASH_SIZE];
 };
 
+/* g_epollMutex only protects the epoll fd table, it is never held during the wait */
 STATIC pthread_mutex_t g_epollMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
 #ifndef MAX_EPOLL_FD
@@ -126,41 +145,95 @@ static struct epoll_head *EpollGetDataBuff(int fd)
 }
 
 /**
- * when do EPOLL_CTL_ADD, need check if fd exist
+ * close epoll
  *
- * @param epHead: epoll control head, find by epoll id .
- * @param fd: ctl add fd.
- * @return 0 or -1
+ * @param epHead: epoll control head.
+ * @return void
  */
-static int CheckFdExist(struct epoll_head *epHead, int fd)
+static VOID DoEpollClose(struct epoll_head *epHead)
 {
+    struct epoll_item *item = NULL;
+    struct epoll_item *next = NULL;
     int i;
-    for (i = 0; i < epHead->nodeCount; i++) {
-        if (epHead->evs[i].data.fd == fd) {
-            return -1;
+
+    if (epHead == NULL) {
+        return;
+    }
+
+    for (i = 0; i < EPOLL_HASH_SIZE; i++) {
+        LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(item, next, &epHead->hashList[i], struct epoll_item, hashNode) {
+            free(item);
         }
     }
 
-    return 0;
+    (VOID)pthread_mutex_destroy(&epHead->lock);
+    free(epHead);
 }
 
 /**
- * close epoll
+ * get private data by epoll fd and take a reference on it,
+ * so that a concurrent close does not free it under the caller.
  *
- * @param epHead: epoll control head.
- * @return void
+ * @param fd: epoll fd.
+ * @return point to epoll_head
  */
-static VOID DoEpollClose(struct epoll_head *epHead)
+static struct epoll_head *EpollHeadGet(int fd)
 {
+    struct epoll_head *epHead = NULL;
+
+    (VOID)pthread_mutex_lock(&g_epollMutex);
+    epHead = EpollGetDataBuff(fd);
     if (epHead != NULL) {
-        if (epHead->evs != NULL) {
-            free(epHead->evs);
+        epHead->refCount++;
+    }
+    (VOID)pthread_mutex_unlock(&g_epollMutex);
+
+    return epHead;
+}
+
+static VOID EpollHeadPut(struct epoll_head *epHead)
+{
+    int refCount;
+
+    (VOID)pthread_mutex_lock(&g_epollMutex);
+    refCount = --epHead->refCount;
+    (VOID)pthread_mutex_unlock(&g_epollMutex);
+
+    if (refCount == 0) {
+        DoEpollClose(epHead);
+    }
+}
+
+static struct epoll_item *EpollItemFind(struct epoll_head *epHead, int fd)
+{
+    struct epoll_item *item = NULL;
+    LOS_DL_LIST *bucket = &epHead->hashList[(UINT32)fd % EPOLL_HASH_SIZE];
+
+    LOS_DL_LIST_FOR_EACH_ENTRY(item, bucket, struct epoll_item, hashNode) {
+        if (item->fd == fd) {
+            return item;
         }
+    }
 
-        free(epHead);
+    return NULL;
+}
+
+static VOID EpollItemReady(struct epoll_head *epHead, struct epoll_item *item)
+{
+    if (LOS_ListEmpty(&item->readyNode)) {
+        LOS_ListTailInsert(&epHead->readyList, &item->readyNode);
+        epHead->readyCount++;
     }
+}
 
-    return;
+static VOID EpollItemUnready(struct epoll_head *epHead, struct epoll_item *item)
+{
+    item->revents = 0;
+    item->seen = 0;
+    if (!LOS_ListEmpty(&item->readyNode)) {
+        LOS_ListDelInit(&item->readyNode);
+        epHead->readyCount--;
+    }
 }
 
 /**
@@ -169,9 +242,8 @@ static VOID DoEpollClose(struct epoll_head *epHead)
  * epoll_create is implemented by calling epoll_create1, it's parameter 'size' is useless.
  *
  * epoll_create1,
- * The simple version of epoll does not use red-black trees,
- * so when fd is normal value (greater than 0),
- * actually allocated epoll can manage num of EPOLL_DEFAULT_SIZE
+ * The registered fds are kept in a hash table, and the fds found ready are
+ * kept in a ready list, which is checked first by the next epoll_wait.
  *
  * @param flags: not actually used
  * @return epoll fd
@@ -180,6 +252,7 @@ int epoll_create1(int flags)
 {
     (void)flags;
     int fd = -1;
+    int i;
 
     struct epoll_head *epHead = (struct epoll_head *)malloc(sizeof(struct epoll_head));
     if (epHead == NULL) {
@@ -187,14 +260,14 @@ int epoll_create1(int flags)
         return fd;
     }
 
-    /* actually allocated epoll can manage num is EPOLL_DEFAULT_SIZE */
-    epHead->size = EPOLL_DEFAULT_SIZE;
     epHead->nodeCount = 0;
-    epHead->evs = malloc(sizeof(struct epoll_event) * EPOLL_DEFAULT_SIZE);
-    if (epHead->evs == NULL) {
-        free(epHead);
-        set_errno(ENOMEM);
-        return fd;
+    epHead->readyCount = 0;
+    epHead->readyPasses = 0;
+    epHead->refCount = 1;
+    (VOID)pthread_mutex_init(&epHead->lock, NULL);
+    LOS_ListInit(&epHead->readyList);
+    for (i = 0; i < EPOLL_HASH_SIZE; i++) {
+        LOS_ListInit(&epHead->hashList[i]);
     }
 
     /* fd set, get sysfd, for close */
@@ -228,23 +301,76 @@ int epoll_close(int epfd)
         return -1;
     }
 
-    DoEpollClose(epHead);
     int ret = EpollFreeSysFd(epfd);
     (VOID)pthread_mutex_unlock(&g_epollMutex);
+
+    /* the waiters still holding it release it when they return */
+    EpollHeadPut(epHead);
     return ret;
 }
 
+static int EpollCtlAdd(struct epoll_head *epHead, int fd, const struct epoll_event *ev)
+{
+    struct epoll_item *item = EpollItemFind(epHead, fd);
+    if (item != NULL) {
+        set_errno(EEXIST);
+        return -1;
+    }
+
+    item = (struct epoll_item *)malloc(sizeof(struct epoll_item));
+    if (item == NULL) {
+        set_errno(ENOMEM);
+        return -1;
+    }
+
+    item->fd = fd;
+    item->events = ev->events | EPOLLERR | EPOLLHUP;
+    item->revents = 0;
+    item->seen = 0;
+    LOS_ListInit(&item->readyNode);
+    LOS_ListAdd(&epHead->hashList[(UINT32)fd % EPOLL_HASH_SIZE], &item->hashNode);
+    epHead->nodeCount++;
+    return 0;
+}
+
+static int EpollCtlDel(struct epoll_head *epHead, int fd)
+{
+    struct epoll_item *item = EpollItemFind(epHead, fd);
+    if (item == NULL) {
+        set_errno(ENOENT);
+        return -1;
+    }
+
+    EpollItemUnready(epHead, item);
+    LOS_ListDelete(&item->hashNode);
+    epHead->nodeCount--;
+    free(item);
+    return 0;
+}
+
+static int EpollCtlMod(struct epoll_head *epHead, int fd, const struct epoll_event *ev)
+{
+    struct epoll_item *item = EpollItemFind(epHead, fd);
+    if (item == NULL) {
+        set_errno(ENOENT);
+        return -1;
+    }
+
+    /* this also rearms an EPOLLONESHOT item, and lets an EPOLLET item that is still ready be reported again */
+    item->events = ev->events | EPOLLERR | EPOLLHUP;
+    EpollItemUnready(epHead, item);
+    return 0;
+}
+
 int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
 {
     struct epoll_head *epHead = NULL;
-    int i;
     int ret = -1;
 
-    (VOID)pthread_mutex_lock(&g_epollMutex);
-    epHead = EpollGetDataBuff(epfd);
+    epHead = EpollHeadGet(epfd);
     if (epHead == NULL) {
         set_errno(EBADF);
-        goto OUT_RELEASE;
+        return ret;
     }
 
     if (ev == NULL) {
@@ -252,119 +378,242 @@ int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
         goto OUT_RELEASE;
     }
 
+    (VOID)pthread_mutex_lock(&epHead->lock);
     switch (op) {
         case EPOLL_CTL_ADD:
-            ret = CheckFdExist(epHead, fd);
-            if (ret == -1) {
-                set_errno(EEXIST);
-                goto OUT_RELEASE;
-            }
-
-            if (epHead->nodeCount == EPOLL_DEFAULT_SIZE) {
-                set_errno(ENOMEM);
-                goto OUT_RELEASE;
-            }
-
-            epHead->evs[epHead->nodeCount].events = ev->events | POLLERR | POLLHUP;
-            epHead->evs[epHead->nodeCount].data.fd = fd;
-            epHead->nodeCount++;
-            ret = 0;
+            ret = EpollCtlAdd(epHead, fd, ev);
             break;
         case EPOLL_CTL_DEL:
-            for (i = 0; i < epHead->nodeCount; i++) {
-                if (epHead->evs[i].data.fd != fd) {
-                    continue;
-                }
-
-                if (i != epHead->nodeCount - 1) {
-                    memmove_s(&epHead->evs[i], epHead->nodeCount - i, &epHead->evs[i + 1],
-                              epHead->nodeCount - i);
-                }
-                epHead->nodeCount--;
-                ret = 0;
-                goto OUT_RELEASE;
-            }
-            set_errno(ENOENT);
+            ret = EpollCtlDel(epHead, fd);
             break;
         case EPOLL_CTL_MOD:
-            for (i = 0; i < epHead->nodeCount; i++) {
-                if (epHead->evs[i].data.fd == fd) {
-                    epHead->evs[i].events = ev->events | POLLERR | POLLHUP;
-                    ret = 0;
-                    goto OUT_RELEASE;
-                }
-            }
-            set_errno(ENOENT);
+            ret = EpollCtlMod(epHead, fd, ev);
             break;
         default:
             set_errno(EINVAL);
             break;
     }
+    (VOID)pthread_mutex_unlock(&epHead->lock);
 
 OUT_RELEASE:
-    (VOID)pthread_mutex_unlock(&g_epollMutex);
+    EpollHeadPut(epHead);
     return ret;
 }
 
-int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents, int timeout)
+/**
+ * Fill the pollfd array with the items to check, with epHead->lock held.
+ * Only the ready list is used if checkReady is TRUE, else all the items that
+ * are not disabled by EPOLLONESHOT. A blocking poll does not ask an EPOLLET
+ * item for the events it already has, they would end the wait at once
+ * without anything new to report.
+ *
+ * @return the number of pollfd filled
+ */
+static int EpollPollFdSet(struct epoll_head *epHead, struct pollfd *pFd, int pollSize, BOOL checkReady,
+                          BOOL blocking)
 {
-    struct epoll_head *epHead = NULL;
-    int ret = -1;
-    int counter;
+    struct epoll_item *item = NULL;
+    UINT32 events;
+    int count = 0;
     int i;
-    struct pollfd *pFd = NULL;
-    int pollSize;
 
-    (VOID)pthread_mutex_lock(&g_epollMutex);
-    epHead = EpollGetDataBuff(epfd);
-    if (epHead == NULL) {
-        set_errno(EBADF);
-        goto OUT_RELEASE;
+    if (checkReady) {
+        LOS_DL_LIST_FOR_EACH_ENTRY(item, &epHead->readyList, struct epoll_item, readyNode) {
+            if (count == pollSize) {
+                break;
+            }
+            pFd[count].fd = item->fd;
+            pFd[count].events = (short)(item->events & ~EPOLL_PRIVATE_BITS);
+            pFd[count].revents = 0;
+            count++;
+        }
+        return count;
     }
 
-    if ((maxevents <= 0) || (evs == NULL)) {
-        set_errno(EINVAL);
-        goto OUT_RELEASE;
+    for (i = 0; i < EPOLL_HASH_SIZE; i++) {
+        LOS_DL_LIST_FOR_EACH_ENTRY(item, &epHead->hashList[i], struct epoll_item, hashNode) {
+            events = item->events & ~EPOLL_PRIVATE_BITS;
+            if (blocking && (item->events & EPOLLET)) {
+                events &= ~item->seen;
+            }
+            if ((count == pollSize) || (events == 0)) {
+                continue;
+            }
+            pFd[count].fd = item->fd;
+            pFd[count].events = (short)events;
+            pFd[count].revents = 0;
+            count++;
+        }
     }
+    return count;
+}
 
-    if (maxevents > epHead->nodeCount) {
-        pollSize = epHead->nodeCount;
-    } else {
-        pollSize = maxevents;
+/**
+ * Merge the poll result into the ready list, with epHead->lock held.
+ * The items may have been deleted or modified while polling without the lock,
+ * so they are found again by fd.
+ * A level triggered item is pending while its events are there. An EPOLLET
+ * item is pending for the events that were not there at its previous poll,
+ * until they are reported, and stays in the ready list while they are there
+ * so that the ready list check notices when they go.
+ */
+static VOID EpollPollResultSet(struct epoll_head *epHead, const struct pollfd *pFd, int count)
+{
+    struct epoll_item *item = NULL;
+    UINT32 revents;
+    UINT32 polled;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        item = EpollItemFind(epHead, pFd[i].fd);
+        if (item == NULL) {
+            continue;
+        }
+
+        /* POLLNVAL is always reported, as poll does */
+        revents = (UINT32)(UINT16)pFd[i].revents & (item->events | EPOLLNVAL);
+        if (item->events & EPOLLET) {
+            polled = (UINT32)(UINT16)pFd[i].events | EPOLLERR | EPOLLHUP | EPOLLNVAL;
+            item->revents |= revents & ~item->seen;
+            item->seen = (item->seen & ~polled) | revents;
+        } else {
+            item->revents = revents;
+            item->seen = revents;
+        }
+
+        if ((item->revents | item->seen) != 0) {
+            EpollItemReady(epHead, item);
+        } else {
+            EpollItemUnready(epHead, item);
+        }
+    }
+}
+
+/**
+ * Report the pending items of the ready list, from its head, with epHead->lock held.
+ * The reported items go to the tail of the ready list, so that the others are
+ * reported first next time, except the oneshot items, which leave it. The
+ * pending events of an EPOLLET item are cleared once reported.
+ *
+ * @return the number of events reported
+ */
+static int EpollReadyReport(struct epoll_head *epHead, struct epoll_event *evs, int maxevents)
+{
+    struct epoll_item *item = NULL;
+    struct epoll_item *next = NULL;
+    LOS_DL_LIST reported;
+    int count = 0;
+
+    LOS_ListInit(&reported);
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(item, next, &epHead->readyList, struct epoll_item, readyNode) {
+        if (count == maxevents) {
+            break;
+        }
+        if (item->revents == 0) {
+            continue;
+        }
+        evs[count].data.fd = item->fd;
+        evs[count].events = item->revents;
+        count++;
+
+        if (item->events & EPOLLONESHOT) {
+            item->events &= EPOLL_PRIVATE_BITS;
+            EpollItemUnready(epHead, item);
+            continue;
+        }
+
+        if (item->events & EPOLLET) {
+            item->revents = 0;
+        }
+        LOS_ListDelete(&item->readyNode);
+        LOS_ListTailInsert(&reported, &item->readyNode);
+    }
+
+    if (!LOS_ListEmpty(&reported)) {
+        LOS_ListTailInsertList(&epHead->readyList, &reported);
+    }
+
+    return count;
+}
+
+/**
+ * Poll the items of the epoll fd, the ready list only or all of them.
+ * The ready list is not trusted for more than one lap: level triggered items
+ * that stay ready would otherwise hide the items that became ready since the
+ * last full scan, so all the items are scanned again once every item of the
+ * ready list had its turn.
+ *
+ * @return the number of events reported, or -1 with errno set
+ */
+static int EpollPoll(struct epoll_head *epHead, struct epoll_event *evs, int maxevents, int timeout, BOOL checkReady)
+{
+    struct pollfd *pFd = NULL;
+    int pollSize;
+    int count;
+    int ret;
+
+    (VOID)pthread_mutex_lock(&epHead->lock);
+    if (checkReady && (epHead->readyCount != 0) && (epHead->readyPasses >= epHead->readyCount)) {
+        checkReady = FALSE;
+    }
+    epHead->readyPasses = checkReady ? (epHead->readyPasses + 1) : 0;
+    pollSize = checkReady ? epHead->readyCount : epHead->nodeCount;
+    if (pollSize == 0) {
+        (VOID)pthread_mutex_unlock(&epHead->lock);
+        return checkReady ? 0 : poll(NULL, 0, timeout);
     }
 
     pFd = malloc(sizeof(struct pollfd) * pollSize);
     if (pFd == NULL) {
-        set_errno(EINVAL);
-        goto OUT_RELEASE;
+        (VOID)pthread_mutex_unlock(&epHead->lock);
+        set_errno(ENOMEM);
+        return -1;
     }
+    count = EpollPollFdSet(epHead, pFd, pollSize, checkReady, timeout != 0);
+    (VOID)pthread_mutex_unlock(&epHead->lock);
 
-    for (i = 0; i < pollSize; i++) {
-        pFd[i].fd = epHead->evs[i].data.fd;
-        pFd[i].events = (short)epHead->evs[i].events;
+    ret = poll(pFd, count, timeout);
+    if (ret < 0) {
+        free(pFd);
+        return ret;
     }
 
+    (VOID)pthread_mutex_lock(&epHead->lock);
+    EpollPollResultSet(epHead, pFd, count);
+    ret = EpollReadyReport(epHead, evs, maxevents);
+    (VOID)pthread_mutex_unlock(&epHead->lock);
 
-    ret = poll(pFd, pollSize, timeout);
-    if (ret <= 0) {
-        free(pFd);
-        ret = 0;
+    free(pFd);
+    return ret;
+}
+
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents, int timeout)
+{
+    struct epoll_head *epHead = NULL;
+    int ret = -1;
+
+    epHead = EpollHeadGet(epfd);
+    if (epHead == NULL) {
+        set_errno(EBADF);
+        return ret;
+    }
+
+    if ((maxevents <= 0) || (evs == NULL)) {
+        set_errno(EINVAL);
         goto OUT_RELEASE;
     }
 
-    for (i = 0, counter = 0; i < ret && counter < pollSize; counter++) {
-        if (pFd[counter].revents != 0) {
-            evs[i].data.fd = pFd[counter].fd;
-            evs[i].events  = pFd[counter].revents;
-            i++;
-        }
+    /* recheck the fds found ready last time first, most of the time nothing else needs to be scanned */
+    ret = EpollPoll(epHead, evs, maxevents, 0, TRUE);
+    if (ret == 0) {
+        ret = EpollPoll(epHead, evs, maxevents, timeout, FALSE);
     }
 
-    free(pFd);
-    ret = i;
+    if (ret < 0) {
+        ret = 0;
+    }
 
 OUT_RELEASE:
-    (VOID)pthread_mutex_unlock(&g_epollMutex);
+    EpollHeadPut(epHead);
     return ret;
 }
-
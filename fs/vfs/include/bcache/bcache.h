@@ -50,6 +50,8 @@ extern "C" {
 #define UNINT_MAX_SHIFT_BITS  31
 #define UNINT_LOG2_SHIFT      5
 #define PREREAD_BLOCK_NUM     2
+#define PREREAD_BLOCK_MAX     16
+#define PREREAD_STREAM_NUM    4
 #define EVEN_JUDGED           2
 #define PERCENTAGE            100
 #define PREREAD_EVENT_MASK    0xf
@@ -73,6 +75,7 @@ typedef struct {
     BOOL readBuff;          /* read write buffer */
     BOOL used;              /* used or free for write buf */
     BOOL allDirty;          /* the whole block is dirty */
+    UINT32 ioState;         /* device read or write in flight on the block data */
 } OsBcacheBlock;
 
 typedef INT32 (*BcacheReadFun)(struct Vnode *, /* private data */
@@ -88,7 +91,17 @@ typedef INT32 (*BcacheWriteFun)(struct Vnode *, /* private data */
 struct tagOsBcache;
 
 typedef VOID (*BcachePrereadFun)(struct tagOsBcache *,   /* block cache instance space holder */
-                                 const OsBcacheBlock *); /* block data */
+                                 const OsBcacheBlock *,  /* block data */
+                                 BOOL);                  /* block found in the cache */
+
+typedef struct {
+    UINT64 next;                  /* block a sequential reader asks for next */
+    UINT64 prereadEnd;            /* end of the blocks already read ahead */
+    UINT32 window;                /* blocks read ahead at a time, 0 until the reads look sequential */
+    UINT32 stamp;                 /* last use, the oldest stream is recycled */
+    UINT64 prereadStart;          /* first block of the pending preread */
+    UINT32 prereadCount;          /* block count of the pending preread, 0 if none */
+} OsBcacheStream;
 
 typedef struct tagOsBcache {
     VOID *priv;                   /* private data */
@@ -102,13 +115,18 @@ typedef struct tagOsBcache {
     UINT32 sectorPerBlock;        /* sector count per block */
     UINT8 *memStart;              /* memory base */
     UINT32 prereadTaskId;         /* preread task id */
-    UINT64 curBlockNum;           /* current preread block number */
+    UINT64 curBlockNum;           /* first block of the last preread asked for */
+    UINT32 prereadMax;            /* max blocks read ahead at a time */
+    UINT8 *prereadBuffer;         /* buffer for merged preread of prereadMax blocks */
+    OsBcacheStream stream[PREREAD_STREAM_NUM]; /* sequential readers being read ahead for */
+    UINT32 streamStamp;           /* stamp of the last stream used */
     LOS_DL_LIST freeListHead;     /* list of free blocks */
     BcacheReadFun breadFun;       /* block read function */
     BcacheWriteFun bwriteFun;     /* block write function */
     BcachePrereadFun prereadFun;  /* block preread function */
     UINT8 *rwBuffer;              /* buffer for bcache block */
-    pthread_mutex_t bcacheMutex;  /* mutex for bcache */
+    pthread_mutex_t bcacheMutex;  /* mutex for bcache metadata, not held across device I/O */
+    pthread_cond_t bcacheCond;    /* wait for device I/O on a block to finish */
     EVENT_CB_S bcacheEvent;       /* event for bcache */
     UINT32 modifiedBlock;         /* number of modified blocks */
 #ifdef LOSCFG_FS_FAT_CACHE_SYNC_THREAD
@@ -263,7 +281,7 @@ VOID BcacheSyncThreadDeinit(const OsBcache *bc);
 
 UINT32 BcacheAsyncPrereadInit(OsBcache *bc);
 
-VOID ResumeAsyncPreread(OsBcache *arg1, const OsBcacheBlock *arg2);
+VOID ResumeAsyncPreread(OsBcache *arg1, const OsBcacheBlock *arg2, BOOL hit);
 
 UINT32 BcacheAsyncPrereadDeinit(OsBcache *bc);
 
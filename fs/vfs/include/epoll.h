@@ -55,6 +55,8 @@ extern "C" {
 #define EPOLLMSG        0x400
 #define EPOLLERR        0x008
 #define EPOLLHUP        0x010
+#define EPOLLONESHOT    (1U << 30)
+#define EPOLLET         (1U << 31)
 
 #define EPOLL_CTL_ADD 1
 #define EPOLL_CTL_DEL 2
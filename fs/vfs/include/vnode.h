@@ -34,7 +34,9 @@
 #include <sys/stat.h>
 #include "fs/fs_operation.h"
 #include "fs/file.h"
+#include "los_atomic.h"
 #include "los_list.h"
+#include "los_rbtree.h"
 
 typedef LOS_DL_LIST LIST_HEAD;
 typedef LOS_DL_LIST LIST_ENTRY;
@@ -130,9 +132,13 @@ struct Vnode {
     struct Mount *newMount;             /* fs info about who mount on this vnode */
     char *filePath;                     /* file path of the vnode */
     struct page_mapping mapping;        /* page mapping of the vnode */
+    LosRbTree pageTree;                 /* page cache of the mapping, indexed by pgoff */
+    unsigned long raNext;               /* pgoff a sequential page fault would hit next */
+    unsigned int raWindow;              /* pages read ahead on a sequential page cache miss */
 #ifdef LOSCFG_MNT_CONTAINER
     int mntCount;                       /* ref count of mounts */
 #endif
+    Atomic refCount;                    /* pins taken without g_vnodeMux, kept across VnodeFree */
 };
 
 struct VnodeOps {
@@ -171,6 +177,10 @@ int VnodeFree(struct Vnode *vnode);
 int VnodeLookup(const char *path, struct Vnode **vnode, uint32_t flags);
 int VnodeLookupFullpath(const char *fullpath, struct Vnode **vnode, uint32_t flags);
 int VnodeLookupAt(const char *path, struct Vnode **vnode, uint32_t flags, struct Vnode *orgVnode);
+int VnodeLookupHold(const char *path, struct Vnode **vnode, uint32_t flags);
+int VnodeLookupGet(const char *path, struct Vnode **vnode);
+void VnodePut(struct Vnode *vnode);
+void VnodeLookupSeqBump(void);
 int VnodeHold(void);
 int VnodeDrop(void);
 void VnodeRefDec(struct Vnode *vnode);
@@ -55,6 +55,7 @@ struct Mount *MountAlloc(struct Vnode *vnodeBeCovered, struct MountOps *fsop)
     LOS_ListInit(&mnt->activeVnodeList);
     LOS_ListInit(&mnt->vnodeList);
 
+    VnodeLookupSeqBump();
     mnt->vnodeBeCovered = vnodeBeCovered;
     vnodeBeCovered->newMount = mnt;
 #ifdef LOSCFG_DRIVERS_RANDOM
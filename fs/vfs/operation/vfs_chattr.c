@@ -65,15 +65,14 @@ int chattr(const char *pathname, struct IATTR *attr)
         return VFS_ERROR;
     }
 
-    VnodeHold();
-    ret = VnodeLookup(pathname, &vnode, 0);
+    ret = VnodeLookupGet(pathname, &vnode);
     if (ret != LOS_OK) {
-        goto errout_with_lock;
+        goto errout;
     }
 
     if ((vnode->originMount) && (vnode->originMount->mountFlags & MS_RDONLY)) {
         ret = -EROFS;
-        goto errout_with_lock;
+        goto errout_with_vnode;
     }
 
     /* The way we handle the stat depends on the type of vnode that we
@@ -81,11 +80,14 @@ int chattr(const char *pathname, struct IATTR *attr)
      */
 
     if (vnode->vop != NULL && vnode->vop->Chattr != NULL) {
+        /* chmod and chown change cached lookups; bump on both sides of the change */
+        VnodeLookupSeqBump();
         ret = vnode->vop->Chattr(vnode, attr);
+        VnodeLookupSeqBump();
     } else {
         ret = -ENOSYS;
     }
-    VnodeDrop();
+    VnodePut(vnode);
 
     if (ret < 0) {
         goto errout;
@@ -95,8 +97,8 @@ int chattr(const char *pathname, struct IATTR *attr)
 
     /* Failure conditions always set the errno appropriately */
 
-errout_with_lock:
-    VnodeDrop();
+errout_with_vnode:
+    VnodePut(vnode);
 errout:
     set_errno(-ret);
     return VFS_ERROR;
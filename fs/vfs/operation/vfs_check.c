@@ -54,10 +54,8 @@ int fscheck(const char *path)
     struct fs_dirent_s *dir = NULL;
 
     /* Find the node matching the path. */
-    VnodeHold();
-    ret = VnodeLookup(path, &vnode, 0);
+    ret = VnodeLookupGet(path, &vnode);
     if (ret != OK) {
-        VnodeDrop();
         goto errout;
     }
 
@@ -65,22 +63,22 @@ int fscheck(const char *path)
     if (!dir) {
         /* Insufficient memory to complete the operation. */
         ret = -ENOMEM;
-        VnodeDrop();
+        VnodePut(vnode);
         goto errout;
     }
 
     if (vnode->vop && vnode->vop->Fscheck) {
         ret = vnode->vop->Fscheck(vnode, dir);
         if (ret != OK) {
-            VnodeDrop();
+            VnodePut(vnode);
             goto errout_with_direntry;
         }
     } else {
         ret = -ENOSYS;
-        VnodeDrop();
+        VnodePut(vnode);
         goto errout_with_direntry;
     }
-    VnodeDrop();
+    VnodePut(vnode);
 
     free(dir);
     return 0;
@@ -419,7 +419,7 @@ static void FileDisableAndClean(const struct Mount *mnt)
 
 static void VnodeTryFree(struct Vnode *vnode)
 {
-    if (vnode->useCount == 0) {
+    if ((vnode->useCount == 0) && (LOS_AtomicRead(&vnode->refCount) == 0)) {
         VnodeFree(vnode);
         return;
     }
@@ -479,6 +479,7 @@ int ForceUmountDev(struct Vnode *dev)
     free(mnt);
     origin->newMount = NULL;
     origin->flag &= ~(VNODE_FLAG_MOUNT_ORIGIN);
+    VnodeLookupSeqBump();
 
     VnodeDrop();
     (void)sem_post(&flist->fl_sem);
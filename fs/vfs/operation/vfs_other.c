@@ -778,8 +778,7 @@ int chroot(const char *path)
         set_errno(ENAMETOOLONG);
         return VFS_ERROR;
     }
-    VnodeHold();
-    ret = VnodeLookup(path, &vnode, 0);
+    ret = VnodeLookupHold(path, &vnode, 0);
     if (ret != LOS_OK) {
         VnodeDrop();
         return ret;
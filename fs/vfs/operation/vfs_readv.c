@@ -38,6 +38,75 @@
 #include "user_copy.h"
 #include "stdio.h"
 #include "limits.h"
+#include "vnode.h"
+
+/*
+ * Reading a seekable file segment by segment returns the same data as one
+ * read of the whole length, so the segments are filled in place by the
+ * filesystem, the way read() fills the buffer of SysRead. Stream files (pipe,
+ * tty, socket...) must be read once, or the next segment may block after the
+ * first one is filled. preadv keeps the kernel buffer, like SysPread64.
+ */
+static bool iov_read_in_place(int fd, const struct iovec *iov, int iovcnt)
+{
+    struct file *filep = NULL;
+    size_t buflen = 0;
+    int segments = 0;
+    int i;
+
+    if ((iov == NULL) || (iovcnt > IOV_MAX)) {
+        return false;
+    }
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (SSIZE_MAX - buflen < iov[i].iov_len) {
+            /* left to pread_buf_and_check to report */
+            return false;
+        }
+        buflen += iov[i].iov_len;
+        if (iov[i].iov_len != 0) {
+            segments++;
+        }
+    }
+
+    if (segments <= 1) {
+        return true;
+    }
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+    if (((unsigned int)fd < CONFIG_NFILE_DESCRIPTORS) && (fs_getfilep(fd, &filep) == OK) && (filep->f_vnode != NULL)) {
+        return (filep->f_vnode->type == VNODE_TYPE_REG) || (filep->f_vnode->type == VNODE_TYPE_BLK);
+    }
+#endif
+
+    return false;
+}
+
+static ssize_t iov_read_direct(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t totalbytesread = 0;
+    ssize_t ret;
+    int i;
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+
+        ret = read(fd, iov[i].iov_base, iov[i].iov_len);
+        if (ret < 0) {
+            /* the data already read is reported, the error comes with the next call */
+            return (totalbytesread > 0) ? totalbytesread : VFS_ERROR;
+        }
+
+        totalbytesread += ret;
+        if ((size_t)ret < iov[i].iov_len) {
+            break;
+        }
+    }
+
+    return totalbytesread;
+}
 
 static char *pread_buf_and_check(int fd, const struct iovec *iov, int iovcnt, ssize_t *totalbytesread, off_t *offset)
 {
@@ -98,6 +167,10 @@ ssize_t vfs_readv(int fd, const struct iovec *iov, int iovcnt, off_t *offset)
     ssize_t totalbytesread = 0;
     ssize_t bytesleft;
 
+    if ((offset == NULL) && iov_read_in_place(fd, iov, iovcnt)) {
+        return iov_read_direct(fd, iov, iovcnt);
+    }
+
     buf = pread_buf_and_check(fd, iov, iovcnt, &totalbytesread, offset);
     if (buf == NULL) {
         return totalbytesread;
@@ -73,15 +73,13 @@ int utime(const char *path, const struct utimbuf *ptimes)
     }
 
     /* Get the vnode for this file */
-    VnodeHold();
-    ret = VnodeLookup(fullpath, &vnode, 0);
+    ret = VnodeLookupGet(fullpath, &vnode);
     if (ret != LOS_OK) {
-        VnodeDrop();
         goto errout_with_path;
     }
 
     if ((vnode->originMount) && (vnode->originMount->mountFlags & MS_RDONLY)) {
-        VnodeDrop();
+        VnodePut(vnode);
         ret = -EROFS;
         goto errout_with_path;
     }
@@ -99,15 +97,15 @@ int utime(const char *path, const struct utimbuf *ptimes)
         attr.attr_chg_valid = CHG_ATIME | CHG_MTIME;
         ret = vnode->vop->Chattr(vnode, &attr);
         if (ret != OK) {
-            VnodeDrop();
+            VnodePut(vnode);
             goto errout_with_path;
         }
     } else {
         ret = -ENOSYS;
-        VnodeDrop();
+        VnodePut(vnode);
         goto errout_with_path;
     }
-    VnodeDrop();
+    VnodePut(vnode);
 
     /* Successfully stat'ed the file */
     free(fullpath);
@@ -38,6 +38,53 @@
 #include "user_copy.h"
 #include "limits.h"
 
+/*
+ * A single segment is written straight from the user buffer, the way write()
+ * takes the buffer of SysWrite. Several segments are gathered into one write,
+ * so that writev stays atomic like write: split into one write per segment,
+ * they could interleave with other writers of the same file, and no file lock
+ * can be held across them. pwritev keeps the kernel buffer, like SysPwrite64.
+ */
+static bool iov_write_in_place(const struct iovec *iov, int iovcnt)
+{
+    int segments = 0;
+    int i;
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len != 0) {
+            segments++;
+        }
+    }
+
+    return segments <= 1;
+}
+
+static ssize_t iov_write_direct(int fd, const struct iovec *iov, int iovcnt)
+{
+    ssize_t totalbyteswritten = 0;
+    ssize_t ret;
+    int i;
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+
+        ret = write(fd, iov[i].iov_base, iov[i].iov_len);
+        if (ret < 0) {
+            /* the data already written is reported, the error comes with the next call */
+            return (totalbyteswritten > 0) ? totalbyteswritten : VFS_ERROR;
+        }
+
+        totalbyteswritten += ret;
+        if ((size_t)ret < iov[i].iov_len) {
+            break;
+        }
+    }
+
+    return totalbyteswritten;
+}
+
 static int iov_trans_to_buf(char *buf, ssize_t totallen, const struct iovec *iov, int iovcnt)
 {
     int i;
@@ -101,6 +148,10 @@ ssize_t vfs_writev(int fd, const struct iovec *iov, int iovcnt, off_t *offset)
         return 0;
     }
 
+    if ((offset == NULL) && iov_write_in_place(iov, iovcnt)) {
+        return iov_write_direct(fd, iov, iovcnt);
+    }
+
     totallen = buflen * sizeof(char);
 #ifdef LOSCFG_KERNEL_VM
     buf = (char *)LOS_VMalloc(totallen);
@@ -151,6 +151,7 @@ int PathCacheFree(struct PathCache *pc)
         return -ENOENT;
     }
 
+    VnodeLookupSeqBump();
     LOS_ListDelete(&pc->hashEntry);
     LOS_ListDelete(&pc->parentEntry);
     LOS_ListDelete(&pc->childEntry);
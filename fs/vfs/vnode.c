@@ -29,12 +29,17 @@
  */
 
 #include "los_mux.h"
+#include "los_hash.h"
+#include "los_hw_cpu.h"
 #include "fs/dirent_fs.h"
 #include "path_cache.h"
 #include "vnode.h"
 #include "los_process.h"
 #include "los_process_pri.h"
 #include "capability_api.h"
+#ifdef LOSCFG_KERNEL_VM
+#include "los_vm_filemap.h"
+#endif
 
 LIST_HEAD g_vnodeFreeList;              /* free vnodes list */
 LIST_HEAD g_vnodeVirtualList;           /* dev vnodes list */
@@ -50,6 +55,28 @@ static struct VnodeOps g_devfsOps;
 #define VNODE_LRU_COUNT      10
 #define DEV_VNODE_MODE       0755
 
+#define VNODE_LOOKUP_CACHE_SIZE  64 /* must be a power of 2 */
+#define VNODE_LOOKUP_PATH_MAX    64
+
+/*
+ * Full path lookup cache, read without g_vnodeMux by VnodeLookupGet(). A slot is filled
+ * under g_vnodeMux and is only used while g_vnodeLookupSeq still has the value it had
+ * when the walk started. The seq is bumped by whatever can change a cached result:
+ * freeing a vnode or a path cache (unlink, rename, umount), chattr and mount.
+ */
+struct VnodeLookupSlot {
+    Atomic seq;                         /* odd while the slot is being written */
+    uint32_t lookupSeq;                 /* g_vnodeLookupSeq the walk started at */
+    uint32_t hash;                      /* hash of path and root */
+    struct Vnode *root;                 /* root vnode of the walk */
+    LIST_HEAD *mntList;                 /* mount list the walk crossed mounts with */
+    struct Vnode *vnode;                /* result of the walk */
+    char path[VNODE_LOOKUP_PATH_MAX];   /* normalized path */
+};
+
+static Atomic g_vnodeLookupSeq = 0;
+static struct VnodeLookupSlot g_vnodeLookupCache[VNODE_LOOKUP_CACHE_SIZE];
+
 int VnodesInit(void)
 {
     int retval = LOS_MuxInit(&g_vnodeMux, NULL);
@@ -170,6 +197,9 @@ int VnodeAlloc(struct VnodeOps *vop, struct Vnode **newVnode)
     LOS_SpinInit(&vnode->mapping.list_lock);
     (VOID)LOS_MuxInit(&vnode->mapping.mux_lock, NULL);
     vnode->mapping.host = vnode;
+#ifdef LOSCFG_KERNEL_VM
+    OsPageCacheTreeInit(&vnode->pageTree);
+#endif
 
     VnodeDrop();
 
@@ -185,7 +215,8 @@ int VnodeFree(struct Vnode *vnode)
     }
 
     VnodeHold();
-    if (vnode->useCount > 0) {
+    VnodeLookupSeqBump();
+    if ((vnode->useCount > 0) || (LOS_AtomicRead(&vnode->refCount) > 0)) {
         VnodeDrop();
         return -EBUSY;
     }
@@ -202,16 +233,16 @@ int VnodeFree(struct Vnode *vnode)
         free(vnode->filePath);
     }
     if (vnode->vop == &g_devfsOps) {
-        /* for dev vnode, just free it */
+        /* for dev vnode, free its private data */
         free(vnode->data);
-        free(vnode);
-        g_totalVnodeSize--;
-    } else {
-        /* for normal vnode, reclaim it to g_VnodeFreeList */
-        (void)memset_s(vnode, sizeof(struct Vnode), 0, sizeof(struct Vnode));
-        LOS_ListAdd(&g_vnodeFreeList, &vnode->actFreeEntry);
-        g_freeVnodeSize++;
     }
+    /*
+     * Reclaim the vnode to g_VnodeFreeList, dev vnodes too. A stale lookup cache slot may
+     * still pin it, so it is never given back to the heap and refCount survives.
+     */
+    (void)memset_s(vnode, offsetof(struct Vnode, refCount), 0, offsetof(struct Vnode, refCount));
+    LOS_ListAdd(&g_vnodeFreeList, &vnode->actFreeEntry);
+    g_freeVnodeSize++;
     VnodeDrop();
 
     return LOS_OK;
@@ -241,7 +272,8 @@ BOOL VnodeInUseIter(const struct Mount *mount)
 
     LOS_DL_LIST_FOR_EACH_ENTRY(vnode, &g_vnodeActiveList, struct Vnode, actFreeEntry) {
         if (vnode->originMount == mount) {
-            if ((vnode->useCount > 0) || (vnode->flag & VNODE_FLAG_MOUNT_ORIGIN)) {
+            if ((vnode->useCount > 0) || (LOS_AtomicRead(&vnode->refCount) > 0) ||
+                (vnode->flag & VNODE_FLAG_MOUNT_ORIGIN)) {
                 return TRUE;
             }
         }
@@ -393,29 +425,18 @@ STEP_FINISH:
     return ret;
 }
 
-int VnodeLookupAt(const char *path, struct Vnode **result, uint32_t flags, struct Vnode *orgVnode)
+/*
+ * Walk normalizedPath from startVnode with g_vnodeMux held. normalizedPath is consumed:
+ * it becomes the filePath of the result or is freed. *shared, if not NULL, is cleared
+ * when a directory on the way is not searchable by everyone, so the result depends on
+ * the caller's credentials.
+ */
+static int VnodeLookupNormalized(char *normalizedPath, struct Vnode *startVnode, struct Vnode **result,
+                                 uint32_t flags, BOOL *shared)
 {
-    int ret;
+    int ret = LOS_OK;
     int vnodePathLen;
     char *vnodePath = NULL;
-    struct Vnode *startVnode = NULL;
-    char *normalizedPath = NULL;
-
-    if (orgVnode != NULL) {
-        startVnode = orgVnode;
-        normalizedPath = strdup(path);
-        if (normalizedPath == NULL) {
-            PRINT_ERR("[VFS]lookup failed, strdup err\n");
-            ret = -EINVAL;
-            goto OUT_FREE_PATH;
-        }
-    } else {
-        ret = PreProcess(path, &startVnode, &normalizedPath);
-        if (ret != LOS_OK) {
-            PRINT_ERR("[VFS]lookup failed, invalid path err = %d\n", ret);
-            goto OUT_FREE_PATH;
-        }
-    }
 
     if (normalizedPath[1] == '\0' && normalizedPath[0] == '/') {
         *result = GetCurrRootVnode();
@@ -441,6 +462,9 @@ int VnodeLookupAt(const char *path, struct Vnode **result, uint32_t flags, struc
             ret = -EACCES;
             goto OUT_FREE_PATH;
         }
+        if ((shared != NULL) && ((currentVnode->mode & MODE_IXUGO) != MODE_IXUGO)) {
+            *shared = FALSE;
+        }
 
         if (ret != LOS_OK) {
             // no such file, lookup failed
@@ -471,6 +495,37 @@ OUT_FREE_PATH:
     return ret;
 }
 
+int VnodeLookupAt(const char *path, struct Vnode **result, uint32_t flags, struct Vnode *orgVnode)
+{
+    int ret;
+    struct Vnode *startVnode = NULL;
+    char *normalizedPath = NULL;
+
+    if (orgVnode != NULL) {
+        startVnode = orgVnode;
+        normalizedPath = strdup(path);
+        if (normalizedPath == NULL) {
+            PRINT_ERR("[VFS]lookup failed, strdup err\n");
+            ret = -EINVAL;
+            goto OUT_FREE_PATH;
+        }
+    } else {
+        ret = PreProcess(path, &startVnode, &normalizedPath);
+        if (ret != LOS_OK) {
+            PRINT_ERR("[VFS]lookup failed, invalid path err = %d\n", ret);
+            goto OUT_FREE_PATH;
+        }
+    }
+
+    return VnodeLookupNormalized(normalizedPath, startVnode, result, flags, NULL);
+
+OUT_FREE_PATH:
+    if (normalizedPath) {
+        free(normalizedPath);
+    }
+    return ret;
+}
+
 int VnodeLookup(const char *path, struct Vnode **vnode, uint32_t flags)
 {
     return VnodeLookupAt(path, vnode, flags, NULL);
@@ -481,6 +536,149 @@ int VnodeLookupFullpath(const char *fullpath, struct Vnode **vnode, uint32_t fla
     return VnodeLookupAt(fullpath, vnode, flags, GetCurrRootVnode());
 }
 
+/*
+ * Same as VnodeHold() followed by VnodeLookup(), but the path is normalized before
+ * g_vnodeMux is taken, so that only the walk runs under it. Returns with g_vnodeMux
+ * held, also on failure.
+ */
+int VnodeLookupHold(const char *path, struct Vnode **vnode, uint32_t flags)
+{
+    int ret;
+    char *normalizedPath = NULL;
+
+    ret = vfs_normalize_path(NULL, path, &normalizedPath);
+    VnodeHold();
+    if (ret != LOS_OK) {
+        PRINT_ERR("[VFS]lookup failed, invalid path err = %d\n", ret);
+        return ret;
+    }
+
+    return VnodeLookupNormalized(normalizedPath, GetCurrRootVnode(), vnode, flags, NULL);
+}
+
+void VnodeLookupSeqBump(void)
+{
+    LOS_AtomicInc(&g_vnodeLookupSeq);
+    /* pairs with the barrier in VnodeLookupCacheGet(), orders the bump before refCount reads */
+    DMB;
+}
+
+static uint32_t VnodeLookupHash(const char *path, size_t len, const struct Vnode *root)
+{
+    uint32_t hash;
+    hash = LOS_HashFNV32aBuf(path, len, FNV1_32A_INIT);
+    hash = LOS_HashFNV32aBuf(&root, sizeof(struct Vnode *), hash);
+    return hash;
+}
+
+static struct Vnode *VnodeLookupCacheGet(const char *path, uint32_t hash, const struct Vnode *root,
+                                         const LIST_HEAD *mntList)
+{
+    struct VnodeLookupSlot *slot = &g_vnodeLookupCache[hash & (VNODE_LOOKUP_CACHE_SIZE - 1)];
+    INT32 lookupSeq = LOS_AtomicRead(&g_vnodeLookupSeq);
+    INT32 seq = LOS_AtomicRead(&slot->seq);
+    struct Vnode *vnode = NULL;
+
+    if ((uint32_t)seq & 1) {
+        return NULL;
+    }
+    DMB;
+    if ((slot->lookupSeq == (uint32_t)lookupSeq) && (slot->hash == hash) && (slot->root == root) &&
+        (slot->mntList == mntList) && (strncmp(slot->path, path, VNODE_LOOKUP_PATH_MAX) == 0)) {
+        vnode = slot->vnode;
+    }
+    DMB;
+    if ((vnode == NULL) || (LOS_AtomicRead(&slot->seq) != seq)) {
+        return NULL;
+    }
+
+    /*
+     * Vnodes are never given back to the heap, so the pin is safe even if the vnode was
+     * freed meanwhile. VnodeFree() bumps the seq before it checks refCount: either it
+     * sees the pin, or the seq check below sees the bump and drops it.
+     */
+    LOS_AtomicInc(&vnode->refCount);
+    DMB;
+    if (LOS_AtomicRead(&g_vnodeLookupSeq) != lookupSeq) {
+        LOS_AtomicDec(&vnode->refCount);
+        return NULL;
+    }
+    return vnode;
+}
+
+static void VnodeLookupCacheFill(const char *path, uint32_t hash, struct Vnode *root, LIST_HEAD *mntList,
+                                 struct Vnode *vnode, uint32_t lookupSeq)
+{
+    struct VnodeLookupSlot *slot = &g_vnodeLookupCache[hash & (VNODE_LOOKUP_CACHE_SIZE - 1)];
+
+    LOS_AtomicInc(&slot->seq);
+    DMB;
+    slot->lookupSeq = lookupSeq;
+    slot->hash = hash;
+    slot->root = root;
+    slot->mntList = mntList;
+    slot->vnode = vnode;
+    (void)strcpy_s(slot->path, VNODE_LOOKUP_PATH_MAX, path);
+    DMB;
+    LOS_AtomicInc(&slot->seq);
+}
+
+/*
+ * Look up path and pin the result with a reference instead of g_vnodeMux. A hit in the
+ * lookup cache does not take g_vnodeMux at all; a miss walks under it and fills the cache
+ * when the result does not depend on the caller's credentials. Returns without g_vnodeMux
+ * held. On success the vnode stays valid until VnodePut(), but its vops run unserialized
+ * against other lookups, so they must lock their file system themselves.
+ */
+int VnodeLookupGet(const char *path, struct Vnode **vnode)
+{
+    int ret;
+    size_t len;
+    uint32_t hash;
+    uint32_t lookupSeq;
+    BOOL shared = TRUE;
+    char *normalizedPath = NULL;
+    char key[VNODE_LOOKUP_PATH_MAX] = {0};
+    struct Vnode *root = GetCurrRootVnode();
+    LIST_HEAD *mntList = GetMountList();
+
+    ret = vfs_normalize_path(NULL, path, &normalizedPath);
+    if (ret != LOS_OK) {
+        PRINT_ERR("[VFS]lookup failed, invalid path err = %d\n", ret);
+        return ret;
+    }
+
+    len = strlen(normalizedPath);
+    hash = VnodeLookupHash(normalizedPath, len, root);
+    if (len < VNODE_LOOKUP_PATH_MAX) {
+        *vnode = VnodeLookupCacheGet(normalizedPath, hash, root, mntList);
+        if (*vnode != NULL) {
+            free(normalizedPath);
+            return LOS_OK;
+        }
+        (void)strcpy_s(key, VNODE_LOOKUP_PATH_MAX, normalizedPath);
+    }
+
+    VnodeHold();
+    lookupSeq = (uint32_t)LOS_AtomicRead(&g_vnodeLookupSeq);
+    DMB;
+    ret = VnodeLookupNormalized(normalizedPath, root, vnode, 0, &shared);
+    if (ret == LOS_OK) {
+        LOS_AtomicInc(&(*vnode)->refCount);
+        if (shared && (len < VNODE_LOOKUP_PATH_MAX)) {
+            VnodeLookupCacheFill(key, hash, root, mntList, *vnode, lookupSeq);
+        }
+    }
+    VnodeDrop();
+
+    return ret;
+}
+
+void VnodePut(struct Vnode *vnode)
+{
+    LOS_AtomicDec(&vnode->refCount);
+}
+
 static void ChangeRootInternal(struct Vnode *rootOld, char *dirname)
 {
     int ret;
@@ -126,6 +126,19 @@ VOID OsSetMainTaskProcess(UINTPTR processCB)
 LITE_OS_SEC_TEXT WEAK VOID OsIdleTask(VOID)
 {
     while (1) {
+#ifdef LOSCFG_KERNEL_SMP
+        /* steal the work queued on the other cores before going to sleep */
+        if (HPFRunqueueStealable(OsSchedRunqueue())) {
+            LOS_Schedule();
+            continue;
+        }
+#endif
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+        /* zero one page for the anonymous fault path at a time, so a woken task is not held up */
+        if (OsVmZeroPoolFill()) {
+            continue;
+        }
+#endif
         WFI;
     }
 }
@@ -687,9 +700,6 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_TaskCreate(UINT32 *taskID, TSK_INIT_PARAM_S *in
     taskCB->ops->enqueue(OsSchedRunqueue(), taskCB);
     SCHEDULER_UNLOCK(intSave);
 
-    /* in case created task not running on this core,
-       schedule or not depends on other schedulers status. */
-    LOS_MpSchedule(OS_MP_CPU_ALL);
     if (OS_SCHEDULER_ACTIVE) {
         LOS_Schedule();
     }
@@ -724,7 +734,6 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_TaskResume(UINT32 taskID)
     errRet = taskCB->ops->resume(taskCB, &needSched);
     SCHEDULER_UNLOCK(intSave);
 
-    LOS_MpSchedule(OS_MP_CPU_ALL);
     if (OS_SCHEDULER_ACTIVE && needSched) {
         LOS_Schedule();
     }
@@ -1071,7 +1080,14 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_TaskYield(VOID)
         return LOS_ERRNO_TSK_ID_INVALID;
     }
 
-    SCHEDULER_LOCK(intSave);
+    /* nothing else would run here: the time slice is renewed without taking g_taskSpin */
+    intSave = LOS_IntLock();
+    if (!OsSchedNeedResched(OsSchedRunqueue(), runTask, TRUE)) {
+        LOS_IntRestore(intSave);
+        return LOS_OK;
+    }
+
+    LOS_SpinLock(&g_taskSpin);
     /* reset timeslice of yielded task */
     runTask->ops->yield(runTask);
     SCHEDULER_UNLOCK(intSave);
@@ -1157,6 +1173,13 @@ LITE_OS_SEC_TEXT BOOL OsTaskCpuAffiSetUnsafe(UINT32 taskID, UINT16 newCpuAffiMas
     LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
 
     taskCB->cpuAffiMask = newCpuAffiMask;
+    if (OsTaskIsReady(taskCB) && !OsSchedPolicyIsEDF(taskCB) &&
+        !(CPUID_TO_AFFI_MASK(taskCB->readyCpu) & newCpuAffiMask)) {
+        /* the task is queued on a core it may no longer run on, move it to an allowed one */
+        taskCB->ops->dequeue(OsSchedRunqueue(), taskCB);
+        taskCB->ops->enqueue(OsSchedRunqueue(), taskCB);
+    }
+
     *oldCpuAffiMask = CPUID_TO_AFFI_MASK(taskCB->currCpu);
     if (!((*oldCpuAffiMask) & newCpuAffiMask)) {
         taskCB->signal = SIGNAL_AFFI;
@@ -34,6 +34,8 @@
 
 #include "los_base.h"
 #include "los_hw_cpu.h"
+#include "los_atomic.h"
+#include "los_mp.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -53,6 +55,10 @@ typedef struct {
 #ifdef LOSCFG_KERNEL_SMP_CALL
     LOS_DL_LIST funcLink;              /* mp function call link */
 #endif
+    Atomic      schedIpiPending;       /* a schedule ipi to this cpu is not handled yet */
+    Atomic      schedIpiSent;          /* schedule ipis sent by this cpu */
+    Atomic      schedIpiMerged;        /* schedule ipis this cpu left out, one was already pending */
+    UINT32      ipiRecv[LOS_MP_IPI_TYPE_NUM]; /* ipis handled by this cpu, by type */
 } Percpu;
 
 /* the kernel per-cpu structure */
@@ -33,6 +33,7 @@
 #define _LOS_QUEUE_PRI_H
 
 #include "los_queue.h"
+#include "los_atomic.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -74,6 +75,18 @@ typedef struct TagQueueCB {
     UINT16 queueHead; /**< Node head */
     UINT16 queueTail; /**< Node tail */
     UINT16 readWriteableCnt[OS_QUEUE_N_RW]; /**< Count of readable or writable resources, 0:readable, 1:writable */
+    UINT16 *queueSlot; /**< Node held by each queue position, next node of the same priority for LOS_QUEUE_PRIO */
+    UINT16 *queueFree; /**< Stack of nodes not held by any position */
+    UINT16 queueFreeTop; /**< Number of nodes on the free stack */
+    UINT16 queuePublish; /**< First position reserved by a writer but not yet published */
+    UINT16 queuePending; /**< Number of positions reserved by writers but not yet published */
+    UINT16 queueFlags; /**< Queue mode flags, LOS_QUEUE_SPSC or LOS_QUEUE_PRIO */
+    UINT32 queuePrioBitmap; /**< Bit n set when a message of priority n is queued, LOS_QUEUE_PRIO only */
+    UINT16 *queuePrioList; /**< First and last node of each priority, LOS_QUEUE_PRIO only */
+    UINT8 *queueReserved; /**< Whether each node is held by LOS_QueueReserve and not yet committed */
+    Atomic queueCount; /**< Count of filled nodes, LOS_QUEUE_SPSC only */
+    Atomic queueWaiting[OS_QUEUE_N_RW]; /**< Whether a reader or writer is waiting, LOS_QUEUE_SPSC only */
+    Atomic queueBusy; /**< Count of operations and reservations in progress, LOS_QUEUE_SPSC only */
     LOS_DL_LIST readWriteList[OS_QUEUE_N_RW]; /**< the linked list to be read or written, 0:readlist, 1:writelist */
     LOS_DL_LIST memList; /**< Pointer to the memory linked list */
 } LosQueueCB;
@@ -72,6 +72,8 @@ extern "C" {
 #define OS_SCHED_EDF_MIN_DEADLINE   400 /* 400 us */
 #define OS_SCHED_EDF_MAX_DEADLINE   5000000 /* 5 s */
 
+#define OS_SCHED_BALANCE_PERIOD     (OS_SYS_CLOCK / 100) /* 10 ms */
+
 extern UINT32 g_taskScheduled;
 #define OS_SCHEDULER_ACTIVE (g_taskScheduled & (1U << ArchCurrCpuid()))
 #define OS_SCHEDULER_ALL_ACTIVE (g_taskScheduled == LOSCFG_KERNEL_CPU_MASK)
@@ -100,6 +102,7 @@ typedef struct {
 typedef struct {
     HPFQueue queueList[OS_PRIORITY_QUEUE_NUM];
     UINT32   queueBitmap;
+    UINT32   readyTasks; /* number of ready tasks in all the priority queues */
 } HPFRunqueue;
 
 typedef struct {
@@ -109,12 +112,17 @@ typedef struct {
 } EDFRunqueue;
 
 typedef struct {
+    SPIN_LOCK_S       lock;         /* runqueue lock, protects the ready queues of this CPU */
     SortLinkAttribute timeoutQueue; /* task timeout queue */
     HPFRunqueue       *hpfRunqueue;
     EDFRunqueue       *edfRunqueue;
     UINT64            responseTime; /* Response time for current CPU tick interrupts */
     UINT32            responseID;   /* The response ID of the current CPU tick interrupt */
     LosTaskCB         *idleTask;   /* idle task id */
+    LosTaskCB         *runTask;    /* task running on this CPU */
+#ifdef LOSCFG_KERNEL_SMP
+    UINT64            balanceTime;  /* Time of the next periodic load balancing */
+#endif
     UINT32            taskLockCnt;  /* task lock flag */
     UINT32            schedFlag;    /* pending scheduler flag */
 } SchedRunqueue;
@@ -133,6 +141,56 @@ STATIC INLINE SchedRunqueue *OsSchedRunqueueByID(UINT16 id)
     return &g_schedRunqueue[id];
 }
 
+STATIC INLINE UINT16 OsSchedRunqueueID(const SchedRunqueue *rq)
+{
+    return (UINT16)(rq - &g_schedRunqueue[0]);
+}
+
+/*
+ * Lock order: g_taskSpin -> runqueue lock -> timeout queue lock.
+ * The ready queues of a runqueue and the readyCpu of the tasks queued on it are
+ * only read or changed with the runqueue lock held. The tick balance moves tasks
+ * between runqueues without g_taskSpin, so g_taskSpin alone does not protect them.
+ * g_taskSpin guards the task state and wait lists, and is handed over by the
+ * context switch. The tick, the reschedule IPI and a yield decide under the
+ * runqueue locks whether another task would run, and only take g_taskSpin to
+ * switch to it.
+ */
+STATIC INLINE VOID OsSchedRunqueueLock(SchedRunqueue *rq)
+{
+    LOS_SpinLock(&rq->lock);
+}
+
+STATIC INLINE VOID OsSchedRunqueueUnlock(SchedRunqueue *rq)
+{
+    LOS_SpinUnlock(&rq->lock);
+}
+
+/*
+ * Cross-CPU wakeups and migrations need the runqueues of both CPUs, they are
+ * always taken in ascending CPU order to avoid ABBA deadlock.
+ */
+STATIC INLINE VOID OsSchedRunqueueDoubleLock(SchedRunqueue *rq1, SchedRunqueue *rq2)
+{
+    if (rq1 == rq2) {
+        LOS_SpinLock(&rq1->lock);
+    } else if (rq1 < rq2) {
+        LOS_SpinLock(&rq1->lock);
+        LOS_SpinLock(&rq2->lock);
+    } else {
+        LOS_SpinLock(&rq2->lock);
+        LOS_SpinLock(&rq1->lock);
+    }
+}
+
+STATIC INLINE VOID OsSchedRunqueueDoubleUnlock(SchedRunqueue *rq1, SchedRunqueue *rq2)
+{
+    LOS_SpinUnlock(&rq1->lock);
+    if (rq1 != rq2) {
+        LOS_SpinUnlock(&rq2->lock);
+    }
+}
+
 STATIC INLINE UINT32 OsSchedLockCountGet(VOID)
 {
     return OsSchedRunqueue()->taskLockCnt;
@@ -428,6 +486,7 @@ typedef struct TagTaskCB {
 #ifdef LOSCFG_KERNEL_SMP
     UINT16          currCpu;            /**< CPU core number of this task is running on */
     UINT16          lastCpu;            /**< CPU core number of this task is running on last time */
+    UINT16          readyCpu;           /**< CPU core number of the runqueue this task is queued on */
     UINT16          cpuAffiMask;        /**< CPU affinity mask, support up to 16 cores */
 #ifdef LOSCFG_KERNEL_SMP_TASK_SYNC
     UINT32          syncSignal;         /**< Synchronization for signal handling */
@@ -673,12 +732,12 @@ STATIC INLINE LosTaskCB *EDFRunqueueTopTaskGet(EDFRunqueue *rq)
     return LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(root), LosTaskCB, pendList);
 }
 
-STATIC INLINE LosTaskCB *HPFRunqueueTopTaskGet(HPFRunqueue *rq)
+STATIC INLINE LosTaskCB *HPFRunqueueTopTaskFind(HPFRunqueue *rq, UINT32 cpuid)
 {
     LosTaskCB *newTask = NULL;
     UINT32 baseBitmap = rq->queueBitmap;
-#ifdef LOSCFG_KERNEL_SMP
-    UINT32 cpuid = ArchCurrCpuid();
+#ifndef LOSCFG_KERNEL_SMP
+    (VOID)cpuid;
 #endif
 
     while (baseBitmap) {
@@ -710,6 +769,11 @@ STATIC INLINE LosTaskCB *HPFRunqueueTopTaskGet(HPFRunqueue *rq)
     return NULL;
 }
 
+STATIC INLINE LosTaskCB *HPFRunqueueTopTaskGet(HPFRunqueue *rq)
+{
+    return HPFRunqueueTopTaskFind(rq, ArchCurrCpuid());
+}
+
 VOID EDFProcessDefaultSchedParamGet(SchedParam *param);
 VOID EDFSchedPolicyInit(SchedRunqueue *rq);
 UINT32 EDFTaskSchedParamInit(LosTaskCB *taskCB, UINT16 policy,
@@ -721,6 +785,12 @@ VOID HPFTaskSchedParamInit(LosTaskCB *taskCB, UINT16 policy,
                            const SchedParam *parentParam,
                            const LosSchedParam *param);
 VOID HPFProcessDefaultSchedParamGet(SchedParam *param);
+BOOL HPFRunqueueNeedResched(SchedRunqueue *rq, LosTaskCB *runTask, BOOL yield);
+#ifdef LOSCFG_KERNEL_SMP
+LosTaskCB *HPFRunqueuePull(SchedRunqueue *rq, const LosTaskCB *localTask);
+BOOL HPFRunqueueBalance(SchedRunqueue *rq);
+BOOL HPFRunqueueStealable(SchedRunqueue *rq);
+#endif
 
 VOID IdleTaskSchedParamInit(LosTaskCB *taskCB);
 
@@ -746,6 +816,7 @@ VOID OsSchedRunqueueInit(VOID);
  * queues it needs to be in.
  */
 VOID OsSchedResched(VOID);
+BOOL OsSchedNeedResched(SchedRunqueue *rq, LosTaskCB *runTask, BOOL yield);
 VOID OsSchedIrqEndCheckNeedSched(VOID);
 
 /*
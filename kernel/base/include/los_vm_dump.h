@@ -66,6 +66,7 @@ VOID OsDumpAspace(LosVmSpace *space);
 UINT32 OsCountRegionPages(LosVmSpace *space, LosVmMapRegion *region, UINT32 *pssPages);
 UINT32 OsCountAspacePages(LosVmSpace *space);
 VOID OsDumpAllAspace(VOID);
+UINT32 OsVmPhySegPagesGet(LosVmPhysSeg *seg);
 VOID OsVmPhysDump(VOID);
 VOID OsVmPhysUsedInfoGet(UINT32 *usedCount, UINT32 *totalCount);
 INT32 OsRegionOverlapCheck(LosVmSpace *space, LosVmMapRegion *region);
@@ -53,6 +53,7 @@ extern "C" {
 
 typedef struct FilePage {
     LOS_DL_LIST             node;
+    LosRbNode               rbNode;       /* node of the page cache index of the vnode */
     LOS_DL_LIST             lru;
     LOS_DL_LIST             i_mmap;       /* list of mappings */
     UINT32                  n_maps;       /* num of mapping */
@@ -86,6 +87,9 @@ enum OsPageFlags {
 #define MAX_SHRINK_PAGECACHE_TRY        2
 #define VM_FILEMAP_MAX_SCAN             (SYS_MEM_SIZE_DEFAULT >> PAGE_SHIFT)
 #define VM_FILEMAP_MIN_SCAN             32
+#define VM_FILEMAP_RA_MIN               4     /* readahead window once faults look sequential */
+#define VM_FILEMAP_RA_MAX               32    /* readahead window limit, in pages */
+#define VM_FAULT_AROUND_SIZE            (16 * PAGE_SIZE) /* cached pages mapped around a read fault */
 
 STATIC INLINE VOID OsSetPageLocked(LosVmPage *page)
 {
@@ -193,11 +197,17 @@ VOID OsVmmFileRegionFree(struct file *filep, LosProcessCB *processCB);
 
 LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff);
 LosFilePage *OsFindGetEntry(struct page_mapping *mapping, VM_OFFSET_T pgoff);
+VOID OsPageCacheTreeInit(LosRbTree *pageTree);
 LosMapInfo *OsGetMapInfo(const LosFilePage *page, const LosArchMmu *archMmu, VADDR_T vaddr);
 VOID OsAddMapInfo(LosFilePage *page, LosArchMmu *archMmu, VADDR_T vaddr);
 VOID OsDelMapInfo(LosVmMapRegion *region, LosVmPgFault *pgFault, BOOL cleanDirty);
 VOID OsFileCacheFlush(struct page_mapping *mapping);
+VOID OsFileCacheFlushRange(struct page_mapping *mapping, VM_OFFSET_T start, VM_OFFSET_T end);
+VOID OsVmmFileWillNeed(LosVmMapRegion *region, VM_OFFSET_T pgoff, UINT32 count);
+UINT32 OsVmmFileFaultReadCount(LosVmMapRegion *region, VM_OFFSET_T pgoff);
+VOID OsVmmFileReadAhead(struct Vnode *vnode, VM_OFFSET_T pgoff, UINT32 count);
 VOID OsFileCacheRemove(struct page_mapping *mapping);
+VOID OsFileCacheRemoveRange(struct page_mapping *mapping, VM_OFFSET_T start, VM_OFFSET_T end);
 VOID OsUnmapPageLocked(LosFilePage *page, LosMapInfo *info);
 VOID OsUnmapAllLocked(LosFilePage *page);
 VOID OsLruCacheAdd(LosFilePage *fpage, enum OsLruList lruType);
@@ -40,6 +40,7 @@
 #include "los_typedef.h"
 #include "los_arch_mmu.h"
 #include "los_mux.h"
+#include "los_rwlock.h"
 #include "los_rbtree.h"
 #include "los_vm_syscall.h"
 #include "los_vm_zone.h"
@@ -92,6 +93,7 @@ struct VmMapRegion {
     UINT32              shmid;          /**< shmid about shared region */
     UINT8               forkFlags;      /**< vm space fork flags: COPY, ZERO, */
     UINT8               regionType;     /**< vm region type: ANON, FILE, DEV */
+    UINT8               advice;         /**< madvise access pattern: NORMAL, RANDOM, SEQUENTIAL */
     union {
         struct VmRegionFile {
             int f_oflags;
@@ -112,6 +114,7 @@ typedef struct VmSpace {
     LOS_DL_LIST         node;           /**< vm space dl list */
     LosRbTree           regionRbTree;   /**< region red-black tree root */
     LosMux              regionMux;      /**< region red-black tree mutex lock */
+    LosRwlock           regionRwlock;   /**< page faults read lock, region changes write lock */
     VADDR_T             base;           /**< vm space base addr */
     UINT32              size;           /**< vm space size */
     VADDR_T             heapBase;       /**< vm space heap base address */
@@ -280,6 +283,7 @@ LosVmSpace *LOS_CurrSpaceGet(VOID);
 BOOL LOS_IsRegionFileValid(LosVmMapRegion *region);
 LosVmMapRegion *LOS_RegionRangeFind(LosVmSpace *vmSpace, VADDR_T addr, size_t len);
 LosVmMapRegion *LOS_RegionFind(LosVmSpace *vmSpace, VADDR_T addr);
+LosVmMapRegion *OsFindRegion(LosRbTree *regionRbTree, VADDR_T vaddr, size_t len);
 PADDR_T LOS_PaddrQuery(VOID *vaddr);
 LosVmMapRegion *LOS_RegionAlloc(LosVmSpace *vmSpace, VADDR_T vaddr, size_t len, UINT32 regionFlags, VM_OFFSET_T pgoff);
 STATUS_T OsRegionsRemove(LosVmSpace *space, VADDR_T vaddr, size_t size);
@@ -287,6 +291,8 @@ STATUS_T OsVmRegionAdjust(LosVmSpace *space, VADDR_T vaddr, size_t size);
 LosVmMapRegion *OsVmRegionDup(LosVmSpace *space, LosVmMapRegion *oldRegion, VADDR_T vaddr, size_t size);
 STATUS_T OsIsRegionCanExpand(LosVmSpace *space, LosVmMapRegion *region, size_t size);
 STATUS_T LOS_RegionFree(LosVmSpace *space, LosVmMapRegion *region);
+STATUS_T OsRegionPagesDrop(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr, size_t size);
+VOID OsVmRegionPopulate(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr, size_t len);
 STATUS_T LOS_VmSpaceFree(LosVmSpace *space);
 STATUS_T LOS_VaddrToPaddrMmap(LosVmSpace *space, VADDR_T vaddr, PADDR_T paddr, size_t len, UINT32 flags);
 BOOL OsUserVmSpaceInit(LosVmSpace *vmSpace, VADDR_T *virtTtb);
@@ -295,6 +301,10 @@ STATUS_T LOS_VmSpaceClone(UINT32 cloneFlags, LosVmSpace *oldVmSpace, LosVmSpace
 LosMux *OsGVmSpaceMuxGet(VOID);
 STATUS_T OsUnMMap(LosVmSpace *space, VADDR_T addr, size_t size);
 STATUS_T OsVmSpaceRegionFree(LosVmSpace *space);
+VOID OsVmSpaceWrLock(LosVmSpace *space);
+VOID OsVmSpaceWrUnlock(LosVmSpace *space);
+BOOL OsVmSpaceRdLock(LosVmSpace *space);
+VOID OsVmSpaceRdUnlock(LosVmSpace *space, BOOL shared);
 
 /**
  * thread safety
@@ -55,11 +55,27 @@ extern "C" {
 #define VM_ORDER_TO_PHYS(order)  (1 << (PAGE_SHIFT + (order)))
 #define VM_PHYS_TO_ORDER(phys)   (min(LOS_LowBitGet((phys) >> PAGE_SHIFT), VM_LIST_ORDER_MAX - 1))
 
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+#define VM_ZERO_POOL_HIGH   64  /* The idle task stops zeroing pages once the pool holds this many */
+#define VM_ZERO_POOL_LOW    256 /* The idle task does not refill the pool while fewer pages than this are free */
+#endif
+
 struct VmFreeList {
     LOS_DL_LIST node;
     UINT32 listCnt;
 };
 
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+#define VM_PCP_HIGH     64  /* Drain a per-cpu list once it holds more pages than this */
+#define VM_PCP_BATCH    16  /* Pages moved between a per-cpu list and the buddy lists at once */
+
+struct VmPcpList {
+    SPIN_LOCK_S lock;         /* Only contended when another cpu drains this list */
+    LOS_DL_LIST node;         /* Hot pages at the head, cold pages at the tail */
+    UINT32 count;
+};
+#endif
+
 enum OsLruList {
     VM_LRU_INACTIVE_ANON = 0,
     VM_LRU_ACTIVE_ANON,
@@ -76,6 +92,9 @@ typedef struct VmPhysSeg {
 
     SPIN_LOCK_S freeListLock; /* The buddy list spinlock */
     struct VmFreeList freeList[VM_LIST_ORDER_MAX];  /* The free pages in the buddy list */
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+    struct VmPcpList pcp[LOSCFG_KERNEL_CORE_NUM];   /* The free single pages kept by each cpu */
+#endif
 
     SPIN_LOCK_S lruLock;
     size_t lruSize[VM_NR_LRU_LISTS];
@@ -100,11 +119,17 @@ VOID OsVmPhysAreaSizeAdjust(size_t size);
 UINT32 OsVmPhysPageNumGet(VOID);
 LosVmPage *OsVmVaddrToPage(VOID *ptr);
 VOID OsPhysSharePageCopy(PADDR_T oldPaddr, PADDR_T *newPaddr, LosVmPage *newPage);
+VOID OsPhysSharePageDrop(LosVmPage *page);
 VOID OsVmPhysPagesFreeContiguous(LosVmPage *page, size_t nPages);
 LosVmPage *OsVmPhysToPage(paddr_t pa, UINT8 segID);
 LosVmPage *OsVmPaddrToPage(paddr_t paddr);
 
 LosVmPage *LOS_PhysPageAlloc(VOID);
+LosVmPage *LOS_PhysZeroPageAlloc(VOID);
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+BOOL OsVmZeroPoolFill(VOID);
+VOID OsVmZeroPoolInfoGet(UINT32 *count, UINT32 *hit, UINT32 *miss);
+#endif
 VOID LOS_PhysPageFree(LosVmPage *page);
 size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list);
 size_t LOS_PhysPagesFree(LOS_DL_LIST *list);
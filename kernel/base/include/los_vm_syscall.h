@@ -60,6 +60,7 @@ VADDR_T LOS_MMap(VADDR_T vaddr, size_t len, unsigned prot, unsigned long flags,
 STATUS_T LOS_UnMMap(VADDR_T addr, size_t size);
 VOID *LOS_DoBrk(VOID *addr);
 INT32 LOS_DoMprotect(VADDR_T vaddr, size_t len, unsigned long prot);
+INT32 LOS_DoMadvise(VADDR_T vaddr, size_t len, INT32 advice);
 VADDR_T LOS_DoMremap(VADDR_T oldAddress, size_t oldSize, size_t newSize, int flags, VADDR_T newAddr);
 VOID LOS_DumpMemRegion(VADDR_T vaddr);
 UINT32 ShmInit(VOID);
@@ -235,7 +235,6 @@ LITE_OS_SEC_TEXT STATIC UINT32 OsEventWrite(PEVENT_CB_S eventCB, UINT32 events,
     SCHEDULER_UNLOCK(intSave);
 
     if (exitFlag == 1) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
         LOS_Schedule();
     }
     return LOS_OK;
@@ -48,22 +48,27 @@
 #define OS_FUTEX_KEY_BASE USER_ASPACE_BASE
 #define OS_FUTEX_KEY_MAX (USER_ASPACE_BASE + USER_ASPACE_SIZE)
 
-/* private: 0~63    hash index_num
- * shared:  64~79   hash index_num */
-#define FUTEX_INDEX_PRIVATE_MAX     64
-#define FUTEX_INDEX_SHARED_MAX      16
-#define FUTEX_INDEX_MAX             (FUTEX_INDEX_PRIVATE_MAX + FUTEX_INDEX_SHARED_MAX)
-
-#define FUTEX_INDEX_SHARED_POS      FUTEX_INDEX_PRIVATE_MAX
-#define FUTEX_HASH_PRIVATE_MASK     (FUTEX_INDEX_PRIVATE_MAX - 1)
-#define FUTEX_HASH_SHARED_MASK      (FUTEX_INDEX_SHARED_MAX - 1)
+/* The hash table is sized at boot from the task limit, private buckets first, then shared ones:
+ * private: 0 ~ g_futexPrivateNum - 1                          hash index_num
+ * shared:  g_futexPrivateNum ~ g_futexPrivateNum + g_futexSharedNum - 1    hash index_num */
+#define FUTEX_INDEX_PRIVATE_MIN     64
+#define FUTEX_INDEX_SHARED_MIN      16
+#define FUTEX_INDEX_SHARED_RATIO    4
+#define FUTEX_INDEX_MAX             (g_futexPrivateNum + g_futexSharedNum)
+
+#define FUTEX_INDEX_SHARED_POS      g_futexPrivateNum
+#define FUTEX_HASH_PRIVATE_MASK     (g_futexPrivateNum - 1)
+#define FUTEX_HASH_SHARED_MASK      (g_futexSharedNum - 1)
 
 typedef struct {
     LosMux      listLock;
     LOS_DL_LIST lockList;
+    Atomic      waitPending;    /* waiters checking the futex value and not yet in lockList */
 } FutexHash;
 
-FutexHash g_futexHash[FUTEX_INDEX_MAX];
+STATIC UINT32 g_futexPrivateNum;
+STATIC UINT32 g_futexSharedNum;
+FutexHash *g_futexHash = NULL;
 
 STATIC INT32 OsFutexLock(LosMux *lock)
 {
@@ -85,13 +90,33 @@ STATIC INT32 OsFutexUnlock(LosMux *lock)
     return LOS_OK;
 }
 
+STATIC UINT32 OsFutexHashSizeGet(UINT32 minNum, UINT32 wantNum)
+{
+    UINT32 num = minNum;
+
+    while (num < wantNum) {
+        num <<= 1;
+    }
+    return num;
+}
+
 UINT32 OsFutexInit(VOID)
 {
-    INT32 count;
+    UINT32 count;
     UINT32 ret;
 
+    /* about two private buckets per task, the keys of different processes are spread by pid */
+    g_futexPrivateNum = OsFutexHashSizeGet(FUTEX_INDEX_PRIVATE_MIN, LOSCFG_BASE_CORE_TSK_LIMIT << 1);
+    g_futexSharedNum = OsFutexHashSizeGet(FUTEX_INDEX_SHARED_MIN, g_futexPrivateNum / FUTEX_INDEX_SHARED_RATIO);
+
+    g_futexHash = (FutexHash *)LOS_MemAlloc(m_aucSysMem0, sizeof(FutexHash) * FUTEX_INDEX_MAX);
+    if (g_futexHash == NULL) {
+        return LOS_NOK;
+    }
+
     for (count = 0; count < FUTEX_INDEX_MAX; count++) {
         LOS_ListInit(&g_futexHash[count].lockList);
+        LOS_AtomicSet(&g_futexHash[count].waitPending, 0);
         ret = LOS_MuxInit(&(g_futexHash[count].listLock), NULL);
         if (ret) {
             return ret;
@@ -134,16 +159,16 @@ STATIC VOID OsFutexShowTaskNodeAttr(const LOS_DL_LIST *futexList)
 VOID OsFutexHashShow(VOID)
 {
     LOS_DL_LIST *futexList = NULL;
-    INT32 count;
+    UINT32 count;
     /* The maximum number of barrels of a hash table */
-    INT32 hashNodeMax = FUTEX_INDEX_MAX;
+    UINT32 hashNodeMax = FUTEX_INDEX_MAX;
     PRINTK("#################### los_futex_pri.hash ####################\n");
     for (count = 0; count < hashNodeMax; count++) {
         futexList = &(g_futexHash[count].lockList);
         if (LOS_ListEmpty(futexList)) {
             continue;
         }
-        PRINTK("hash -> index : %d\n", count);
+        PRINTK("hash -> index : %u\n", count);
         for (futexList = futexList->pstNext;
              futexList != &(g_futexHash[count].lockList);
              futexList = futexList->pstNext) {
@@ -166,11 +191,13 @@ STATIC INLINE UINTPTR OsFutexFlagsToKey(const UINT32 *userVaddr, const UINT32 fl
     return futexKey;
 }
 
-STATIC INLINE UINT32 OsFutexKeyToIndex(const UINTPTR futexKey, const UINT32 flags)
+STATIC INLINE UINT32 OsFutexKeyToIndex(const UINTPTR futexKey, const UINT32 flags, const UINT32 pid)
 {
     UINT32 index = LOS_HashFNV32aBuf(&futexKey, sizeof(UINTPTR), FNV1_32A_INIT);
 
     if (flags & FUTEX_PRIVATE) {
+        /* the same user address is used by many processes, as they share the libc layout */
+        index = LOS_HashFNV32aBuf(&pid, sizeof(UINT32), index);
         index &= FUTEX_HASH_PRIVATE_MASK;
     } else {
         index &= FUTEX_HASH_SHARED_MASK;
@@ -180,11 +207,16 @@ STATIC INLINE UINT32 OsFutexKeyToIndex(const UINTPTR futexKey, const UINT32 flag
     return index;
 }
 
+STATIC INLINE UINT32 OsFutexPidGet(const UINT32 flags)
+{
+    return (flags & FUTEX_PRIVATE) ? LOS_GetCurrProcessID() : OS_INVALID;
+}
+
 STATIC INLINE VOID OsFutexSetKey(UINTPTR futexKey, UINT32 flags, FutexNode *node)
 {
     node->key = futexKey;
-    node->index = OsFutexKeyToIndex(futexKey, flags);
-    node->pid = (flags & FUTEX_PRIVATE) ? LOS_GetCurrProcessID() : OS_INVALID;
+    node->pid = OsFutexPidGet(flags);
+    node->index = OsFutexKeyToIndex(futexKey, flags, node->pid);
 }
 
 STATIC INLINE VOID OsFutexDeinitFutexNode(FutexNode *node)
@@ -247,7 +279,7 @@ VOID OsFutexNodeDeleteFromFutexHash(FutexNode *node, BOOL isDeleteHead, FutexNod
 {
     FutexHash *hashNode = NULL;
 
-    UINT32 index = OsFutexKeyToIndex(node->key, (node->pid == OS_INVALID) ? 0 : FUTEX_PRIVATE);
+    UINT32 index = OsFutexKeyToIndex(node->key, (node->pid == OS_INVALID) ? 0 : FUTEX_PRIVATE, node->pid);
     if (index >= FUTEX_INDEX_MAX) {
         return;
     }
@@ -573,13 +605,20 @@ STATIC INT32 OsFutexWaitTask(const UINT32 *userVaddr, const UINT32 flags, const
     LosTaskCB *taskCB = NULL;
     FutexNode *node = NULL;
     UINTPTR futexKey = OsFutexFlagsToKey(userVaddr, flags);
-    UINT32 index = OsFutexKeyToIndex(futexKey, flags);
+    UINT32 index = OsFutexKeyToIndex(futexKey, flags, OsFutexPidGet(flags));
     FutexHash *hashNode = &g_futexHash[index];
 
     if (OsFutexLock(&hashNode->listLock)) {
         return LOS_EINVAL;
     }
 
+    /*
+     * Announce the waiter before reading the futex value, so a waker that changed the value
+     * and finds neither a pending waiter nor a node in lockList knows nobody can miss it.
+     */
+    LOS_AtomicInc(&hashNode->waitPending);
+    DMB;
+
     if (LOS_ArchCopyFromUser(&lockVal, userVaddr, sizeof(UINT32))) {
         PRINT_ERR("Futex wait param check failed! copy from user failed!\n");
         futexRet = LOS_EINVAL;
@@ -595,6 +634,8 @@ STATIC INT32 OsFutexWaitTask(const UINT32 *userVaddr, const UINT32 flags, const
         futexRet = LOS_NOK;
         goto EXIT_ERR;
     }
+    DMB;
+    LOS_AtomicDec(&hashNode->waitPending);
 
     SCHEDULER_LOCK(intSave);
     OsSchedLock();
@@ -628,6 +669,7 @@ STATIC INT32 OsFutexWaitTask(const UINT32 *userVaddr, const UINT32 flags, const
     return LOS_OK;
 
 EXIT_ERR:
+    LOS_AtomicDec(&hashNode->waitPending);
     (VOID)OsFutexUnlock(&hashNode->listLock);
 EXIT_UNLOCK_ERR:
     return futexRet;
@@ -713,12 +755,13 @@ STATIC INT32 OsFutexWakeTask(UINTPTR futexKey, UINT32 flags, INT32 wakeNumber, F
     UINT32 intSave;
     FutexNode *node = NULL;
     FutexNode *headNode = NULL;
-    UINT32 index = OsFutexKeyToIndex(futexKey, flags);
+    UINT32 pid = OsFutexPidGet(flags);
+    UINT32 index = OsFutexKeyToIndex(futexKey, flags, pid);
     FutexHash *hashNode = &g_futexHash[index];
     FutexNode tempNode = {
         .key = futexKey,
         .index = index,
-        .pid = (flags & FUTEX_PRIVATE) ? LOS_GetCurrProcessID() : OS_INVALID,
+        .pid = pid,
     };
 
     node = OsFindFutexNode(&tempNode);
@@ -756,9 +799,18 @@ INT32 OsFutexWake(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber)
     }
 
     futexKey = OsFutexFlagsToKey(userVaddr, flags);
-    index = OsFutexKeyToIndex(futexKey, flags);
+    index = OsFutexKeyToIndex(futexKey, flags, OsFutexPidGet(flags));
 
     hashNode = &g_futexHash[index];
+    /* uncontended wake: nobody is waiting or about to wait in the bucket, don't take the lock */
+    DMB;
+    if (LOS_AtomicRead(&hashNode->waitPending) == 0) {
+        DMB;
+        if (LOS_ListEmpty(&hashNode->lockList)) {
+            return LOS_EBADF;
+        }
+    }
+
     if (OsFutexLock(&hashNode->listLock)) {
         return LOS_EINVAL;
     }
@@ -778,7 +830,6 @@ INT32 OsFutexWake(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber)
     }
 
     if (wakeAny == TRUE) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
         LOS_Schedule();
     }
 
@@ -803,7 +854,7 @@ STATIC INT32 OsFutexRequeueInsertNewKey(UINTPTR newFutexKey, INT32 newIndex, Fut
     FutexNode newTempNode = {
         .key = newFutexKey,
         .index = newIndex,
-        .pid = (newIndex < FUTEX_INDEX_SHARED_POS) ? LOS_GetCurrProcessID() : OS_INVALID,
+        .pid = ((UINT32)newIndex < FUTEX_INDEX_SHARED_POS) ? LOS_GetCurrProcessID() : OS_INVALID,
     };
     LOS_DL_LIST *queueList = &oldHeadNode->queueList;
     FutexNode *newHeadNode = OsFindFutexNode(&newTempNode);
@@ -852,7 +903,7 @@ STATIC VOID OsFutexRequeueSplitTwoLists(FutexHash *oldHashNode, FutexNode *oldHe
 {
     LOS_DL_LIST *queueList = &oldHeadNode->queueList;
     FutexNode *tailNode = OS_FUTEX_FROM_QUEUELIST(LOS_DL_LIST_LAST(queueList));
-    INT32 newIndex = OsFutexKeyToIndex(futexKey, flags);
+    INT32 newIndex = OsFutexKeyToIndex(futexKey, flags, OsFutexPidGet(flags));
     FutexNode *nextNode = NULL;
     FutexNode *newHeadNode = NULL;
     LOS_DL_LIST *futexList = NULL;
@@ -890,13 +941,14 @@ STATIC FutexNode *OsFutexRequeueRemoveOldKeyAndGetHead(UINTPTR oldFutexKey, UINT
                                                        UINTPTR newFutexKey, INT32 requeueCount, BOOL *wakeAny)
 {
     INT32 ret;
-    INT32 oldIndex = OsFutexKeyToIndex(oldFutexKey, flags);
+    UINT32 pid = OsFutexPidGet(flags);
+    INT32 oldIndex = OsFutexKeyToIndex(oldFutexKey, flags, pid);
     FutexNode *oldHeadNode = NULL;
     FutexHash *oldHashNode = &g_futexHash[oldIndex];
     FutexNode oldTempNode = {
         .key = oldFutexKey,
         .index = oldIndex,
-        .pid = (flags & FUTEX_PRIVATE) ? LOS_GetCurrProcessID() : OS_INVALID,
+        .pid = pid,
     };
 
     if (wakeNumber > 0) {
@@ -967,8 +1019,8 @@ INT32 OsFutexRequeue(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, IN
 
     oldFutexKey = OsFutexFlagsToKey(userVaddr, flags);
     newFutexKey = OsFutexFlagsToKey(newUserVaddr, flags);
-    oldIndex = OsFutexKeyToIndex(oldFutexKey, flags);
-    newIndex = OsFutexKeyToIndex(newFutexKey, flags);
+    oldIndex = OsFutexKeyToIndex(oldFutexKey, flags, OsFutexPidGet(flags));
+    newIndex = OsFutexKeyToIndex(newFutexKey, flags, OsFutexPidGet(flags));
 
     oldHashNode = &g_futexHash[oldIndex];
     if (OsFutexLock(&oldHashNode->listLock)) {
@@ -1004,7 +1056,6 @@ INT32 OsFutexRequeue(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, IN
 
 EXIT:
     if (wakeAny == TRUE) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
         LOS_Schedule();
     }
 
@@ -519,7 +519,6 @@ LITE_OS_SEC_TEXT UINT32 LOS_MuxUnlock(LosMux *mutex)
     ret = OsMuxUnlockUnsafe(runTask, mutex, &needSched);
     SCHEDULER_UNLOCK(intSave);
     if (needSched == TRUE) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
         LOS_Schedule();
     }
     return ret;
@@ -37,6 +37,7 @@
 #include "los_mp.h"
 #include "los_percpu_pri.h"
 #include "los_hook.h"
+#include "los_bitmap.h"
 #ifdef LOSCFG_IPC_CONTAINER
 #include "los_ipc_container_pri.h"
 #endif
@@ -106,9 +107,11 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
     LOS_DL_LIST *unusedQueue = NULL;
     UINT8 *queue = NULL;
     UINT16 msgSize;
+    UINT32 nodeSize;
+    UINT32 prioSize;
+    UINT16 index;
 
     (VOID)queueName;
-    (VOID)flags;
 
     if (queueID == NULL) {
         return LOS_ERRNO_QUEUE_CREAT_PTR_NULL;
@@ -122,12 +125,21 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
         return LOS_ERRNO_QUEUE_PARA_ISZERO;
     }
 
+    if ((flags & LOS_QUEUE_SPSC) && (flags & LOS_QUEUE_PRIO)) {
+        return LOS_ERRNO_QUEUE_OPERATE_INVALID;
+    }
+
     msgSize = maxMsgSize + sizeof(UINT32);
+    nodeSize = ALIGN((UINT32)len * msgSize, sizeof(UINT16));
+    prioSize = (flags & LOS_QUEUE_PRIO) ? (LOS_QUEUE_PRIO_NUM * sizeof(UINT16) * OS_QUEUE_N_RW) : 0;
     /*
      * Memory allocation is time-consuming, to shorten the time of disable interrupt,
      * move the memory allocation to here.
+     * The nodes are followed by the position to node map, the stack of free nodes,
+     * for LOS_QUEUE_PRIO the first and last node of each priority, and the reserved flag of each node.
      */
-    queue = (UINT8 *)LOS_MemAlloc(m_aucSysMem1, (UINT32)len * msgSize);
+    queue = (UINT8 *)LOS_MemAlloc(m_aucSysMem1, nodeSize + ((UINT32)len * sizeof(UINT16) * OS_QUEUE_N_RW) +
+                                  prioSize + len);
     if (queue == NULL) {
         return LOS_ERRNO_QUEUE_CREATE_NO_MEMORY;
     }
@@ -151,6 +163,23 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
     queueCB->readWriteableCnt[OS_QUEUE_WRITE] = len;
     queueCB->queueHead = 0;
     queueCB->queueTail = 0;
+    queueCB->queueSlot = (UINT16 *)(queue + nodeSize);
+    queueCB->queueFree = queueCB->queueSlot + len;
+    for (index = 0; index < len; index++) {
+        queueCB->queueFree[index] = len - index - 1;
+    }
+    queueCB->queueFreeTop = len;
+    queueCB->queuePublish = 0;
+    queueCB->queuePending = 0;
+    queueCB->queueFlags = (UINT16)(flags & (LOS_QUEUE_SPSC | LOS_QUEUE_PRIO));
+    queueCB->queuePrioBitmap = 0;
+    queueCB->queuePrioList = (flags & LOS_QUEUE_PRIO) ? (queueCB->queueFree + len) : NULL;
+    queueCB->queueReserved = (UINT8 *)(queueCB->queueFree + len) + prioSize;
+    (VOID)memset_s(queueCB->queueReserved, len, 0, len);
+    LOS_AtomicSet(&queueCB->queueCount, 0);
+    LOS_AtomicSet(&queueCB->queueWaiting[OS_QUEUE_READ], 0);
+    LOS_AtomicSet(&queueCB->queueWaiting[OS_QUEUE_WRITE], 0);
+    LOS_AtomicSet(&queueCB->queueBusy, 0);
     LOS_ListInit(&queueCB->readWriteList[OS_QUEUE_READ]);
     LOS_ListInit(&queueCB->readWriteList[OS_QUEUE_WRITE]);
     LOS_ListInit(&queueCB->memList);
@@ -212,59 +241,79 @@ STATIC LITE_OS_SEC_TEXT UINT32 OsQueueWriteParameterCheck(UINT32 queueID, const
     return LOS_OK;
 }
 
-STATIC VOID OsQueueBufferOperate(LosQueueCB *queueCB, UINT32 operateType, VOID *bufferAddr, UINT32 *bufferSize)
+/*
+ * Messages up to this size are copied inside the critical section: for them, taking the
+ * scheduler lock a second time costs more than the copy.
+ */
+#define OS_QUEUE_COPY_IN_LOCK_SIZE  64
+
+#define OS_QUEUE_NODE(queueCB, buffer)  (&((queueCB)->queueHandle[(UINT32)(buffer) * (queueCB)->queueSize]))
+
+STATIC INLINE UINT16 OsQueuePosNext(const LosQueueCB *queueCB, UINT16 pos)
+{
+    return ((pos + 1) == queueCB->queueLen) ? 0 : (pos + 1);
+}
+
+STATIC INLINE UINT16 OsQueuePosPrev(const LosQueueCB *queueCB, UINT16 pos)
+{
+    return (pos == 0) ? (queueCB->queueLen - 1) : (pos - 1);
+}
+
+STATIC UINT32 OsQueueNodeMsgSize(const LosQueueCB *queueCB, const UINT8 *queueNode)
 {
-    UINT8 *queueNode = NULL;
     UINT32 msgDataSize;
-    UINT16 queuePosition;
 
-    /* get the queue position */
-    switch (OS_QUEUE_OPERATE_GET(operateType)) {
-        case OS_QUEUE_READ_HEAD:
-            queuePosition = queueCB->queueHead;
-            ((queueCB->queueHead + 1) == queueCB->queueLen) ? (queueCB->queueHead = 0) : (queueCB->queueHead++);
-            break;
-        case OS_QUEUE_WRITE_HEAD:
-            (queueCB->queueHead == 0) ? (queueCB->queueHead = queueCB->queueLen - 1) : (--queueCB->queueHead);
-            queuePosition = queueCB->queueHead;
-            break;
-        case OS_QUEUE_WRITE_TAIL:
-            queuePosition = queueCB->queueTail;
-            ((queueCB->queueTail + 1) == queueCB->queueLen) ? (queueCB->queueTail = 0) : (queueCB->queueTail++);
-            break;
-        default:  /* read tail, reserved. */
-            PRINT_ERR("invalid queue operate type!\n");
-            return;
+    if (memcpy_s(&msgDataSize, sizeof(UINT32), queueNode + queueCB->queueSize - sizeof(UINT32),
+        sizeof(UINT32)) != EOK) {
+        PRINT_ERR("get msgdatasize failed\n");
+        return 0;
     }
+    return msgDataSize;
+}
 
-    queueNode = &(queueCB->queueHandle[(queuePosition * (queueCB->queueSize))]);
+STATIC VOID OsQueueNodeCopyOut(const LosQueueCB *queueCB, const UINT8 *queueNode, VOID *bufferAddr,
+                               UINT32 *bufferSize)
+{
+    UINT32 msgDataSize = OsQueueNodeMsgSize(queueCB, queueNode);
 
-    if (OS_QUEUE_IS_READ(operateType)) {
-        if (memcpy_s(&msgDataSize, sizeof(UINT32), queueNode + queueCB->queueSize - sizeof(UINT32),
-            sizeof(UINT32)) != EOK) {
-            PRINT_ERR("get msgdatasize failed\n");
-            return;
-        }
-        msgDataSize = (*bufferSize < msgDataSize) ? *bufferSize : msgDataSize;
-        if (memcpy_s(bufferAddr, *bufferSize, queueNode, msgDataSize) != EOK) {
-            PRINT_ERR("copy message to buffer failed\n");
-            return;
-        }
+    msgDataSize = (*bufferSize < msgDataSize) ? *bufferSize : msgDataSize;
+    if (memcpy_s(bufferAddr, *bufferSize, queueNode, msgDataSize) != EOK) {
+        PRINT_ERR("copy message to buffer failed\n");
+        return;
+    }
 
-        *bufferSize = msgDataSize;
-    } else {
-        if (memcpy_s(queueNode, queueCB->queueSize, bufferAddr, *bufferSize) != EOK) {
-            PRINT_ERR("store message failed\n");
-            return;
-        }
-        if (memcpy_s(queueNode + queueCB->queueSize - sizeof(UINT32), sizeof(UINT32), bufferSize,
-            sizeof(UINT32)) != EOK) {
-            PRINT_ERR("store message size failed\n");
-            return;
-        }
+    *bufferSize = msgDataSize;
+}
+
+/* bufferAddr is NULL when the message has been built in place in a reserved node */
+STATIC VOID OsQueueNodeCopyIn(const LosQueueCB *queueCB, UINT8 *queueNode, const VOID *bufferAddr,
+                              const UINT32 *bufferSize)
+{
+    if ((bufferAddr != NULL) && (memcpy_s(queueNode, queueCB->queueSize, bufferAddr, *bufferSize) != EOK)) {
+        PRINT_ERR("store message failed\n");
+        return;
+    }
+    if (memcpy_s(queueNode + queueCB->queueSize - sizeof(UINT32), sizeof(UINT32), bufferSize,
+        sizeof(UINT32)) != EOK) {
+        PRINT_ERR("store message size failed\n");
+        return;
     }
 }
 
+/* One node became available to the other side: hand it to a waiting task, or count it. */
+STATIC BOOL OsQueueHandOver(LosQueueCB *queueCB, UINT32 readWrite)
+{
+    if (!LOS_ListEmpty(&queueCB->readWriteList[readWrite])) {
+        LosTaskCB *resumedTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&queueCB->readWriteList[readWrite]));
+        OsTaskWakeClearPendMask(resumedTask);
+        resumedTask->ops->wake(resumedTask);
+        return TRUE;
+    }
+
+    queueCB->readWriteableCnt[readWrite]++;
+    return FALSE;
+}
+
 STATIC UINT32 OsQueueOperateParamCheck(const LosQueueCB *queueCB, UINT32 queueID,
                                        UINT32 operateType, const UINT32 *bufferSize)
 {
@@ -275,58 +324,362 @@ STATIC UINT32 OsQueueOperateParamCheck(const LosQueueCB *queueCB, UINT32 queueID
     if (OS_QUEUE_IS_WRITE(operateType) && (*bufferSize > (queueCB->queueSize - sizeof(UINT32)))) {
         return LOS_ERRNO_QUEUE_WRITE_SIZE_TOO_BIG;
     }
+
+    if ((queueCB->queueFlags & (LOS_QUEUE_SPSC | LOS_QUEUE_PRIO)) &&
+        (OS_QUEUE_OPERATE_GET(operateType) == OS_QUEUE_WRITE_HEAD)) {
+        return LOS_ERRNO_QUEUE_OPERATE_INVALID;
+    }
     return LOS_OK;
 }
 
-UINT32 OsQueueOperate(UINT32 queueID, UINT32 operateType, VOID *bufferAddr, UINT32 *bufferSize, UINT32 timeout)
+/* Take one node for reading or writing, waiting for it if needed. Called and returns with the lock held. */
+STATIC UINT32 OsQueueNodeWait(LosQueueCB *queueCB, UINT32 readWrite, UINT32 timeout)
 {
     UINT32 ret;
-    UINT32 readWrite = OS_QUEUE_READ_WRITE_GET(operateType);
-    UINT32 intSave;
-    OsHookCall(LOS_HOOK_TYPE_QUEUE_READ, (LosQueueCB *)GET_QUEUE_HANDLE(queueID), operateType, *bufferSize, timeout);
 
-    SCHEDULER_LOCK(intSave);
-    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
-    ret = OsQueueOperateParamCheck(queueCB, queueID, operateType, bufferSize);
-    if (ret != LOS_OK) {
-        goto QUEUE_END;
+    if (queueCB->readWriteableCnt[readWrite] != 0) {
+        queueCB->readWriteableCnt[readWrite]--;
+        return LOS_OK;
+    }
+
+    if (timeout == LOS_NO_WAIT) {
+        return (readWrite == OS_QUEUE_READ) ? LOS_ERRNO_QUEUE_ISEMPTY : LOS_ERRNO_QUEUE_ISFULL;
+    }
+
+    if (!OsPreemptableInSched()) {
+        return LOS_ERRNO_QUEUE_PEND_IN_LOCK;
+    }
+
+    /* the task that wakes us hands its node over without counting it */
+    LosTaskCB *runTask = OsCurrTaskGet();
+    OsTaskWaitSetPendMask(OS_TASK_WAIT_QUEUE, queueCB->queueID, timeout);
+    ret = runTask->ops->wait(runTask, &queueCB->readWriteList[readWrite], timeout);
+    if (ret == LOS_ERRNO_TSK_TIMEOUT) {
+        return LOS_ERRNO_QUEUE_TIMEOUT;
+    }
+    return LOS_OK;
+}
+
+/*
+ * LOS_QUEUE_PRIO queues keep one list of nodes per priority, linked through queueSlot, and a bitmap of
+ * the priorities that have messages: a message is appended to the list of its priority and the reader
+ * takes the first node of the highest priority set in the bitmap.
+ */
+#define OS_QUEUE_PRIO_FIRST(queueCB, prio)  ((queueCB)->queuePrioList[(prio)])
+#define OS_QUEUE_PRIO_LAST(queueCB, prio)   ((queueCB)->queuePrioList[LOS_QUEUE_PRIO_NUM + (prio)])
+
+STATIC VOID OsQueuePrioEnqueue(LosQueueCB *queueCB, UINT16 buffer, UINT32 prio)
+{
+    if (queueCB->queuePrioBitmap & (1U << prio)) {
+        queueCB->queueSlot[OS_QUEUE_PRIO_LAST(queueCB, prio)] = buffer;
+    } else {
+        OS_QUEUE_PRIO_FIRST(queueCB, prio) = buffer;
+        queueCB->queuePrioBitmap |= 1U << prio;
+    }
+    OS_QUEUE_PRIO_LAST(queueCB, prio) = buffer;
+}
+
+STATIC UINT16 OsQueuePrioDequeue(LosQueueCB *queueCB, UINT32 *prio)
+{
+    UINT32 highest = LOS_HighBitGet(queueCB->queuePrioBitmap);
+    UINT16 buffer = OS_QUEUE_PRIO_FIRST(queueCB, highest);
+
+    if (buffer == OS_QUEUE_PRIO_LAST(queueCB, highest)) {
+        queueCB->queuePrioBitmap &= ~(1U << highest);
+    } else {
+        OS_QUEUE_PRIO_FIRST(queueCB, highest) = queueCB->queueSlot[buffer];
+    }
+    *prio = highest;
+    return buffer;
+}
+
+/*
+ * Writers reserve a position at the tail and a free buffer, fill the buffer without the lock and then
+ * publish it. Publishing swaps the buffer into the oldest reserved position, so a writer that is slow
+ * to copy never holds back the ones that finish after it. A LOS_QUEUE_PRIO queue has no positions: the
+ * buffer joins the list of its priority when it is published.
+ */
+STATIC UINT16 OsQueueWriteReserve(LosQueueCB *queueCB)
+{
+    UINT16 buffer = queueCB->queueFree[--queueCB->queueFreeTop];
+
+    if (queueCB->queueFlags & LOS_QUEUE_PRIO) {
+        return buffer;
+    }
+
+    queueCB->queueSlot[queueCB->queueTail] = buffer;
+    queueCB->queueTail = OsQueuePosNext(queueCB, queueCB->queueTail);
+    queueCB->queuePending++;
+    return buffer;
+}
+
+STATIC BOOL OsQueueWritePublish(LosQueueCB *queueCB, UINT16 buffer, UINT32 prio)
+{
+    UINT16 pos = queueCB->queuePublish;
+    UINT16 count;
+
+    if (queueCB->queueFlags & LOS_QUEUE_PRIO) {
+        OsQueuePrioEnqueue(queueCB, buffer, prio);
+        return OsQueueHandOver(queueCB, OS_QUEUE_READ);
+    }
+
+    for (count = 0; count < queueCB->queuePending; count++) {
+        if (queueCB->queueSlot[pos] == buffer) {
+            break;
+        }
+        pos = OsQueuePosNext(queueCB, pos);
+    }
+    LOS_ASSERT(count < queueCB->queuePending);
+
+    queueCB->queueSlot[pos] = queueCB->queueSlot[queueCB->queuePublish];
+    queueCB->queueSlot[queueCB->queuePublish] = buffer;
+    queueCB->queuePublish = OsQueuePosNext(queueCB, queueCB->queuePublish);
+    queueCB->queuePending--;
+    return OsQueueHandOver(queueCB, OS_QUEUE_READ);
+}
+
+/* a message written to the head is always copied in the critical section and published at once */
+STATIC UINT16 OsQueueWriteHeadReserve(LosQueueCB *queueCB)
+{
+    UINT16 buffer = queueCB->queueFree[--queueCB->queueFreeTop];
+
+    queueCB->queueHead = OsQueuePosPrev(queueCB, queueCB->queueHead);
+    queueCB->queueSlot[queueCB->queueHead] = buffer;
+    return buffer;
+}
+
+STATIC UINT16 OsQueueReadReserve(LosQueueCB *queueCB, UINT32 *prio)
+{
+    UINT16 buffer;
+
+    if (queueCB->queueFlags & LOS_QUEUE_PRIO) {
+        return OsQueuePrioDequeue(queueCB, prio);
+    }
+
+    *prio = 0;
+    buffer = queueCB->queueSlot[queueCB->queueHead];
+    queueCB->queueHead = OsQueuePosNext(queueCB, queueCB->queueHead);
+    return buffer;
+}
+
+STATIC BOOL OsQueueReadRelease(LosQueueCB *queueCB, UINT16 buffer)
+{
+    queueCB->queueFree[queueCB->queueFreeTop++] = buffer;
+    return OsQueueHandOver(queueCB, OS_QUEUE_WRITE);
+}
+
+STATIC BOOL OsQueueReadOperate(LosQueueCB *queueCB, VOID *bufferAddr, UINT32 *bufferSize, UINT32 *prio,
+                               UINT32 *intSave)
+{
+    UINT16 buffer = OsQueueReadReserve(queueCB, prio);
+    UINT8 *queueNode = OS_QUEUE_NODE(queueCB, buffer);
+
+    if (OsQueueNodeMsgSize(queueCB, queueNode) > OS_QUEUE_COPY_IN_LOCK_SIZE) {
+        SCHEDULER_UNLOCK(*intSave);
+        OsQueueNodeCopyOut(queueCB, queueNode, bufferAddr, bufferSize);
+        SCHEDULER_LOCK(*intSave);
+    } else {
+        OsQueueNodeCopyOut(queueCB, queueNode, bufferAddr, bufferSize);
+    }
+    return OsQueueReadRelease(queueCB, buffer);
+}
+
+STATIC BOOL OsQueueWriteOperate(LosQueueCB *queueCB, UINT32 operateType, const VOID *bufferAddr,
+                                const UINT32 *bufferSize, UINT32 prio, UINT32 *intSave)
+{
+    UINT16 buffer;
+    UINT8 *queueNode = NULL;
+
+    if (OS_QUEUE_OPERATE_GET(operateType) == OS_QUEUE_WRITE_HEAD) {
+        buffer = OsQueueWriteHeadReserve(queueCB);
+        OsQueueNodeCopyIn(queueCB, OS_QUEUE_NODE(queueCB, buffer), bufferAddr, bufferSize);
+        return OsQueueHandOver(queueCB, OS_QUEUE_READ);
     }
 
-    if (queueCB->readWriteableCnt[readWrite] == 0) {
+    buffer = OsQueueWriteReserve(queueCB);
+    queueNode = OS_QUEUE_NODE(queueCB, buffer);
+    if (*bufferSize > OS_QUEUE_COPY_IN_LOCK_SIZE) {
+        SCHEDULER_UNLOCK(*intSave);
+        OsQueueNodeCopyIn(queueCB, queueNode, bufferAddr, bufferSize);
+        SCHEDULER_LOCK(*intSave);
+    } else {
+        OsQueueNodeCopyIn(queueCB, queueNode, bufferAddr, bufferSize);
+    }
+    return OsQueueWritePublish(queueCB, buffer, prio);
+}
+
+/*
+ * Single producer, single consumer queues: the writer owns queueTail, the reader owns queueHead and
+ * queueCount says how many nodes are filled. Neither side takes the lock unless it has to wait or the
+ * other side is waiting.
+ */
+STATIC UINT32 OsQueueSpscWait(LosQueueCB *queueCB, UINT32 readWrite, UINT32 timeout)
+{
+    UINT64 start = LOS_TickCountGet();
+    UINT32 remain = timeout;
+    UINT32 ret;
+    UINT32 intSave;
+
+    while (1) {
+        INT32 count = LOS_AtomicRead(&queueCB->queueCount);
+        if ((readWrite == OS_QUEUE_READ) ? (count != 0) : (count != queueCB->queueLen)) {
+            DMB;
+            return LOS_OK;
+        }
+
         if (timeout == LOS_NO_WAIT) {
-            ret = OS_QUEUE_IS_READ(operateType) ? LOS_ERRNO_QUEUE_ISEMPTY : LOS_ERRNO_QUEUE_ISFULL;
-            goto QUEUE_END;
+            return (readWrite == OS_QUEUE_READ) ? LOS_ERRNO_QUEUE_ISEMPTY : LOS_ERRNO_QUEUE_ISFULL;
+        }
+
+        /* a wake up may be taken by a recheck that fails again: only wait for what is left of timeout */
+        if (timeout != LOS_WAIT_FOREVER) {
+            UINT64 elapsed = LOS_TickCountGet() - start;
+            if (elapsed >= timeout) {
+                return LOS_ERRNO_QUEUE_TIMEOUT;
+            }
+            remain = timeout - (UINT32)elapsed;
+        }
+
+        SCHEDULER_LOCK(intSave);
+        LOS_AtomicSet(&queueCB->queueWaiting[readWrite], 1);
+        DMB;
+        count = LOS_AtomicRead(&queueCB->queueCount);
+        if ((readWrite == OS_QUEUE_READ) ? (count != 0) : (count != queueCB->queueLen)) {
+            LOS_AtomicSet(&queueCB->queueWaiting[readWrite], 0);
+            SCHEDULER_UNLOCK(intSave);
+            continue;
         }
 
         if (!OsPreemptableInSched()) {
-            ret = LOS_ERRNO_QUEUE_PEND_IN_LOCK;
-            goto QUEUE_END;
+            LOS_AtomicSet(&queueCB->queueWaiting[readWrite], 0);
+            SCHEDULER_UNLOCK(intSave);
+            return LOS_ERRNO_QUEUE_PEND_IN_LOCK;
         }
 
         LosTaskCB *runTask = OsCurrTaskGet();
-        OsTaskWaitSetPendMask(OS_TASK_WAIT_QUEUE, queueCB->queueID, timeout);
-        ret = runTask->ops->wait(runTask, &queueCB->readWriteList[readWrite], timeout);
+        OsTaskWaitSetPendMask(OS_TASK_WAIT_QUEUE, queueCB->queueID, remain);
+        ret = runTask->ops->wait(runTask, &queueCB->readWriteList[readWrite], remain);
+        LOS_AtomicSet(&queueCB->queueWaiting[readWrite], 0);
+        SCHEDULER_UNLOCK(intSave);
         if (ret == LOS_ERRNO_TSK_TIMEOUT) {
-            ret = LOS_ERRNO_QUEUE_TIMEOUT;
-            goto QUEUE_END;
+            return LOS_ERRNO_QUEUE_TIMEOUT;
         }
+    }
+}
+
+STATIC VOID OsQueueSpscPublish(LosQueueCB *queueCB, UINT32 readWrite)
+{
+    UINT32 intSave;
+    BOOL needSched = FALSE;
+
+    DMB;
+    if (readWrite == OS_QUEUE_READ) {
+        queueCB->queueHead = OsQueuePosNext(queueCB, queueCB->queueHead);
+        LOS_AtomicDec(&queueCB->queueCount);
     } else {
-        queueCB->readWriteableCnt[readWrite]--;
+        queueCB->queueTail = OsQueuePosNext(queueCB, queueCB->queueTail);
+        LOS_AtomicInc(&queueCB->queueCount);
     }
+    DMB;
 
-    OsQueueBufferOperate(queueCB, operateType, bufferAddr, bufferSize);
+    if (LOS_AtomicRead(&queueCB->queueWaiting[!readWrite]) == 0) {
+        return;
+    }
 
+    SCHEDULER_LOCK(intSave);
     if (!LOS_ListEmpty(&queueCB->readWriteList[!readWrite])) {
         LosTaskCB *resumedTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&queueCB->readWriteList[!readWrite]));
         OsTaskWakeClearPendMask(resumedTask);
         resumedTask->ops->wake(resumedTask);
-        SCHEDULER_UNLOCK(intSave);
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        needSched = TRUE;
+    }
+    SCHEDULER_UNLOCK(intSave);
+    if (needSched) {
         LOS_Schedule();
-        return LOS_OK;
+    }
+}
+
+STATIC UINT32 OsQueueSpscOperate(LosQueueCB *queueCB, UINT32 operateType, VOID *bufferAddr, UINT32 *bufferSize,
+                                 UINT32 *prio, UINT32 timeout)
+{
+    UINT32 readWrite = OS_QUEUE_READ_WRITE_GET(operateType);
+    UINT32 ret;
+
+    ret = OsQueueSpscWait(queueCB, readWrite, timeout);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    if (readWrite == OS_QUEUE_READ) {
+        if (prio != NULL) {
+            *prio = 0;
+        }
+        OsQueueNodeCopyOut(queueCB, OS_QUEUE_NODE(queueCB, queueCB->queueHead), bufferAddr, bufferSize);
+    } else {
+        OsQueueNodeCopyIn(queueCB, OS_QUEUE_NODE(queueCB, queueCB->queueTail), bufferAddr, bufferSize);
+    }
+    OsQueueSpscPublish(queueCB, readWrite);
+    return LOS_OK;
+}
+
+/* prio is the priority of the message written, or receives the priority of the message read; it may be NULL */
+UINT32 OsQueueOperate(UINT32 queueID, UINT32 operateType, VOID *bufferAddr, UINT32 *bufferSize, UINT32 *prio,
+                      UINT32 timeout)
+{
+    UINT32 ret;
+    UINT32 readWrite = OS_QUEUE_READ_WRITE_GET(operateType);
+    UINT32 intSave;
+    UINT32 msgPrio = 0;
+    BOOL needSched;
+    OsHookCall(LOS_HOOK_TYPE_QUEUE_READ, (LosQueueCB *)GET_QUEUE_HANDLE(queueID), operateType, *bufferSize, timeout);
+
+    SCHEDULER_LOCK(intSave);
+    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
+    ret = OsQueueOperateParamCheck(queueCB, queueID, operateType, bufferSize);
+    if (ret != LOS_OK) {
+        goto QUEUE_END;
+    }
+
+    if (queueCB->queueFlags & LOS_QUEUE_SPSC) {
+        /* the writer must not overwrite the node it has reserved */
+        if ((readWrite == OS_QUEUE_WRITE) && queueCB->queueReserved[queueCB->queueTail]) {
+            ret = LOS_ERRNO_QUEUE_OPERATE_INVALID;
+            goto QUEUE_END;
+        }
+        LOS_AtomicInc(&queueCB->queueBusy);
+        SCHEDULER_UNLOCK(intSave);
+        ret = OsQueueSpscOperate(queueCB, operateType, bufferAddr, bufferSize, prio, timeout);
+        LOS_AtomicDec(&queueCB->queueBusy);
+        return ret;
+    }
+
+    if ((readWrite == OS_QUEUE_WRITE) && (prio != NULL)) {
+        msgPrio = *prio;
+        /* the priority is only meaningful, and so only checked, on a LOS_QUEUE_PRIO queue */
+        if ((queueCB->queueFlags & LOS_QUEUE_PRIO) && (msgPrio >= LOS_QUEUE_PRIO_NUM)) {
+            ret = LOS_ERRNO_QUEUE_OPERATE_INVALID;
+            goto QUEUE_END;
+        }
+    }
+
+    ret = OsQueueNodeWait(queueCB, readWrite, timeout);
+    if (ret != LOS_OK) {
+        goto QUEUE_END;
+    }
+
+    if (readWrite == OS_QUEUE_READ) {
+        needSched = OsQueueReadOperate(queueCB, bufferAddr, bufferSize, &msgPrio, &intSave);
+        if (prio != NULL) {
+            *prio = msgPrio;
+        }
     } else {
-        queueCB->readWriteableCnt[!readWrite]++;
+        needSched = OsQueueWriteOperate(queueCB, operateType, bufferAddr, bufferSize, msgPrio, &intSave);
     }
+    SCHEDULER_UNLOCK(intSave);
+    if (needSched) {
+        LOS_Schedule();
+    }
+    return LOS_OK;
 
 QUEUE_END:
     SCHEDULER_UNLOCK(intSave);
@@ -347,7 +700,7 @@ LITE_OS_SEC_TEXT UINT32 LOS_QueueReadCopy(UINT32 queueID,
     }
 
     operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_READ, OS_QUEUE_HEAD);
-    return OsQueueOperate(queueID, operateType, bufferAddr, bufferSize, timeout);
+    return OsQueueOperate(queueID, operateType, bufferAddr, bufferSize, NULL, timeout);
 }
 
 LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteHeadCopy(UINT32 queueID,
@@ -364,7 +717,7 @@ LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteHeadCopy(UINT32 queueID,
     }
 
     operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_WRITE, OS_QUEUE_HEAD);
-    return OsQueueOperate(queueID, operateType, bufferAddr, &bufferSize, timeout);
+    return OsQueueOperate(queueID, operateType, bufferAddr, &bufferSize, NULL, timeout);
 }
 
 LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteCopy(UINT32 queueID,
@@ -381,7 +734,43 @@ LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteCopy(UINT32 queueID,
     }
 
     operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_WRITE, OS_QUEUE_TAIL);
-    return OsQueueOperate(queueID, operateType, bufferAddr, &bufferSize, timeout);
+    return OsQueueOperate(queueID, operateType, bufferAddr, &bufferSize, NULL, timeout);
+}
+
+LITE_OS_SEC_TEXT UINT32 LOS_QueueReadCopyPrio(UINT32 queueID,
+                                              VOID *bufferAddr,
+                                              UINT32 *bufferSize,
+                                              UINT32 *prio,
+                                              UINT32 timeout)
+{
+    UINT32 ret;
+    UINT32 operateType;
+
+    ret = OsQueueReadParameterCheck(queueID, bufferAddr, bufferSize, timeout);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_READ, OS_QUEUE_HEAD);
+    return OsQueueOperate(queueID, operateType, bufferAddr, bufferSize, prio, timeout);
+}
+
+LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteCopyPrio(UINT32 queueID,
+                                               VOID *bufferAddr,
+                                               UINT32 bufferSize,
+                                               UINT32 prio,
+                                               UINT32 timeout)
+{
+    UINT32 ret;
+    UINT32 operateType;
+
+    ret = OsQueueWriteParameterCheck(queueID, bufferAddr, &bufferSize, timeout);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_WRITE, OS_QUEUE_TAIL);
+    return OsQueueOperate(queueID, operateType, bufferAddr, &bufferSize, &prio, timeout);
 }
 
 LITE_OS_SEC_TEXT UINT32 LOS_QueueRead(UINT32 queueID, VOID *bufferAddr, UINT32 bufferSize, UINT32 timeout)
@@ -410,6 +799,123 @@ LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteHead(UINT32 queueID,
     return LOS_QueueWriteHeadCopy(queueID, &bufferAddr, bufferSize, timeout);
 }
 
+LITE_OS_SEC_TEXT UINT32 LOS_QueueReserve(UINT32 queueID, VOID **bufferAddr, UINT32 timeout)
+{
+    UINT32 operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_WRITE, OS_QUEUE_TAIL);
+    UINT32 bufferSize = 1;
+    UINT32 intSave;
+    UINT32 ret;
+
+    ret = OsQueueWriteParameterCheck(queueID, bufferAddr, &bufferSize, timeout);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
+    ret = OsQueueOperateParamCheck(queueCB, queueID, operateType, &bufferSize);
+    if (ret != LOS_OK) {
+        goto QUEUE_END;
+    }
+
+    if (queueCB->queueFlags & LOS_QUEUE_SPSC) {
+        /* the single writer has at most one reservation: the node at the tail */
+        if (queueCB->queueReserved[queueCB->queueTail]) {
+            ret = LOS_ERRNO_QUEUE_OPERATE_INVALID;
+            goto QUEUE_END;
+        }
+        /* held until the commit, so that the queue cannot be deleted under the writer */
+        LOS_AtomicInc(&queueCB->queueBusy);
+        SCHEDULER_UNLOCK(intSave);
+        ret = OsQueueSpscWait(queueCB, OS_QUEUE_WRITE, timeout);
+        if (ret != LOS_OK) {
+            LOS_AtomicDec(&queueCB->queueBusy);
+            return ret;
+        }
+        queueCB->queueReserved[queueCB->queueTail] = TRUE;
+        *bufferAddr = OS_QUEUE_NODE(queueCB, queueCB->queueTail);
+        return LOS_OK;
+    }
+
+    ret = OsQueueNodeWait(queueCB, OS_QUEUE_WRITE, timeout);
+    if (ret == LOS_OK) {
+        UINT16 buffer = OsQueueWriteReserve(queueCB);
+        queueCB->queueReserved[buffer] = TRUE;
+        *bufferAddr = OS_QUEUE_NODE(queueCB, buffer);
+    }
+
+QUEUE_END:
+    SCHEDULER_UNLOCK(intSave);
+    return ret;
+}
+
+LITE_OS_SEC_TEXT UINT32 LOS_QueueCommitPrio(UINT32 queueID, VOID *bufferAddr, UINT32 bufferSize, UINT32 prio)
+{
+    UINT32 operateType = OS_QUEUE_OPERATE_TYPE(OS_QUEUE_WRITE, OS_QUEUE_TAIL);
+    UINT32 intSave;
+    UINT32 ret;
+    UINTPTR offset;
+    UINT16 buffer;
+    BOOL needSched = FALSE;
+
+    ret = OsQueueWriteParameterCheck(queueID, bufferAddr, &bufferSize, LOS_NO_WAIT);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
+    ret = OsQueueOperateParamCheck(queueCB, queueID, operateType, &bufferSize);
+    if (ret != LOS_OK) {
+        goto QUEUE_END;
+    }
+
+    if ((queueCB->queueFlags & LOS_QUEUE_PRIO) && (prio >= LOS_QUEUE_PRIO_NUM)) {
+        ret = LOS_ERRNO_QUEUE_OPERATE_INVALID;
+        goto QUEUE_END;
+    }
+
+    offset = (UINTPTR)bufferAddr - (UINTPTR)queueCB->queueHandle;
+    if (((UINTPTR)bufferAddr < (UINTPTR)queueCB->queueHandle) || ((offset % queueCB->queueSize) != 0) ||
+        ((offset / queueCB->queueSize) >= queueCB->queueLen)) {
+        ret = LOS_ERRNO_QUEUE_OPERATE_INVALID;
+        goto QUEUE_END;
+    }
+
+    /* only a node handed out by LOS_QueueReserve and not committed yet may be committed */
+    buffer = (UINT16)(offset / queueCB->queueSize);
+    if (!queueCB->queueReserved[buffer] ||
+        ((queueCB->queueFlags & LOS_QUEUE_SPSC) && (buffer != queueCB->queueTail))) {
+        ret = LOS_ERRNO_QUEUE_OPERATE_INVALID;
+        goto QUEUE_END;
+    }
+    queueCB->queueReserved[buffer] = FALSE;
+
+    OsQueueNodeCopyIn(queueCB, (UINT8 *)bufferAddr, NULL, &bufferSize);
+    if (queueCB->queueFlags & LOS_QUEUE_SPSC) {
+        SCHEDULER_UNLOCK(intSave);
+        OsQueueSpscPublish(queueCB, OS_QUEUE_WRITE);
+        LOS_AtomicDec(&queueCB->queueBusy);
+        return LOS_OK;
+    }
+
+    needSched = OsQueueWritePublish(queueCB, buffer, prio);
+    SCHEDULER_UNLOCK(intSave);
+    if (needSched) {
+        LOS_Schedule();
+    }
+    return LOS_OK;
+
+QUEUE_END:
+    SCHEDULER_UNLOCK(intSave);
+    return ret;
+}
+
+LITE_OS_SEC_TEXT UINT32 LOS_QueueCommit(UINT32 queueID, VOID *bufferAddr, UINT32 bufferSize)
+{
+    return LOS_QueueCommitPrio(queueID, bufferAddr, bufferSize, 0);
+}
+
 LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueDelete(UINT32 queueID)
 {
     LosQueueCB *queueCB = NULL;
@@ -443,8 +949,15 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueDelete(UINT32 queueID)
         goto QUEUE_END;
     }
 
-    if ((queueCB->readWriteableCnt[OS_QUEUE_WRITE] + queueCB->readWriteableCnt[OS_QUEUE_READ]) !=
-        queueCB->queueLen) {
+    /* readers and writers of a LOS_QUEUE_SPSC queue copy without the lock, and a writer may hold a reservation */
+    if ((queueCB->queueFlags & LOS_QUEUE_SPSC) && (LOS_AtomicRead(&queueCB->queueBusy) != 0)) {
+        ret = LOS_ERRNO_QUEUE_IN_TSKUSE;
+        goto QUEUE_END;
+    }
+
+    if (!(queueCB->queueFlags & LOS_QUEUE_SPSC) &&
+        ((queueCB->readWriteableCnt[OS_QUEUE_WRITE] + queueCB->readWriteableCnt[OS_QUEUE_READ]) !=
+        queueCB->queueLen)) {
         ret = LOS_ERRNO_QUEUE_IN_TSKWRITE;
         goto QUEUE_END;
     }
@@ -495,8 +1008,13 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_QueueInfoGet(UINT32 queueID, QUEUE_INFO_S *que
     queueInfo->usQueueSize = queueCB->queueSize;
     queueInfo->usQueueHead = queueCB->queueHead;
     queueInfo->usQueueTail = queueCB->queueTail;
-    queueInfo->usReadableCnt = queueCB->readWriteableCnt[OS_QUEUE_READ];
-    queueInfo->usWritableCnt = queueCB->readWriteableCnt[OS_QUEUE_WRITE];
+    if (queueCB->queueFlags & LOS_QUEUE_SPSC) {
+        queueInfo->usReadableCnt = (UINT16)LOS_AtomicRead(&queueCB->queueCount);
+        queueInfo->usWritableCnt = queueCB->queueLen - queueInfo->usReadableCnt;
+    } else {
+        queueInfo->usReadableCnt = queueCB->readWriteableCnt[OS_QUEUE_READ];
+        queueInfo->usWritableCnt = queueCB->readWriteableCnt[OS_QUEUE_WRITE];
+    }
 
     LOS_DL_LIST_FOR_EACH_ENTRY(tskCB, &queueCB->readWriteList[OS_QUEUE_READ], LosTaskCB, pendList) {
         queueInfo->uwWaitReadTask |= 1ULL << tskCB->taskID;
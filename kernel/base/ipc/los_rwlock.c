@@ -451,7 +451,6 @@ UINT32 LOS_RwlockUnLock(LosRwlock *rwlock)
     SCHEDULER_LOCK(intSave);
     ret = OsRwlockUnlockUnsafe(rwlock, &needSched);
     SCHEDULER_UNLOCK(intSave);
-    LOS_MpSchedule(OS_MP_CPU_ALL);
     if (needSched == TRUE) {
         LOS_Schedule();
     }
@@ -277,7 +277,6 @@ LITE_OS_SEC_TEXT UINT32 LOS_SemPost(UINT32 semHandle)
     ret = OsSemPostUnsafe(semHandle, &needSched);
         SCHEDULER_UNLOCK(intSave);
     if (needSched) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
         LOS_Schedule();
     }
 
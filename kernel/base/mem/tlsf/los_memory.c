@@ -33,6 +33,7 @@
 #include "los_memory_pri.h"
 #include "sys/param.h"
 #include "los_spinlock.h"
+#include "los_atomic.h"
 #include "los_vm_phys.h"
 #include "los_vm_boot.h"
 #include "los_vm_filemap.h"
@@ -214,11 +215,24 @@ struct OsMemPoolHead {
 #define OS_MEM_MIDDLE_ADDR(startAddr, middleAddr, endAddr) \
     (((UINT8 *)(startAddr) <= (UINT8 *)(middleAddr)) && ((UINT8 *)(middleAddr) <= (UINT8 *)(endAddr)))
 #define OS_MEM_SET_MAGIC(node)      ((node)->magic = OS_MEM_NODE_MAGIC)
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+/* The blocks parked in a per-cpu magazine carry their own magic, so that freeing them again is caught */
+#define OS_MEM_NODE_CACHED_MAGIC    0xABCDCACE
+#define OS_MEM_SET_CACHED_MAGIC(node) ((node)->magic = OS_MEM_NODE_CACHED_MAGIC)
+#define OS_MEM_NODE_IS_CACHED(node) ((node)->magic == OS_MEM_NODE_CACHED_MAGIC)
+#define OS_MEM_MAGIC_VALID(node)    (((node)->magic == OS_MEM_NODE_MAGIC) || OS_MEM_NODE_IS_CACHED(node))
+#else
+#define OS_MEM_NODE_IS_CACHED(node) FALSE
 #define OS_MEM_MAGIC_VALID(node)    ((node)->magic == OS_MEM_NODE_MAGIC)
+#endif
 
 STATIC INLINE VOID OsMemFreeNodeAdd(VOID *pool, struct OsMemFreeNodeHead *node);
 STATIC INLINE UINT32 OsMemFree(struct OsMemPoolHead *pool, struct OsMemNodeHead *node);
 STATIC VOID OsMemInfoPrint(VOID *pool);
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+STATIC BOOL MemCheckUsedNode(const struct OsMemPoolHead *pool, const struct OsMemNodeHead *node,
+                             const struct OsMemNodeHead *startNode, const struct OsMemNodeHead *endNode);
+#endif
 #ifdef LOSCFG_BASE_MEM_NODE_INTEGRITY_CHECK
 STATIC INLINE UINT32 OsMemAllocCheck(struct OsMemPoolHead *pool, UINT32 intSave);
 #endif
@@ -1012,6 +1026,21 @@ UINT32 LOS_MemPoolList(VOID)
 }
 #endif
 
+STATIC INLINE VOID *OsMemUsedNodeSet(struct OsMemPoolHead *pool, struct OsMemNodeHead *allocNode, UINT32 allocSize)
+{
+    if ((allocSize + OS_MEM_NODE_HEAD_SIZE + OS_MEM_MIN_ALLOC_SIZE) <= allocNode->sizeAndFlag) {
+        OsMemSplitNode(pool, allocNode, allocSize);
+    }
+
+    OS_MEM_NODE_SET_USED_FLAG(allocNode->sizeAndFlag);
+    OsMemWaterUsedRecord(pool, OS_MEM_NODE_GET_SIZE(allocNode->sizeAndFlag));
+
+#ifdef LOSCFG_MEM_LEAKCHECK
+    OsMemLinkRegisterRecord(allocNode);
+#endif
+    return OsMemCreateUsedNode((VOID *)allocNode);
+}
+
 STATIC INLINE VOID *OsMemAlloc(struct OsMemPoolHead *pool, UINT32 size, UINT32 intSave)
 {
     struct OsMemNodeHead *allocNode = NULL;
@@ -1047,19 +1076,200 @@ retry:
         return NULL;
     }
 
-    if ((allocSize + OS_MEM_NODE_HEAD_SIZE + OS_MEM_MIN_ALLOC_SIZE) <= allocNode->sizeAndFlag) {
-        OsMemSplitNode(pool, allocNode, allocSize);
+    return OsMemUsedNodeSet(pool, allocNode, allocSize);
+}
+
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+/*
+ * Per-cpu cache of small blocks of m_aucSysMem0. Blocks in a magazine stay
+ * marked as used in the pool, so the pool itself never sees them until the
+ * magazine is drained, and carry OS_MEM_NODE_CACHED_MAGIC so a second free
+ * of them is rejected. Magazines are only touched by their own cpu with the
+ * interrupts disabled, and are refilled and drained in batches under the
+ * pool lock.
+ */
+#define OS_MEM_CACHE_CLASS_NUM      8
+#define OS_MEM_CACHE_MAX_SIZE       256
+#define OS_MEM_CACHE_MAGAZINE_SIZE  16
+#define OS_MEM_CACHE_BATCH          (OS_MEM_CACHE_MAGAZINE_SIZE >> 1)
+#define OS_MEM_CACHE_NODE_SIZE(size) OS_MEM_ALIGN((size) + OS_MEM_NODE_HEAD_SIZE, OS_MEM_ALIGN_SIZE)
+
+struct OsMemMagazine {
+    UINT32 count;
+    VOID *objs[OS_MEM_CACHE_MAGAZINE_SIZE];
+};
+
+struct OsMemCpuCache {
+    struct OsMemMagazine magazine[OS_MEM_CACHE_CLASS_NUM];
+    UINT32 hitNum;
+    UINT32 missNum;
+};
+
+STATIC const UINT32 g_memCacheClassSize[OS_MEM_CACHE_CLASS_NUM] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+STATIC struct OsMemCpuCache g_memCpuCache[LOSCFG_KERNEL_CORE_NUM];
+
+STATIC INLINE UINT32 OsMemCacheClassGet(UINT32 size)
+{
+    UINT32 index;
+
+    for (index = 0; index < OS_MEM_CACHE_CLASS_NUM; index++) {
+        if (size <= g_memCacheClassSize[index]) {
+            break;
+        }
     }
+    return index;
+}
 
-    OS_MEM_NODE_SET_USED_FLAG(allocNode->sizeAndFlag);
-    OsMemWaterUsedRecord(pool, OS_MEM_NODE_GET_SIZE(allocNode->sizeAndFlag));
+/* Only the blocks that have exactly the node size of a class can be cached. */
+STATIC INLINE UINT32 OsMemCacheNodeClassGet(const struct OsMemNodeHead *node)
+{
+    UINT32 nodeSize = OS_MEM_NODE_GET_SIZE(node->sizeAndFlag);
+    UINT32 index;
+
+    if (nodeSize > OS_MEM_CACHE_NODE_SIZE(OS_MEM_CACHE_MAX_SIZE)) {
+        return OS_MEM_CACHE_CLASS_NUM;
+    }
+
+    for (index = 0; index < OS_MEM_CACHE_CLASS_NUM; index++) {
+        if (nodeSize == OS_MEM_CACHE_NODE_SIZE(g_memCacheClassSize[index])) {
+            break;
+        }
+    }
+    return index;
+}
+
+STATIC VOID *OsMemCacheRefill(struct OsMemPoolHead *pool, struct OsMemMagazine *magazine, UINT32 size)
+{
+    UINT32 allocSize = OS_MEM_CACHE_NODE_SIZE(size);
+    struct OsMemNodeHead *allocNode = NULL;
+    UINT32 intSave;
+
+    MEM_LOCK(pool, intSave);
+    VOID *ptr = OsMemAlloc(pool, size, intSave);
+    if (ptr == NULL) {
+        MEM_UNLOCK(pool, intSave);
+        return NULL;
+    }
 
+    while (magazine->count < (OS_MEM_CACHE_BATCH - 1)) {
+        allocNode = OsMemFreeNodeGet(pool, allocSize);
+        if (allocNode == NULL) {
+            break;
+        }
+        magazine->objs[magazine->count++] = OsMemUsedNodeSet(pool, allocNode, allocSize);
+        OS_MEM_SET_CACHED_MAGIC(allocNode);
+    }
+    MEM_UNLOCK(pool, intSave);
+    return ptr;
+}
+
+STATIC VOID OsMemCacheDrain(struct OsMemPoolHead *pool, struct OsMemMagazine *magazine)
+{
+    UINT32 index;
+    UINT32 intSave;
+
+    /* give back the coldest blocks, at the bottom of the magazine */
+    MEM_LOCK(pool, intSave);
+    for (index = 0; index < OS_MEM_CACHE_BATCH; index++) {
+        struct OsMemNodeHead *node = (struct OsMemNodeHead *)((UINTPTR)magazine->objs[index] - OS_MEM_NODE_HEAD_SIZE);
+        OS_MEM_SET_MAGIC(node);
+        (VOID)OsMemFree(pool, node);
+    }
+    MEM_UNLOCK(pool, intSave);
+
+    for (index = OS_MEM_CACHE_BATCH; index < magazine->count; index++) {
+        magazine->objs[index - OS_MEM_CACHE_BATCH] = magazine->objs[index];
+    }
+    magazine->count -= OS_MEM_CACHE_BATCH;
+}
+
+STATIC VOID *OsMemCacheAlloc(struct OsMemPoolHead *pool, UINT32 size)
+{
+    UINT32 classIndex = OsMemCacheClassGet(size);
+    VOID *ptr = NULL;
+
+    UINT32 intSave = LOS_IntLock();
+    struct OsMemCpuCache *cache = &g_memCpuCache[ArchCurrCpuid()];
+    struct OsMemMagazine *magazine = &cache->magazine[classIndex];
+    if (magazine->count != 0) {
+        ptr = magazine->objs[--magazine->count];
+        OS_MEM_SET_MAGIC((struct OsMemNodeHead *)((UINTPTR)ptr - OS_MEM_NODE_HEAD_SIZE));
+        cache->hitNum++;
+#if OS_MEM_FREE_BY_TASKID
+        OsMemNodeSetTaskID((struct OsMemUsedNodeHead *)ptr - 1);
+#endif
 #ifdef LOSCFG_MEM_LEAKCHECK
-    OsMemLinkRegisterRecord(allocNode);
+        OsMemLinkRegisterRecord((struct OsMemNodeHead *)((UINTPTR)ptr - OS_MEM_NODE_HEAD_SIZE));
 #endif
-    return OsMemCreateUsedNode((VOID *)allocNode);
+    } else {
+        cache->missNum++;
+        ptr = OsMemCacheRefill(pool, magazine, g_memCacheClassSize[classIndex]);
+    }
+    LOS_IntRestore(intSave);
+    return ptr;
 }
 
+/*
+ * A block is only cached once it passes the checks OsMemFree runs on it, in the first region of the pool.
+ * Everything else, a block of the expanded memory, a block already freed or cached, or a pointer that is not
+ * a block of the pool, is left to OsMemFree, which rejects it under the pool lock. The neighbours are read
+ * without the lock here, so a block next to one being freed may fail the check and take the slow path too.
+ */
+STATIC BOOL OsMemCacheFree(struct OsMemPoolHead *pool, struct OsMemNodeHead *node)
+{
+    struct OsMemNodeHead *startNode = (struct OsMemNodeHead *)OS_MEM_FIRST_NODE(pool);
+    struct OsMemNodeHead *endNode = (struct OsMemNodeHead *)OS_MEM_END_NODE(pool, pool->info.totalSize);
+
+    if (!OS_MEM_MIDDLE_ADDR_OPEN_END(startNode, node, endNode)) {
+        return FALSE;
+    }
+
+    if ((node->magic != OS_MEM_NODE_MAGIC) || !MemCheckUsedNode(pool, node, startNode, endNode) ||
+        OS_MEM_NODE_GET_ALIGNED_FLAG(node->sizeAndFlag) || OS_MEM_NODE_GET_LAST_FLAG(node->sizeAndFlag)) {
+        return FALSE;
+    }
+
+    UINT32 classIndex = OsMemCacheNodeClassGet(node);
+    if (classIndex == OS_MEM_CACHE_CLASS_NUM) {
+        return FALSE;
+    }
+
+    /* of two frees of the same block racing here, only one gets to cache it */
+    if (LOS_AtomicCmpXchg32bits((Atomic *)&node->magic, (INT32)OS_MEM_NODE_CACHED_MAGIC, (INT32)OS_MEM_NODE_MAGIC)) {
+        return FALSE;
+    }
+
+#if OS_MEM_FREE_BY_TASKID
+    /* a cached block must not be released again by LOS_MemFreeByTaskID */
+    ((struct OsMemUsedNodeHead *)node)->taskID = LOSCFG_BASE_CORE_TSK_LIMIT;
+#endif
+    UINT32 intSave = LOS_IntLock();
+    struct OsMemMagazine *magazine = &g_memCpuCache[ArchCurrCpuid()].magazine[classIndex];
+    if (magazine->count == OS_MEM_CACHE_MAGAZINE_SIZE) {
+        OsMemCacheDrain(pool, magazine);
+    }
+    magazine->objs[magazine->count++] = (VOID *)((UINTPTR)node + OS_MEM_NODE_HEAD_SIZE);
+    LOS_IntRestore(intSave);
+    return TRUE;
+}
+
+STATIC VOID OsMemCacheInfoGet(const VOID *pool, LOS_MEM_POOL_STATUS *poolStatus)
+{
+    if (pool != m_aucSysMem0) {
+        return;
+    }
+
+    for (UINT32 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        struct OsMemCpuCache *cache = &g_memCpuCache[cpuid];
+        poolStatus->cacheHitNum += cache->hitNum;
+        poolStatus->cacheMissNum += cache->missNum;
+        for (UINT32 index = 0; index < OS_MEM_CACHE_CLASS_NUM; index++) {
+            poolStatus->cacheNodeNum += cache->magazine[index].count;
+        }
+    }
+}
+#endif
+
 VOID *LOS_MemAlloc(VOID *pool, UINT32 size)
 {
     if ((pool == NULL) || (size == 0)) {
@@ -1078,6 +1288,12 @@ VOID *LOS_MemAlloc(VOID *pool, UINT32 size)
         if (OS_MEM_NODE_GET_USED_FLAG(size) || OS_MEM_NODE_GET_ALIGNED_FLAG(size)) {
             break;
         }
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+        if ((pool == m_aucSysMem0) && (size <= OS_MEM_CACHE_MAX_SIZE)) {
+            ptr = OsMemCacheAlloc(poolHead, size);
+            break;
+        }
+#endif
         MEM_LOCK(poolHead, intSave);
         ptr = OsMemAlloc(poolHead, size, intSave);
         MEM_UNLOCK(poolHead, intSave);
@@ -1234,6 +1450,11 @@ STATIC UINT32 OsMemCheckUsedNode(const struct OsMemPoolHead *pool, const struct
     struct OsMemNodeHead *endNode = (struct OsMemNodeHead *)OS_MEM_END_NODE(pool, pool->info.totalSize);
     BOOL doneFlag = FALSE;
 
+    /* a block in a per-cpu magazine has already been freed */
+    if (OS_MEM_NODE_IS_CACHED(node)) {
+        return LOS_NOK;
+    }
+
     do {
         doneFlag = MemCheckUsedNode(pool, node, startNode, endNode);
         if (!doneFlag) {
@@ -1337,6 +1558,12 @@ UINT32 LOS_MemFree(VOID *pool, VOID *ptr)
             }
             node = (struct OsMemNodeHead *)((UINTPTR)ptr - gapSize - OS_MEM_NODE_HEAD_SIZE);
         }
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+        if ((pool == m_aucSysMem0) && OsMemCacheFree(poolHead, node)) {
+            ret = LOS_OK;
+            break;
+        }
+#endif
         MEM_LOCK(poolHead, intSave);
         ret = OsMemFree(poolHead, node);
         MEM_UNLOCK(poolHead, intSave);
@@ -1942,6 +2169,9 @@ UINT32 LOS_MemInfoGet(VOID *pool, LOS_MEM_POOL_STATUS *poolStatus)
     poolStatus->usageWaterLine = poolInfo->info.waterLine;
 #endif
     MEM_UNLOCK(poolInfo, intSave);
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+    OsMemCacheInfoGet(pool, poolStatus);
+#endif
 
     return LOS_OK;
 }
@@ -1974,6 +2204,12 @@ STATIC VOID OsMemInfoPrint(VOID *pool)
            status.totalFreeSize, status.maxFreeNodeSize, status.usedNodeNum,
            status.freeNodeNum);
 #endif
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+    if (pool == m_aucSysMem0) {
+        PRINTK("per-cpu cache: hit num 0x%x, miss num 0x%x, cached node num 0x%x\n",
+               status.cacheHitNum, status.cacheMissNum, status.cacheNodeNum);
+    }
+#endif
 }
 
 UINT32 LOS_MemFreeNodeShow(VOID *pool)
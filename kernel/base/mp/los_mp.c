@@ -46,18 +46,61 @@ LITE_OS_SEC_BSS SPIN_LOCK_INIT(g_mpCallSpin);
 
 VOID LOS_MpSchedule(UINT32 target)
 {
-    UINT32 cpuid = ArchCurrCpuid();
-    target &= ~(1U << cpuid);
-    HalIrqSendIpi(target, LOS_MP_IPI_SCHEDULE);
+    UINT32 cpuid;
+    UINT32 send = 0;
+    INT32 sent = 0;
+    INT32 merged = 0;
+    Percpu *percpu = OsPercpuGet();
+
+    target &= ~CPUID_TO_AFFI_MASK(ArchCurrCpuid()) & OS_MP_CPU_ALL;
+    if (target == 0) {
+        return;
+    }
+
+    /* the callers queued work for the targets, make it visible before looking at their pending flags */
+    DMB;
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        UINT32 mask = CPUID_TO_AFFI_MASK(cpuid);
+        if (!(target & mask)) {
+            continue;
+        }
+
+        /*
+         * A core that is still to handle a schedule ipi will see the new work anyway.
+         * Cores that have not entered the scheduler are not tracked.
+         */
+        if ((g_taskScheduled & mask) && LOS_AtomicXchg32bits(&g_percpu[cpuid].schedIpiPending, 1)) {
+            merged++;
+            continue;
+        }
+        send |= mask;
+        sent++;
+    }
+
+    if (send != 0) {
+        HalIrqSendIpi(send, LOS_MP_IPI_SCHEDULE);
+        LOS_AtomicAdd(&percpu->schedIpiSent, sent);
+    }
+    if (merged != 0) {
+        LOS_AtomicAdd(&percpu->schedIpiMerged, merged);
+    }
 }
 
 VOID OsMpWakeHandler(VOID)
 {
     /* generic wakeup ipi, do nothing */
+    OsPercpuGet()->ipiRecv[LOS_MP_IPI_WAKEUP]++;
 }
 
 VOID OsMpScheduleHandler(VOID)
 {
+    Percpu *percpu = OsPercpuGet();
+
+    percpu->ipiRecv[LOS_MP_IPI_SCHEDULE]++;
+    /* from here on, work queued for this cpu needs an ipi of its own */
+    LOS_AtomicSet(&percpu->schedIpiPending, 0);
+    DMB;
+
     /*
      * set schedule flag to differ from wake function,
      * so that the scheduler can be triggered at the end of irq.
@@ -68,6 +111,7 @@ VOID OsMpScheduleHandler(VOID)
 VOID OsMpHaltHandler(VOID)
 {
     (VOID)LOS_IntLock();
+    OsPercpuGet()->ipiRecv[LOS_MP_IPI_HALT]++;
     OsPercpuGet()->excFlag = CPU_HALT;
 
     while (1) {}
@@ -139,6 +183,7 @@ VOID OsMpFuncCallHandler(VOID)
     LOS_DL_LIST *list = NULL;
     MpCallFunc *mpCallFunc = NULL;
 
+    g_percpu[cpuid].ipiRecv[LOS_MP_IPI_FUNC_CALL]++;
     MP_CALL_LOCK(intSave);
     while (!LOS_ListEmpty(&g_percpu[cpuid].funcLink)) {
         list = LOS_DL_LIST_FIRST(&g_percpu[cpuid].funcLink);
@@ -55,5 +55,12 @@ VOID OsAllCpuStatusOutput(VOID)
         }
     }
     PrintExcInfo("The current handling the exception is cpu%u !\n", ArchCurrCpuid());
+
+    for (i = 0; i < LOSCFG_KERNEL_CORE_NUM; i++) {
+        PrintExcInfo("cpu%u ipi: sched sent %d merged %d, recv wake %u sched %u halt %u\n", i,
+                     LOS_AtomicRead(&g_percpu[i].schedIpiSent), LOS_AtomicRead(&g_percpu[i].schedIpiMerged),
+                     g_percpu[i].ipiRecv[LOS_MP_IPI_WAKEUP], g_percpu[i].ipiRecv[LOS_MP_IPI_SCHEDULE],
+                     g_percpu[i].ipiRecv[LOS_MP_IPI_HALT]);
+    }
 }
 #endif
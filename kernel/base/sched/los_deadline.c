@@ -143,6 +143,28 @@ STATIC VOID DeadlineQueueInsert(EDFRunqueue *rq, LosTaskCB *taskCB)
     LOS_ListHeadInsert(list, &taskCB->pendList);
 }
 
+#ifdef LOSCFG_KERNEL_SMP
+/* the edf runqueue is shared, kick the cores the task should take over */
+STATIC VOID EDFPreemptCheck(const LosTaskCB *taskCB)
+{
+    UINT32 target = 0;
+    UINT16 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        LosTaskCB *runTask = OsSchedRunqueueByID(cpuid)->runTask;
+        if (!(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid)) || (runTask == NULL)) {
+            continue;
+        }
+
+        if (!OsSchedPolicyIsEDF(runTask) || (EDFParamCompare(&taskCB->sp, &runTask->sp) < 0)) {
+            target |= CPUID_TO_AFFI_MASK(cpuid);
+        }
+    }
+
+    LOS_MpSchedule(target);
+}
+#endif
+
 STATIC VOID EDFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
 {
     LOS_ASSERT(!(taskCB->taskStatus & OS_TASK_STATUS_READY));
@@ -201,6 +223,11 @@ STATIC VOID EDFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
     DeadlineQueueInsert(erq, taskCB);
     taskCB->taskStatus &= ~(OS_TASK_STATUS_BLOCKED | OS_TASK_STATUS_TIMEOUT);
     taskCB->taskStatus |= OS_TASK_STATUS_READY;
+#ifdef LOSCFG_KERNEL_SMP
+    if (!OsTaskIsRunning(taskCB)) {
+        EDFPreemptCheck(taskCB);
+    }
+#endif
 }
 
 STATIC VOID EDFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
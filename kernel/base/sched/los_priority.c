@@ -43,7 +43,7 @@
 #define OS_SCHED_READY_MAX         30
 #define OS_TIME_SLICE_MIN          (INT32)((50 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 50us */
 
-STATIC HPFRunqueue g_schedHPF;
+STATIC HPFRunqueue g_schedHPF[LOSCFG_KERNEL_CORE_NUM];
 
 STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB);
 STATIC VOID HPFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB);
@@ -160,6 +160,7 @@ STATIC INLINE VOID PriQueHeadInsert(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIS
 
     LOS_ListHeadInsert(&priQueList[priority], priQue);
     queueList->readyTasks[priority]++;
+    rq->readyTasks++;
 }
 
 STATIC INLINE VOID PriQueTailInsert(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIST *priQue, UINT32 priority)
@@ -185,6 +186,7 @@ STATIC INLINE VOID PriQueTailInsert(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIS
 
     LOS_ListTailInsert(&priQueList[priority], priQue);
     queueList->readyTasks[priority]++;
+    rq->readyTasks++;
 }
 
 STATIC INLINE VOID PriQueDelete(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIST *priQue, UINT32 priority)
@@ -195,6 +197,7 @@ STATIC INLINE VOID PriQueDelete(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIST *p
 
     LOS_ListDelete(priQue);
     queueList->readyTasks[priority]--;
+    rq->readyTasks--;
     if (LOS_ListEmpty(&priQueList[priority])) {
         *bitmap &= ~(PRIQUEUE_PRIOR0_BIT >> priority);
     }
@@ -244,6 +247,93 @@ STATIC INLINE VOID PriQueInsert(HPFRunqueue *rq, LosTaskCB *taskCB)
     taskCB->taskStatus |= OS_TASK_STATUS_READY;
 }
 
+#ifdef LOSCFG_KERNEL_SMP
+STATIC INLINE BOOL HPFRunqueueIsIdle(const SchedRunqueue *rq)
+{
+    return ((rq->runTask == rq->idleTask) && (rq->hpfRunqueue->readyTasks == 0));
+}
+
+/*
+ * Returns TRUE if the task will get the CPU of rq1 earlier than that of rq2:
+ * the running task of rq1 has a lower priority, or the same priority with fewer
+ * ready tasks waiting in front of it.
+ */
+STATIC INLINE BOOL HPFRunqueueIsBetter(const SchedRunqueue *rq1, const SchedRunqueue *rq2)
+{
+    if ((rq1->runTask == NULL) || (rq2->runTask == NULL)) {
+        return FALSE;
+    }
+
+    INT32 ret = OsSchedParamCompare(rq1->runTask, rq2->runTask);
+    if (ret != 0) {
+        return (ret > 0);
+    }
+
+    return (rq1->hpfRunqueue->readyTasks < rq2->hpfRunqueue->readyTasks);
+}
+
+STATIC SchedRunqueue *HPFRunqueueSelect(SchedRunqueue *rq, const LosTaskCB *taskCB)
+{
+    UINT32 cpuMask = taskCB->cpuAffiMask & LOSCFG_KERNEL_CPU_MASK;
+
+    /* The running task goes back to the core it is running on, unless its affinity has changed */
+    if (OsTaskIsRunning(taskCB) && (cpuMask & CPUID_TO_AFFI_MASK(taskCB->currCpu))) {
+        return OsSchedRunqueueByID(taskCB->currCpu);
+    }
+
+    /* Cores that have not entered the scheduler are only used if the task can not run elsewhere */
+    if (cpuMask & g_taskScheduled) {
+        cpuMask &= g_taskScheduled;
+    }
+
+    if (cpuMask == 0) {
+        return rq;
+    }
+
+    /* Prefer the core the task ran on last time, its cache may still be warm */
+    UINT16 cpuid = taskCB->lastCpu;
+    if (!(cpuMask & CPUID_TO_AFFI_MASK(cpuid))) {
+        cpuid = (UINT16)CTZ(cpuMask);
+    }
+
+    SchedRunqueue *best = OsSchedRunqueueByID(cpuid);
+    if (HPFRunqueueIsIdle(best)) {
+        return best;
+    }
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        SchedRunqueue *tmp = OsSchedRunqueueByID(cpuid);
+        if (!(cpuMask & CPUID_TO_AFFI_MASK(cpuid)) || (tmp == best)) {
+            continue;
+        }
+
+        if (HPFRunqueueIsIdle(tmp)) {
+            return tmp;
+        }
+
+        if (HPFRunqueueIsBetter(tmp, best)) {
+            best = tmp;
+        }
+    }
+
+    return best;
+}
+
+STATIC VOID HPFPreemptCheck(SchedRunqueue *rq, const LosTaskCB *taskCB)
+{
+    UINT16 cpuid = OsSchedRunqueueID(rq);
+    LosTaskCB *runTask = rq->runTask;
+
+    if ((cpuid == ArchCurrCpuid()) || (runTask == NULL)) {
+        return;
+    }
+
+    if (OsSchedParamCompare(taskCB, runTask) < 0) {
+        LOS_MpSchedule(CPUID_TO_AFFI_MASK(cpuid));
+    }
+}
+#endif
+
 STATIC VOID HPFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
 {
 #ifdef LOSCFG_SCHED_HPF_DEBUG
@@ -251,7 +341,18 @@ STATIC VOID HPFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
         taskCB->startTime = OsGetCurrSchedTimeCycle();
     }
 #endif
+#ifdef LOSCFG_KERNEL_SMP
+    rq = HPFRunqueueSelect(rq, taskCB);
+#endif
+    OsSchedRunqueueLock(rq);
     PriQueInsert(rq->hpfRunqueue, taskCB);
+#ifdef LOSCFG_KERNEL_SMP
+    taskCB->readyCpu = OsSchedRunqueueID(rq);
+#endif
+    OsSchedRunqueueUnlock(rq);
+#ifdef LOSCFG_KERNEL_SMP
+    HPFPreemptCheck(rq, taskCB);
+#endif
 }
 
 STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
@@ -259,7 +360,22 @@ STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
     SchedHPF *sched = (SchedHPF *)&taskCB->sp;
 
     if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+#ifdef LOSCFG_KERNEL_SMP
+        /* The tick balance may move the task to another runqueue until its lock is held */
+        while (TRUE) {
+            UINT16 readyCpu = taskCB->readyCpu;
+            rq = OsSchedRunqueueByID(readyCpu);
+            OsSchedRunqueueLock(rq);
+            if (taskCB->readyCpu == readyCpu) {
+                break;
+            }
+            OsSchedRunqueueUnlock(rq);
+        }
+#else
+        OsSchedRunqueueLock(rq);
+#endif
         PriQueDelete(rq->hpfRunqueue, sched->basePrio, &taskCB->pendList, sched->priority);
+        OsSchedRunqueueUnlock(rq);
         taskCB->taskStatus &= ~OS_TASK_STATUS_READY;
     }
 }
@@ -538,20 +654,273 @@ VOID HPFProcessDefaultSchedParamGet(SchedParam *param)
     param->basePrio = OS_USER_PROCESS_PRIORITY_HIGHEST;
 }
 
-VOID HPFSchedPolicyInit(SchedRunqueue *rq)
+/*
+ * Lockless hint: returns TRUE if the highest priority queued on hpfRq is above
+ * that of taskCB, or if taskCB is NULL and hpfRq is not empty.
+ */
+STATIC INLINE BOOL HPFRunqueueMayPreempt(const HPFRunqueue *hpfRq, const LosTaskCB *taskCB)
 {
-    if (ArchCurrCpuid() > 0) {
-        rq->hpfRunqueue = &g_schedHPF;
-        return;
+    UINT32 baseBitmap = hpfRq->queueBitmap;
+    if (baseBitmap == 0) {
+        return FALSE;
+    }
+
+    if (taskCB == NULL) {
+        return TRUE;
+    }
+
+    SchedHPF *sched = (SchedHPF *)&taskCB->sp;
+    UINT32 basePrio = CLZ(baseBitmap);
+    if (basePrio != sched->basePrio) {
+        return (basePrio < sched->basePrio);
+    }
+
+    UINT32 bitmap = hpfRq->queueList[basePrio].queueBitmap;
+    return ((bitmap != 0) && (CLZ(bitmap) < sched->priority));
+}
+
+/*
+ * Called on the current core with interrupts disabled and without g_taskSpin.
+ * Returns FALSE if putting runTask back to the ready queue and picking again
+ * would select runTask itself, so that the caller can skip the switch path and
+ * g_taskSpin. A time slice that is used up, or given up by a yield, is renewed
+ * here the way the tail insert of PriQueInsert would do it.
+ */
+BOOL HPFRunqueueNeedResched(SchedRunqueue *rq, LosTaskCB *runTask, BOOL yield)
+{
+    SchedHPF *sched = (SchedHPF *)&runTask->sp;
+    HPFRunqueue *hpfRq = rq->hpfRunqueue;
+    BOOL needSched = FALSE;
+
+    if ((runTask->ops != &g_priorityOps) || !(runTask->taskStatus & OS_TASK_STATUS_RUNNING)) {
+        return TRUE;
+    }
+
+#ifdef LOSCFG_KERNEL_SCHED_PLIMIT
+    if (!OsSchedLimitCheckTime(runTask)) {
+        return TRUE;
+    }
+#endif
+
+#ifdef LOSCFG_KERNEL_SMP
+    /* A remote task above runTask would be pulled, leave that to the switch path */
+    for (UINT16 index = 0; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        SchedRunqueue *tmp = OsSchedRunqueueByID(index);
+        if ((tmp != rq) && HPFRunqueueMayPreempt(tmp->hpfRunqueue, runTask)) {
+            return TRUE;
+        }
     }
+#endif
+
+    BOOL sliceEnd = yield || (runTask->timeSlice <= OS_TIME_SLICE_MIN);
+
+    OsSchedRunqueueLock(rq);
+    if (HPFRunqueueMayPreempt(hpfRq, runTask)) {
+        needSched = TRUE;
+    } else if (sliceEnd && (hpfRq->queueList[sched->basePrio].readyTasks[sched->priority] != 0)) {
+        needSched = TRUE;
+    } else if (sliceEnd) {
+        if (sched->policy == LOS_SCHED_RR) {
+            sched->initTimeSlice = TimeSliceCalculate(hpfRq, sched->basePrio, sched->priority);
+#ifdef LOSCFG_SCHED_HPF_DEBUG
+            runTask->schedStat.timeSliceTime = runTask->schedStat.timeSliceRealTime;
+            runTask->schedStat.timeSliceCount++;
+#endif
+        } else {
+            sched->initTimeSlice = OS_SCHED_FIFO_TIMEOUT;
+        }
+        runTask->timeSlice = sched->initTimeSlice;
+        if (yield) {
+            runTask->startTime = OsGetCurrSchedTimeCycle();
+        }
+    }
+    OsSchedRunqueueUnlock(rq);
+
+    return needSched;
+}
+
+#ifdef LOSCFG_KERNEL_SMP
+STATIC VOID HPFTaskMigrate(SchedRunqueue *src, SchedRunqueue *dst, LosTaskCB *taskCB)
+{
+    SchedHPF *sched = (SchedHPF *)&taskCB->sp;
+
+    PriQueDelete(src->hpfRunqueue, sched->basePrio, &taskCB->pendList, sched->priority);
+    PriQueTailInsert(dst->hpfRunqueue, sched->basePrio, &taskCB->pendList, sched->priority);
+    taskCB->readyCpu = OsSchedRunqueueID(dst);
+}
+
+/*
+ * Called with g_taskSpin held when the current core switches to its next task.
+ * localTask is the top ready task of the own runqueue, or NULL if it is empty.
+ * Takes the highest priority task that may run on this core from the other
+ * runqueues if it is strictly above localTask, so that it does not wait while
+ * lower priority local work runs.
+ */
+LosTaskCB *HPFRunqueuePull(SchedRunqueue *rq, const LosTaskCB *localTask)
+{
+    UINT16 cpuid = OsSchedRunqueueID(rq);
+    const LosTaskCB *bestTask = localTask;
+    SchedRunqueue *src = NULL;
+    LosTaskCB *taskCB = NULL;
+
+    for (UINT16 index = 0; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        SchedRunqueue *tmp = OsSchedRunqueueByID(index);
+        if ((tmp == rq) || !HPFRunqueueMayPreempt(tmp->hpfRunqueue, bestTask)) {
+            continue;
+        }
+
+        OsSchedRunqueueLock(tmp);
+        LosTaskCB *newTask = HPFRunqueueTopTaskFind(tmp->hpfRunqueue, cpuid);
+        OsSchedRunqueueUnlock(tmp);
+        if (newTask == NULL) {
+            continue;
+        }
+
+        if ((bestTask == NULL) || (OsSchedParamCompare(newTask, bestTask) < 0)) {
+            bestTask = newTask;
+            taskCB = newTask;
+            src = tmp;
+        }
+    }
+
+    if (taskCB == NULL) {
+        return NULL;
+    }
+
+    OsSchedRunqueueDoubleLock(rq, src);
+    /* The task may have been moved or dequeued since the source runqueue was unlocked */
+    if (!(taskCB->taskStatus & OS_TASK_STATUS_READY) || (taskCB->readyCpu != OsSchedRunqueueID(src))) {
+        OsSchedRunqueueDoubleUnlock(rq, src);
+        return NULL;
+    }
+    HPFTaskMigrate(src, rq, taskCB);
+    OsSchedRunqueueDoubleUnlock(rq, src);
+    return taskCB;
+}
+
+/*
+ * Moves up to count ready tasks that may run on the core of dst from src,
+ * highest priority first. Both runqueues must be locked.
+ */
+STATIC UINT32 HPFRunqueueMove(SchedRunqueue *src, SchedRunqueue *dst, UINT32 count)
+{
+    HPFRunqueue *srcRq = src->hpfRunqueue;
+    UINT16 cpuid = OsSchedRunqueueID(dst);
+    UINT32 baseBitmap = srcRq->queueBitmap;
+    LosTaskCB *taskCB = NULL;
+    LosTaskCB *next = NULL;
+    UINT32 moved = 0;
+
+    while (baseBitmap && (moved < count)) {
+        UINT32 basePrio = CLZ(baseBitmap);
+        HPFQueue *queueList = &srcRq->queueList[basePrio];
+        UINT32 bitmap = queueList->queueBitmap;
+        while (bitmap && (moved < count)) {
+            UINT32 priority = CLZ(bitmap);
+            LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(taskCB, next, &queueList->priQueList[priority], LosTaskCB, pendList) {
+                if (!(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid))) {
+                    continue;
+                }
+                HPFTaskMigrate(src, dst, taskCB);
+                if (++moved >= count) {
+                    break;
+                }
+            }
+            bitmap &= ~(PRIQUEUE_PRIOR0_BIT >> priority);
+        }
+        baseBitmap &= ~(PRIQUEUE_PRIOR0_BIT >> basePrio);
+    }
+
+    return moved;
+}
+
+/*
+ * Periodic balancing, called from the tick with the runqueue locks only. Pulls tasks
+ * from the busiest runqueue until both hold about the same number of ready
+ * tasks, then hands one waiting task to each allowed core that is idle.
+ * Returns TRUE if the current core should reschedule.
+ */
+BOOL HPFRunqueueBalance(SchedRunqueue *rq)
+{
+    HPFRunqueue *hpfRq = rq->hpfRunqueue;
+    SchedRunqueue *busiest = NULL;
+    UINT32 maxTasks = hpfRq->readyTasks + 1;
+    BOOL needSched = FALSE;
+    UINT16 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        SchedRunqueue *tmp = OsSchedRunqueueByID(cpuid);
+        if ((tmp != rq) && (tmp->hpfRunqueue->readyTasks > maxTasks)) {
+            maxTasks = tmp->hpfRunqueue->readyTasks;
+            busiest = tmp;
+        }
+    }
+
+    if (busiest != NULL) {
+        OsSchedRunqueueDoubleLock(rq, busiest);
+        UINT32 moved = HPFRunqueueMove(busiest, rq, (maxTasks - hpfRq->readyTasks) >> 1);
+        LosTaskCB *topTask = HPFRunqueueTopTaskFind(hpfRq, OsSchedRunqueueID(rq));
+        OsSchedRunqueueDoubleUnlock(rq, busiest);
+        if ((moved != 0) && (topTask != NULL) && (OsSchedParamCompare(topTask, rq->runTask) < 0)) {
+            needSched = TRUE;
+        }
+    }
+
+    for (cpuid = 0; (cpuid < LOSCFG_KERNEL_CORE_NUM) && (hpfRq->readyTasks != 0); cpuid++) {
+        SchedRunqueue *tmp = OsSchedRunqueueByID(cpuid);
+        if ((tmp == rq) || !HPFRunqueueIsIdle(tmp)) {
+            continue;
+        }
+
+        OsSchedRunqueueDoubleLock(rq, tmp);
+        UINT32 moved = HPFRunqueueMove(rq, tmp, 1);
+        OsSchedRunqueueDoubleUnlock(rq, tmp);
+        if (moved != 0) {
+            LOS_MpSchedule(CPUID_TO_AFFI_MASK(cpuid));
+        }
+    }
+
+    return needSched;
+}
+
+/*
+ * Called by the idle task of the core before it goes to sleep: checks if any
+ * other runqueue holds a task that could be stolen to run here.
+ */
+BOOL HPFRunqueueStealable(SchedRunqueue *rq)
+{
+    UINT16 cpuid = OsSchedRunqueueID(rq);
+    UINT32 intSave;
+
+    for (UINT16 index = 0; index < LOSCFG_KERNEL_CORE_NUM; index++) {
+        SchedRunqueue *tmp = OsSchedRunqueueByID(index);
+        if ((tmp == rq) || (tmp->hpfRunqueue->readyTasks == 0)) {
+            continue;
+        }
+
+        LOS_SpinLockSave(&tmp->lock, &intSave);
+        LosTaskCB *taskCB = HPFRunqueueTopTaskFind(tmp->hpfRunqueue, cpuid);
+        LOS_SpinUnlockRestore(&tmp->lock, intSave);
+        if (taskCB != NULL) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+#endif
+
+VOID HPFSchedPolicyInit(SchedRunqueue *rq)
+{
+    HPFRunqueue *hpfRq = &g_schedHPF[OsSchedRunqueueID(rq)];
 
     for (UINT16 index = 0; index < OS_PRIORITY_QUEUE_NUM; index++) {
-        HPFQueue *queueList = &g_schedHPF.queueList[index];
+        HPFQueue *queueList = &hpfRq->queueList[index];
         LOS_DL_LIST *priQue = &queueList->priQueList[0];
         for (UINT16 prio = 0; prio < OS_PRIORITY_QUEUE_NUM; prio++) {
             LOS_ListInit(&priQue[prio]);
         }
     }
 
-    rq->hpfRunqueue = &g_schedHPF;
+    rq->hpfRunqueue = hpfRq;
 }
@@ -183,16 +183,33 @@ STATIC INLINE BOOL SchedTimeoutQueueScan(SchedRunqueue *rq)
     return needSched;
 }
 
+#ifdef LOSCFG_KERNEL_SMP
+STATIC INLINE VOID SchedRunqueueBalance(SchedRunqueue *rq)
+{
+    UINT64 currTime = OsGetCurrSchedTimeCycle();
+    if (currTime < rq->balanceTime) {
+        return;
+    }
+
+    rq->balanceTime = currTime + OS_SCHED_BALANCE_PERIOD;
+    if (HPFRunqueueBalance(rq)) {
+        rq->schedFlag |= INT_PEND_RESCH;
+    }
+}
+#endif
+
 VOID OsSchedTick(VOID)
 {
     SchedRunqueue *rq = OsSchedRunqueue();
 
     if (rq->responseID == OS_INVALID_VALUE) {
         if (SchedTimeoutQueueScan(rq)) {
-            LOS_MpSchedule(OS_MP_CPU_ALL);
             rq->schedFlag |= INT_PEND_RESCH;
         }
     }
+#ifdef LOSCFG_KERNEL_SMP
+    SchedRunqueueBalance(rq);
+#endif
     rq->schedFlag |= INT_PEND_TICK;
     rq->responseTime = OS_SCHED_MAX_RESPONSE_TIME;
 }
@@ -210,6 +227,7 @@ VOID OsSchedRunqueueInit(VOID)
 
     for (UINT16 index = 0; index < LOSCFG_KERNEL_CORE_NUM; index++) {
         SchedRunqueue *rq = OsSchedRunqueueByID(index);
+        LOS_SpinInit(&rq->lock);
         OsSortLinkInit(&rq->timeoutQueue);
         rq->responseTime = OS_SCHED_MAX_RESPONSE_TIME;
     }
@@ -304,7 +322,15 @@ STATIC LosTaskCB *TopTaskGet(SchedRunqueue *rq)
         goto FIND;
     }
 
+    OsSchedRunqueueLock(rq);
     newTask = HPFRunqueueTopTaskGet(rq->hpfRunqueue);
+    OsSchedRunqueueUnlock(rq);
+#ifdef LOSCFG_KERNEL_SMP
+    LosTaskCB *pullTask = HPFRunqueuePull(rq, newTask);
+    if (pullTask != NULL) {
+        newTask = pullTask;
+    }
+#endif
     if (newTask != NULL) {
         goto FIND;
     }
@@ -340,6 +366,7 @@ VOID OsSchedStart(VOID)
 #endif
 
     OsCurrTaskSet((VOID *)newTask);
+    rq->runTask = newTask;
 
     newTask->startTime = OsGetCurrSchedTimeCycle();
 
@@ -397,11 +424,13 @@ STATIC VOID SchedTaskSwitch(SchedRunqueue *rq, LosTaskCB *runTask, LosTaskCB *ne
 
 #ifdef LOSCFG_KERNEL_SMP
     /* mask new running task's owner processor */
+    runTask->lastCpu = runTask->currCpu;
     runTask->currCpu = OS_TASK_INVALID_CPUID;
     newTask->currCpu = ArchCurrCpuid();
 #endif
 
     OsCurrTaskSet((VOID *)newTask);
+    rq->runTask = newTask;
 #ifdef LOSCFG_KERNEL_VM
     if (newTask->archMmu != runTask->archMmu) {
         LOS_ArchMmuContextSwitch((LosArchMmu *)newTask->archMmu);
@@ -442,6 +471,20 @@ STATIC VOID SchedTaskSwitch(SchedRunqueue *rq, LosTaskCB *runTask, LosTaskCB *ne
     OsTaskSchedule(newTask, runTask);
 }
 
+/*
+ * Called with interrupts disabled. Returns FALSE if the current core would pick
+ * runTask again, the caller then keeps running it without taking g_taskSpin.
+ * yield tells that runTask gives up the rest of its time slice.
+ */
+BOOL OsSchedNeedResched(SchedRunqueue *rq, LosTaskCB *runTask, BOOL yield)
+{
+    if (OsSchedPolicyIsEDF(runTask) || !LOS_ListEmpty(&rq->edfRunqueue->root)) {
+        return TRUE;
+    }
+
+    return HPFRunqueueNeedResched(rq, runTask, yield);
+}
+
 VOID OsSchedIrqEndCheckNeedSched(VOID)
 {
     SchedRunqueue *rq = OsSchedRunqueue();
@@ -451,19 +494,20 @@ VOID OsSchedIrqEndCheckNeedSched(VOID)
 
     if (OsPreemptable() && (rq->schedFlag & INT_PEND_RESCH)) {
         rq->schedFlag &= ~INT_PEND_RESCH;
+        if (OsSchedNeedResched(rq, runTask, FALSE)) {
+            LOS_SpinLock(&g_taskSpin);
 
-        LOS_SpinLock(&g_taskSpin);
+            runTask->ops->enqueue(rq, runTask);
 
-        runTask->ops->enqueue(rq, runTask);
+            LosTaskCB *newTask = TopTaskGet(rq);
+            if (runTask != newTask) {
+                SchedTaskSwitch(rq, runTask, newTask);
+                LOS_SpinUnlock(&g_taskSpin);
+                return;
+            }
 
-        LosTaskCB *newTask = TopTaskGet(rq);
-        if (runTask != newTask) {
-            SchedTaskSwitch(rq, runTask, newTask);
             LOS_SpinUnlock(&g_taskSpin);
-            return;
         }
-
-        LOS_SpinUnlock(&g_taskSpin);
     }
 
     if (rq->schedFlag & INT_PEND_TICK) {
@@ -495,7 +539,7 @@ VOID LOS_Schedule(VOID)
 {
     UINT32 intSave;
     LosTaskCB *runTask = OsCurrTaskGet();
-    SchedRunqueue *rq = OsSchedRunqueue();
+    SchedRunqueue *rq = NULL;
 
     if (OS_INT_ACTIVE) {
         OsSchedRunqueuePendingSet();
@@ -511,9 +555,16 @@ VOID LOS_Schedule(VOID)
      * if necessary, it will give up the timeslice more in time.
      * otherwise, there's no other side effects.
      */
-    SCHEDULER_LOCK(intSave);
-
+    intSave = LOS_IntLock();
+    rq = OsSchedRunqueue();
     runTask->ops->timeSliceUpdate(rq, runTask, OsGetCurrSchedTimeCycle());
+    rq->schedFlag &= ~INT_PEND_RESCH;
+    if (!OsSchedNeedResched(rq, runTask, FALSE)) {
+        LOS_IntRestore(intSave);
+        return;
+    }
+
+    LOS_SpinLock(&g_taskSpin);
 
     /* add run task back to ready queue */
     runTask->ops->enqueue(rq, runTask);
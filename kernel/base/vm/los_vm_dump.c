@@ -495,6 +495,11 @@ UINT32 OsVmPhySegPagesGet(LosVmPhysSeg *seg)
         segFreePages += ((1 << flindex) * seg->freeList[flindex].listCnt);
     }
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+    for (flindex = 0; flindex < LOSCFG_KERNEL_CORE_NUM; flindex++) {
+        segFreePages += seg->pcp[flindex].count;
+    }
+#endif
 
     return segFreePages;
 }
@@ -530,6 +535,11 @@ VOID OsVmPhysDump(VOID)
             for (flindex = 0; flindex < VM_LIST_ORDER_MAX; flindex++) {
                 PRINTK("order = %d, free_count = %d\n", flindex, listCount[flindex]);
             }
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+            for (flindex = 0; flindex < LOSCFG_KERNEL_CORE_NUM; flindex++) {
+                PRINTK("cpu = %d, pcp_count = %d\n", flindex, seg->pcp[flindex].count);
+            }
+#endif
 
             PRINTK("active   anon   %d\n", seg->lruSize[VM_LRU_ACTIVE_ANON]);
             PRINTK("inactive anon   %d\n", seg->lruSize[VM_LRU_INACTIVE_ANON]);
@@ -561,6 +571,12 @@ VOID OsVmPhysUsedInfoGet(UINT32 *usedCount, UINT32 *totalCount)
             *usedCount += (*totalCount - segFreePages);
         }
     }
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+    UINT32 poolCount, poolHit, poolMiss;
+    /* the pre-zeroed pages are handed out on demand, count them as free */
+    OsVmZeroPoolInfoGet(&poolCount, &poolHit, &poolMiss);
+    *usedCount -= poolCount;
+#endif
 }
 #endif
 
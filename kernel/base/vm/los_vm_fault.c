@@ -97,6 +97,61 @@ STATIC VOID OsFaultTryFixup(ExcContext *frame, VADDR_T excVaddr, STATUS_T *statu
 }
 
 #ifdef LOSCFG_FS_VFS
+/*
+ * Map the neighbours of a read fault that are already in the page cache, read only like the faulting page,
+ * so that a file touched page by page, such as an executable being started, takes one fault per window
+ * instead of one per page. The caller holds the mapping mux_lock.
+ */
+STATIC VOID OsDoFaultAround(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
+{
+    UINT32 intSave;
+    LosVmSpace *space = region->space;
+    struct page_mapping *mapping = &region->unTypeData.rf.vnode->mapping;
+    VADDR_T start = ROUNDDOWN((VADDR_T)vmPgFault->vaddr, VM_FAULT_AROUND_SIZE);
+    VADDR_T end = start + VM_FAULT_AROUND_SIZE;
+    VADDR_T vaddr;
+    LosFilePage *fpage = NULL;
+    LosVmPage *page = NULL;
+    LosVmPgFault vmf = { 0 };
+
+    if (region->advice == MADV_RANDOM) {
+        return;
+    }
+
+    if (start < region->range.base) {
+        start = region->range.base;
+    }
+    end = MIN2(end, region->range.base + region->range.size);
+    for (vaddr = start; vaddr < end; vaddr += PAGE_SIZE) {
+        if ((vaddr == (VADDR_T)vmPgFault->vaddr) || (LOS_ArchMmuQuery(&space->archMmu, vaddr, NULL, NULL) == LOS_OK)) {
+            continue;
+        }
+
+        vmf.vaddr = vaddr;
+        vmf.pgoff = region->pgOff + ((vaddr - region->range.base) >> PAGE_SHIFT);
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        fpage = OsFindGetEntry(mapping, vmf.pgoff);
+        if (fpage == NULL) {
+            LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+            continue;
+        }
+        page = fpage->vmPage;
+        OsSetPageLocked(page);
+        OsAddMapInfo(fpage, &space->archMmu, vaddr);
+        fpage->flags = region->regionFlags;
+        LOS_AtomicInc(&page->refCounts);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+        if (LOS_ArchMmuMapReplace(&space->archMmu, vaddr, NULL, VM_PAGE_TO_PHYS(page),
+                                  region->regionFlags & (~VM_MAP_REGION_FLAG_PERM_WRITE)) != LOS_OK) {
+            OsDelMapInfo(region, &vmf, FALSE);
+            OsCleanPageLocked(page);
+            return;
+        }
+        OsCleanPageLocked(page);
+    }
+}
+
 STATIC STATUS_T OsDoReadFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
 {
     status_t ret;
@@ -105,16 +160,18 @@ STATIC STATUS_T OsDoReadFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
     VADDR_T vaddr = (VADDR_T)vmPgFault->vaddr;
     LosVmSpace *space = region->space;
 
-    ret = LOS_ArchMmuQuery(&space->archMmu, vaddr, NULL, NULL);
-    if (ret == LOS_OK) {
-        return LOS_OK;
-    }
     if (region->unTypeData.rf.vmFOps == NULL || region->unTypeData.rf.vmFOps->fault == NULL) {
         VM_ERR("region args invalid, file path: %s", region->unTypeData.rf.vnode->filePath);
         return LOS_ERRNO_VM_INVALID_ARGS;
     }
 
+    /* faults on one file serialize here, another thread may have mapped the page while this one waited */
     (VOID)LOS_MuxAcquire(&region->unTypeData.rf.vnode->mapping.mux_lock);
+    ret = LOS_ArchMmuQuery(&space->archMmu, vaddr, NULL, NULL);
+    if (ret == LOS_OK) {
+        (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
+        return LOS_OK;
+    }
     ret = region->unTypeData.rf.vmFOps->fault(region, vmPgFault);
     if (ret == LOS_OK) {
         paddr = LOS_PaddrQuery(vmPgFault->pageKVaddr);
@@ -123,15 +180,16 @@ STATIC STATUS_T OsDoReadFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
             LOS_AtomicInc(&page->refCounts);
             OsCleanPageLocked(page);
         }
-        ret = LOS_ArchMmuMap(&space->archMmu, vaddr, paddr, 1,
-                             region->regionFlags & (~VM_MAP_REGION_FLAG_PERM_WRITE));
-        if (ret < 0) {
-            VM_ERR("LOS_ArchMmuMap failed");
+        ret = LOS_ArchMmuMapReplace(&space->archMmu, vaddr, NULL, paddr,
+                                    region->regionFlags & (~VM_MAP_REGION_FLAG_PERM_WRITE));
+        if (ret != LOS_OK) {
+            VM_ERR("LOS_ArchMmuMapReplace failed");
             OsDelMapInfo(region, vmPgFault, false);
             (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
             return LOS_ERRNO_VM_NO_MEMORY;
         }
 
+        OsDoFaultAround(region, vmPgFault);
         (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
         return LOS_OK;
     }
@@ -186,22 +244,22 @@ status_t OsDoCowFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
     }
 
     space = region->space;
-    ret = LOS_ArchMmuQuery(&space->archMmu, (VADDR_T)vmPgFault->vaddr, &oldPaddr, NULL);
-    if (ret == LOS_OK) {
-        oldPage = OsCowUnmapOrg(&space->archMmu, region, vmPgFault);
-    }
-
     newPage = LOS_PhysPageAlloc();
     if (newPage == NULL) {
         VM_ERR("LOS_PhysPageAlloc failed");
-        ret = LOS_ERRNO_VM_NO_MEMORY;
-        goto ERR_OUT;
+        return LOS_ERRNO_VM_NO_MEMORY;
     }
 
     newPaddr = VM_PAGE_TO_PHYS(newPage);
     kvaddr = OsVmPageToVaddr(newPage);
 
+    /* the page is unmapped and mapped again with mux_lock held, faults on one file never see it half done */
     (VOID)LOS_MuxAcquire(&region->unTypeData.rf.vnode->mapping.mux_lock);
+    ret = LOS_ArchMmuQuery(&space->archMmu, (VADDR_T)vmPgFault->vaddr, &oldPaddr, NULL);
+    if (ret == LOS_OK) {
+        oldPage = OsCowUnmapOrg(&space->archMmu, region, vmPgFault);
+    }
+
     ret = region->unTypeData.rf.vmFOps->fault(region, vmPgFault);
     if (ret != LOS_OK) {
         VM_ERR("call region->vm_ops->fault fail");
@@ -227,9 +285,9 @@ status_t OsDoCowFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
         }
     }
 
-    ret = LOS_ArchMmuMap(&space->archMmu, (VADDR_T)vmPgFault->vaddr, newPaddr, 1, region->regionFlags);
-    if (ret < 0) {
-        VM_ERR("LOS_ArchMmuMap failed");
+    ret = LOS_ArchMmuMapReplace(&space->archMmu, (VADDR_T)vmPgFault->vaddr, NULL, newPaddr, region->regionFlags);
+    if (ret != LOS_OK) {
+        VM_ERR("LOS_ArchMmuMapReplace failed");
         ret =  LOS_ERRNO_VM_NO_MEMORY;
         (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
         goto ERR_OUT;
@@ -268,12 +326,14 @@ status_t OsDoSharedFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
         return LOS_ERRNO_VM_INVALID_ARGS;
     }
 
+    (VOID)LOS_MuxAcquire(&region->unTypeData.rf.vnode->mapping.mux_lock);
     ret = LOS_ArchMmuQuery(&space->archMmu, vmPgFault->vaddr, &paddr, NULL);
     if (ret == LOS_OK) {
-        LOS_ArchMmuUnmap(&space->archMmu, vmPgFault->vaddr, 1);
-        ret = LOS_ArchMmuMap(&space->archMmu, vaddr, paddr, 1, region->regionFlags);
-        if (ret < 0) {
-            VM_ERR("LOS_ArchMmuMap failed. ret=%d", ret);
+        /* make the read only mapping writable in place */
+        ret = LOS_ArchMmuMapReplace(&space->archMmu, vaddr, &paddr, paddr, region->regionFlags);
+        if (ret != LOS_OK) {
+            VM_ERR("LOS_ArchMmuMapReplace failed. ret=%d", ret);
+            (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
             return LOS_ERRNO_VM_NO_MEMORY;
         }
 
@@ -283,11 +343,11 @@ status_t OsDoSharedFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
             OsMarkPageDirty(fpage, region, 0, 0);
         }
         LOS_SpinUnlockRestore(&region->unTypeData.rf.vnode->mapping.list_lock, intSave);
+        (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
 
         return LOS_OK;
     }
 
-    (VOID)LOS_MuxAcquire(&region->unTypeData.rf.vnode->mapping.mux_lock);
     ret = region->unTypeData.rf.vmFOps->fault(region, vmPgFault);
     if (ret == LOS_OK) {
         paddr = LOS_PaddrQuery(vmPgFault->pageKVaddr);
@@ -297,9 +357,9 @@ status_t OsDoSharedFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
             LOS_AtomicInc(&page->refCounts);
             OsCleanPageLocked(page);
         }
-        ret = LOS_ArchMmuMap(&space->archMmu, vaddr, paddr, 1, region->regionFlags);
-        if (ret < 0) {
-            VM_ERR("LOS_ArchMmuMap failed. ret=%d", ret);
+        ret = LOS_ArchMmuMapReplace(&space->archMmu, vaddr, NULL, paddr, region->regionFlags);
+        if (ret != LOS_OK) {
+            VM_ERR("LOS_ArchMmuMapReplace failed. ret=%d", ret);
             OsDelMapInfo(region, vmPgFault, TRUE);
             (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
             return LOS_ERRNO_VM_NO_MEMORY;
@@ -336,48 +396,47 @@ STATIC STATUS_T OsDoFileFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault, U
     return ret;
 }
 
-STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
+/*
+ * Give a private copy of the shared anonymous page at vaddr to this space. Faults run under the shared region lock,
+ * so the copy is installed only while vaddr still maps oldPaddr and the old reference is dropped only then. A thread
+ * that lost the race to another fault on the same page frees its copy and returns LOS_OK.
+ */
+STATIC STATUS_T OsDoAnonCowFault(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr, PADDR_T oldPaddr,
+                                 LosVmPage *newPage)
 {
-    LosVmSpace *space = LOS_SpaceGet(vaddr);
-    LosVmMapRegion *region = NULL;
     STATUS_T status;
-    PADDR_T oldPaddr;
-    PADDR_T newPaddr;
-    VADDR_T excVaddr = vaddr;
-    LosVmPage *newPage = NULL;
-    LosVmPgFault vmPgFault = { 0 };
+    LosVmPage *oldPage = LOS_VmPageGet(oldPaddr);
 
-    if (space == NULL) {
-        VM_ERR("vm space not exists, vaddr: %#x", vaddr);
-        status = LOS_ERRNO_VM_NOT_FOUND;
-        OsFaultTryFixup(frame, excVaddr, &status);
-        return status;
+    if (oldPage == NULL) {
+        LOS_PhysPageFree(newPage);
+        return LOS_ERRNO_VM_NOT_FOUND;
     }
 
-    if (((flags & VM_MAP_PF_FLAG_USER) != 0) && (!LOS_IsUserAddress(vaddr))) {
-        VM_ERR("user space not allowed to access invalid address: %#x", vaddr);
-        return LOS_ERRNO_VM_ACCESS_DENIED;
+    /* the last sharer keeps the page, fork can not add one under the shared lock */
+    if (LOS_AtomicRead(&oldPage->refCounts) == 1) {
+        LOS_PhysPageFree(newPage);
+        status = LOS_ArchMmuMapReplace(&space->archMmu, vaddr, &oldPaddr, oldPaddr, region->regionFlags);
+        return (status == LOS_ERRNO_VM_BUSY) ? LOS_OK : status;
     }
 
-#ifdef LOSCFG_KERNEL_PLIMITS
-    if (OsMemLimitCheckAndMemAdd(PAGE_SIZE) != LOS_OK) {
-        return LOS_ERRNO_VM_NO_MEMORY;
+    (VOID)memcpy_s(OsVmPageToVaddr(newPage), PAGE_SIZE, LOS_PaddrToKVaddr(oldPaddr), PAGE_SIZE);
+    LOS_AtomicInc(&newPage->refCounts);
+    status = LOS_ArchMmuMapReplace(&space->archMmu, vaddr, &oldPaddr, VM_PAGE_TO_PHYS(newPage), region->regionFlags);
+    if (status != LOS_OK) {
+        LOS_PhysPageFree(newPage);
+        return (status == LOS_ERRNO_VM_BUSY) ? LOS_OK : status;
     }
-#endif
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
-    region = LOS_RegionFind(space, vaddr);
-    if (region == NULL) {
-        VM_ERR("region not exists, vaddr: %#x", vaddr);
-        status = LOS_ERRNO_VM_NOT_FOUND;
-        goto CHECK_FAILED;
-    }
+    OsPhysSharePageDrop(oldPage);
+    return LOS_OK;
+}
 
-    status = OsVmRegionPermissionCheck(region, flags);
-    if (status != LOS_OK) {
-        status = LOS_ERRNO_VM_ACCESS_DENIED;
-        goto CHECK_FAILED;
-    }
+STATIC STATUS_T OsVmRegionFault(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr, UINT32 flags)
+{
+    STATUS_T status;
+    PADDR_T oldPaddr;
+    LosVmPage *newPage = NULL;
+    LosVmPgFault vmPgFault = { 0 };
 
     if (OomCheckProcess()) {
         /*
@@ -385,15 +444,14 @@ STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
          * it will fail, and result is LOS_NOK and current user process
          * will be deleted. memory usage detail will be printed.
          */
-        status = LOS_ERRNO_VM_NO_MEMORY;
-        goto CHECK_FAILED;
+        return LOS_ERRNO_VM_NO_MEMORY;
     }
 
     vaddr = ROUNDDOWN(vaddr, PAGE_SIZE);
 #ifdef LOSCFG_FS_VFS
     if (LOS_IsRegionFileValid(region)) {
         if (region->unTypeData.rf.vnode == NULL) {
-            goto  CHECK_FAILED;
+            return LOS_NOK;
         }
         vmPgFault.vaddr = vaddr;
         vmPgFault.pgoff = ((vaddr - region->range.base) >> PAGE_SHIFT) + region->pgOff;
@@ -403,65 +461,178 @@ STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
         status = OsDoFileFault(region, &vmPgFault, flags);
         if (status) {
             VM_ERR("vm fault error, status=%d", status);
-            goto CHECK_FAILED;
         }
-        goto DONE;
+        return status;
     }
 #endif
 
-    newPage = LOS_PhysPageAlloc();
+    newPage = LOS_PhysZeroPageAlloc();
     if (newPage == NULL) {
-        status = LOS_ERRNO_VM_NO_MEMORY;
-        goto CHECK_FAILED;
+        return LOS_ERRNO_VM_NO_MEMORY;
     }
 
-    newPaddr = VM_PAGE_TO_PHYS(newPage);
-    (VOID)memset_s(OsVmPageToVaddr(newPage), PAGE_SIZE, 0, PAGE_SIZE);
     status = LOS_ArchMmuQuery(&space->archMmu, vaddr, &oldPaddr, NULL);
     if (status >= 0) {
-        LOS_ArchMmuUnmap(&space->archMmu, vaddr, 1);
-        OsPhysSharePageCopy(oldPaddr, &newPaddr, newPage);
-        /* use old page free the new one */
-        if (newPaddr == oldPaddr) {
-            LOS_PhysPageFree(newPage);
-            newPage = NULL;
-        }
-
-        /* map all of the pages */
-        status = LOS_ArchMmuMap(&space->archMmu, vaddr, newPaddr, 1, region->regionFlags);
-        if (status < 0) {
+        status = OsDoAnonCowFault(space, region, vaddr, oldPaddr, newPage);
+        if (status != LOS_OK) {
             VM_ERR("failed to map replacement page, status:%d", status);
-            status = LOS_ERRNO_VM_MAP_FAILED;
-            goto VMM_MAP_FAILED;
-        }
-
-        status = LOS_OK;
-        goto DONE;
-    } else {
-        /* map all of the pages */
-        LOS_AtomicInc(&newPage->refCounts);
-        status = LOS_ArchMmuMap(&space->archMmu, vaddr, newPaddr, 1, region->regionFlags);
-        if (status < 0) {
-            VM_ERR("failed to map page, status:%d", status);
-            status = LOS_ERRNO_VM_MAP_FAILED;
-            goto VMM_MAP_FAILED;
+            return LOS_ERRNO_VM_MAP_FAILED;
         }
+        return LOS_OK;
     }
 
-    status = LOS_OK;
-    goto DONE;
-VMM_MAP_FAILED:
-    if (newPage != NULL) {
+    /* map all of the pages */
+    LOS_AtomicInc(&newPage->refCounts);
+    status = LOS_ArchMmuMapReplace(&space->archMmu, vaddr, NULL, VM_PAGE_TO_PHYS(newPage), region->regionFlags);
+    if (status == LOS_ERRNO_VM_BUSY) {
+        /* another thread faulted the page in first */
         LOS_PhysPageFree(newPage);
+        return LOS_OK;
+    }
+    if (status != LOS_OK) {
+        VM_ERR("failed to map page, status:%d", status);
+        LOS_PhysPageFree(newPage);
+        return LOS_ERRNO_VM_MAP_FAILED;
     }
+
+    return LOS_OK;
+}
+
+#ifdef LOSCFG_FS_VFS
+/*
+ * A file fault whose page is not cached yet reads it with the region lock dropped, so a slow read does not hold up
+ * the faults and mmap calls of the other threads. The vnode is pinned across the read; the region may be gone by
+ * then, so the caller looks it up again and retries. Returns FALSE, with the lock still held, if there is no read.
+ */
+STATIC BOOL OsFaultFileReadUnlocked(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr)
+{
+    UINT32 count;
+    VM_OFFSET_T pgoff;
+    struct Vnode *vnode = NULL;
+
+    if (!LOS_IsRegionFileValid(region) || (region->unTypeData.rf.vnode == NULL)) {
+        return FALSE;
+    }
+
+    pgoff = ((ROUNDDOWN(vaddr, PAGE_SIZE) - region->range.base) >> PAGE_SHIFT) + region->pgOff;
+    count = OsVmmFileFaultReadCount(region, pgoff);
+    if (count == 0) {
+        return FALSE;
+    }
+
+    vnode = region->unTypeData.rf.vnode;
+    VnodeHold();
+    vnode->useCount++;
+    VnodeDrop();
+    OsVmSpaceRdUnlock(space, TRUE);
+
+    OsVmmFileReadAhead(vnode, pgoff, count);
+
+    VnodeHold();
+    vnode->useCount--;
+    VnodeDrop();
+    return TRUE;
+}
+#endif
+
+STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
+{
+    LosVmSpace *space = LOS_SpaceGet(vaddr);
+    LosVmMapRegion *region = NULL;
+    STATUS_T status;
+    VADDR_T excVaddr = vaddr;
+    BOOL shared = FALSE;
+    BOOL retried = FALSE;
+
+    if (space == NULL) {
+        VM_ERR("vm space not exists, vaddr: %#x", vaddr);
+        status = LOS_ERRNO_VM_NOT_FOUND;
+        OsFaultTryFixup(frame, excVaddr, &status);
+        return status;
+    }
+
+    if (((flags & VM_MAP_PF_FLAG_USER) != 0) && (!LOS_IsUserAddress(vaddr))) {
+        VM_ERR("user space not allowed to access invalid address: %#x", vaddr);
+        return LOS_ERRNO_VM_ACCESS_DENIED;
+    }
+
+#ifdef LOSCFG_KERNEL_PLIMITS
+    if (OsMemLimitCheckAndMemAdd(PAGE_SIZE) != LOS_OK) {
+        return LOS_ERRNO_VM_NO_MEMORY;
+    }
+#endif
+
+RETRY:
+    shared = OsVmSpaceRdLock(space);
+    region = OsFindRegion(&space->regionRbTree, vaddr, 1);
+    if (region == NULL) {
+        VM_ERR("region not exists, vaddr: %#x", vaddr);
+        status = LOS_ERRNO_VM_NOT_FOUND;
+        goto CHECK_FAILED;
+    }
+
+    status = OsVmRegionPermissionCheck(region, flags);
+    if (status != LOS_OK) {
+        status = LOS_ERRNO_VM_ACCESS_DENIED;
+        goto CHECK_FAILED;
+    }
+
+#ifdef LOSCFG_FS_VFS
+    /* only once, the retry reads under the lock if the page got reclaimed in between */
+    if (shared && !retried && OsFaultFileReadUnlocked(space, region, vaddr)) {
+        retried = TRUE;
+        goto RETRY;
+    }
+#endif
+
+    status = OsVmRegionFault(space, region, vaddr, flags);
+    if (status == LOS_OK) {
+        goto DONE;
+    }
+
 CHECK_FAILED:
     OsFaultTryFixup(frame, excVaddr, &status);
 #ifdef LOSCFG_KERNEL_PLIMITS
     OsMemLimitMemFree(PAGE_SIZE);
 #endif
 DONE:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceRdUnlock(space, shared);
     return status;
 }
-#endif
 
+/*
+ * Fault in the pages of [vaddr, vaddr + len) that are not mapped yet, for MAP_POPULATE. A private writable mapping
+ * is faulted for write, so it gets its own copies now instead of on the first store. The caller holds the region
+ * write lock.
+ */
+VOID OsVmRegionPopulate(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr, size_t len)
+{
+    UINT32 flags = VM_MAP_PF_FLAG_USER;
+    VADDR_T end = vaddr + len;
+
+    if (LOS_IsRegionTypeDev(region) || (OsVmRegionPermissionCheck(region, 0) != LOS_OK)) {
+        return;
+    }
+    if ((region->regionFlags & (VM_MAP_REGION_FLAG_PERM_WRITE | VM_MAP_REGION_FLAG_SHARED)) ==
+        VM_MAP_REGION_FLAG_PERM_WRITE) {
+        flags |= VM_MAP_PF_FLAG_WRITE;
+    }
+
+    for (; vaddr < end; vaddr += PAGE_SIZE) {
+        if (LOS_ArchMmuQuery(&space->archMmu, vaddr, NULL, NULL) == LOS_OK) {
+            continue;
+        }
+#ifdef LOSCFG_KERNEL_PLIMITS
+        if (OsMemLimitCheckAndMemAdd(PAGE_SIZE) != LOS_OK) {
+            return;
+        }
+#endif
+        if (OsVmRegionFault(space, region, vaddr, flags) != LOS_OK) {
+#ifdef LOSCFG_KERNEL_PLIMITS
+            OsMemLimitMemFree(PAGE_SIZE);
+#endif
+            return;
+        }
+    }
+}
+#endif
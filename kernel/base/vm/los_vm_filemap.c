@@ -69,20 +69,64 @@ VOID ResetPageCacheHitInfo(int *try, int *hit)
 
 #ifdef LOSCFG_KERNEL_VM
 
+STATIC ULONG_T OsPageCacheRbCmpKeyFn(const VOID *pNodeKeyA, const VOID *pNodeKeyB)
+{
+    VM_OFFSET_T pgoffA = *(const VM_OFFSET_T *)pNodeKeyA;
+    VM_OFFSET_T pgoffB = *(const VM_OFFSET_T *)pNodeKeyB;
+
+    if (pgoffA > pgoffB) {
+        return RB_BIGGER;
+    } else if (pgoffA < pgoffB) {
+        return RB_SMALLER;
+    }
+    return RB_EQUAL;
+}
+
+STATIC VOID *OsPageCacheRbGetKeyFn(LosRbNode *pNode)
+{
+    LosFilePage *fpage = LOS_DL_LIST_ENTRY(pNode, LosFilePage, rbNode);
+    return (VOID *)&fpage->pgoff;
+}
+
+VOID OsPageCacheTreeInit(LosRbTree *pageTree)
+{
+    LOS_RbInitTree(pageTree, OsPageCacheRbCmpKeyFn, NULL, OsPageCacheRbGetKeyFn);
+}
+
+STATIC INLINE LosRbTree *OsPageCacheTreeGet(struct page_mapping *mapping)
+{
+    return &mapping->host->pageTree;
+}
+
+/* The nodes linked in the tree always have the nil node of the tree as children. */
+STATIC INLINE BOOL OsPageCacheIndexed(const LosFilePage *fpage)
+{
+    return (fpage->rbNode.pstLeft != NULL);
+}
+
 STATIC VOID OsPageCacheAdd(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
 {
+    LosRbTree *pageTree = OsPageCacheTreeGet(mapping);
+    LosRbNode *pstRbNode = NULL;
     LosFilePage *fpage = NULL;
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        if (fpage->pgoff > pgoff) {
-            LOS_ListTailInsert(&fpage->node, &page->node);
-            goto done_add;
-        }
+    page->pgoff = pgoff;
+    if (LOS_RbAddNode(pageTree, &page->rbNode)) {
+        pstRbNode = LOS_RbSuccessorNode(pageTree, &page->rbNode);
+    } else {
+        /* a page of the same pgoff is indexed already, keep this one behind it in the list only */
+        (VOID)LOS_RbGetNode(pageTree, &page->pgoff, &pstRbNode);
+        pstRbNode = LOS_RbSuccessorNode(pageTree, pstRbNode);
     }
 
-    LOS_ListTailInsert(&mapping->page_list, &page->node);
+    /* page_list is kept sorted by pgoff for the walks over the whole mapping */
+    if (pstRbNode != NULL) {
+        fpage = LOS_DL_LIST_ENTRY(pstRbNode, LosFilePage, rbNode);
+        LOS_ListTailInsert(&fpage->node, &page->node);
+    } else {
+        LOS_ListTailInsert(&mapping->page_list, &page->node);
+    }
 
-done_add:
     mapping->nrpages++;
 }
 
@@ -96,6 +140,9 @@ VOID OsPageCacheDel(LosFilePage *fpage)
 {
     /* delete from file cache list */
     LOS_ListDelete(&fpage->node);
+    if (OsPageCacheIndexed(fpage)) {
+        LOS_RbDelNode(OsPageCacheTreeGet(fpage->mapping), &fpage->rbNode);
+    }
     fpage->mapping->nrpages--;
 
     /* unmap and remove map info */
@@ -363,12 +410,85 @@ VOID OsDelMapInfo(LosVmMapRegion *region, LosVmPgFault *vmf, BOOL cleanDirty)
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 }
 
+/*
+ * Readahead of the file page cache. A miss on the page right after the last one faulted doubles the
+ * window and any other miss halves it, so a file streamed through a mapping gets its pages in growing
+ * batches while random faults read only the page they need. Pages read ahead go to the inactive list and are the
+ * first to be reclaimed if they are never used.
+ */
+STATIC UINT32 OsFileReadAheadWindow(struct Vnode *vnode, VM_OFFSET_T pgoff)
+{
+    BOOL sequential = (pgoff == vnode->raNext);
+
+    vnode->raNext = pgoff + 1;
+    if (!sequential) {
+        vnode->raWindow >>= 1;
+        return 0;
+    }
+
+    if (vnode->raWindow < VM_FILEMAP_RA_MIN) {
+        vnode->raWindow = VM_FILEMAP_RA_MIN;
+    } else if (vnode->raWindow < VM_FILEMAP_RA_MAX) {
+        vnode->raWindow <<= 1;
+    }
+    return vnode->raWindow;
+}
+
+/* madvise(MADV_SEQUENTIAL) always reads ahead the full window, madvise(MADV_RANDOM) never reads ahead */
+STATIC UINT32 OsFileReadAheadCount(const LosVmMapRegion *region, struct Vnode *vnode, VM_OFFSET_T pgoff)
+{
+    if (region->advice == MADV_RANDOM) {
+        vnode->raNext = pgoff + 1;
+        return 0;
+    }
+    if (region->advice == MADV_SEQUENTIAL) {
+        vnode->raNext = pgoff + 1;
+        vnode->raWindow = VM_FILEMAP_RA_MAX;
+        return VM_FILEMAP_RA_MAX;
+    }
+    return OsFileReadAheadWindow(vnode, pgoff);
+}
+
+STATIC VOID OsFileReadAhead(struct Vnode *vnode, VM_OFFSET_T pgoff, UINT32 count)
+{
+    UINT32 intSave;
+    ssize_t ret;
+    VM_OFFSET_T end = pgoff + count;
+    struct page_mapping *mapping = &vnode->mapping;
+    LosFilePage *fpage = NULL;
+
+    for (; pgoff < end; pgoff++) {
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        if (OsFindGetEntry(mapping, pgoff) != NULL) {
+            LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+            continue;
+        }
+        fpage = OsPageCacheAlloc(mapping, pgoff);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+        if (fpage == NULL) {
+            return;
+        }
+
+        ret = vnode->vop->ReadPage(vnode, OsVmPageToVaddr(fpage->vmPage), pgoff << PAGE_SHIFT);
+        if (ret <= 0) { /* end of the file */
+            OsReleaseFpage(mapping, fpage);
+            return;
+        }
+
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        OsPageCacheAdd(fpage, mapping, pgoff);
+        OsLruCacheAdd(fpage, VM_LRU_INACTIVE_FILE);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    }
+}
+
 INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
 {
     INT32 ret;
     VOID *kvaddr = NULL;
 
     UINT32 intSave;
+    UINT32 raCount = 0;
     bool newCache = false;
     struct Vnode *vnode = NULL;
     struct page_mapping *mapping = NULL;
@@ -388,6 +508,9 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
     if (fpage != NULL) {
         TRACE_HIT_CACHE();
         OsPageRefIncLocked(fpage);
+        if (vmf->pgoff == vnode->raNext) {
+            vnode->raNext++;
+        }
     } else {
         fpage = OsPageCacheAlloc(mapping, vmf->pgoff);
         if (fpage == NULL) {
@@ -396,6 +519,7 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
             return LOS_NOK;
         }
         newCache = true;
+        raCount = OsFileReadAheadCount(region, vnode, vmf->pgoff);
     }
     OsSetPageLocked(fpage->vmPage);
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
@@ -412,6 +536,10 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
         LOS_SpinLockSave(&mapping->list_lock, &intSave);
         OsAddToPageacheLru(fpage, mapping, vmf->pgoff);
         LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+        if (raCount != 0) {
+            OsFileReadAhead(vnode, vmf->pgoff + 1, raCount);
+        }
     }
 
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
@@ -431,12 +559,123 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
     return LOS_OK;
 }
 
-VOID OsFileCacheFlush(struct page_mapping *mapping)
+/* read count pages from pgoff into the page cache without mapping them */
+VOID OsVmmFileReadAhead(struct Vnode *vnode, VM_OFFSET_T pgoff, UINT32 count)
+{
+    (VOID)LOS_MuxAcquire(&vnode->mapping.mux_lock);
+    OsFileReadAhead(vnode, pgoff, count);
+    (VOID)LOS_MuxRelease(&vnode->mapping.mux_lock);
+}
+
+/* madvise(MADV_WILLNEED) */
+VOID OsVmmFileWillNeed(LosVmMapRegion *region, VM_OFFSET_T pgoff, UINT32 count)
+{
+    if (!LOS_IsRegionFileValid(region) || (region->unTypeData.rf.vnode == NULL)) {
+        return;
+    }
+    OsVmmFileReadAhead(region->unTypeData.rf.vnode, pgoff, count);
+}
+
+/*
+ * The number of pages a fault on pgoff has to read, the page itself and its readahead window, or 0 when it is
+ * cached already. A fault that gets a count reads them with OsVmmFileReadAhead after dropping the region lock.
+ */
+UINT32 OsVmmFileFaultReadCount(LosVmMapRegion *region, VM_OFFSET_T pgoff)
 {
     UINT32 intSave;
+    UINT32 count = 0;
+    struct Vnode *vnode = NULL;
+    struct page_mapping *mapping = NULL;
+
+    if (!LOS_IsRegionFileValid(region) || (region->unTypeData.rf.vnode == NULL)) {
+        return 0;
+    }
+    vnode = region->unTypeData.rf.vnode;
+    mapping = &vnode->mapping;
+
+    (VOID)LOS_MuxAcquire(&mapping->mux_lock);
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    if (OsFindGetEntry(mapping, pgoff) == NULL) {
+        count = OsFileReadAheadCount(region, vnode, pgoff) + 1;
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    (VOID)LOS_MuxRelease(&mapping->mux_lock);
+
+    return count;
+}
+
+/*
+ * The first page of the list at or after pgoff start. The index only holds one page per pgoff, the others of
+ * the same pgoff follow it in the list and stay there when it goes, so the walk starts from the indexed page
+ * and steps back over them.
+ */
+STATIC LOS_DL_LIST *OsPageCacheRangeFirst(struct page_mapping *mapping, VM_OFFSET_T start)
+{
+    LosRbTree *pageTree = OsPageCacheTreeGet(mapping);
+    LosRbNode *pstRbNode = NULL;
+    LOS_DL_LIST *pos = &mapping->page_list;
+
+    if (!LOS_RbGetNode(pageTree, &start, &pstRbNode)) {
+        pstRbNode = LOS_RbGetNextNode(pageTree, &start);
+    }
+    if (pstRbNode != NULL) {
+        pos = &LOS_DL_LIST_ENTRY(pstRbNode, LosFilePage, rbNode)->node;
+    }
+
+    while ((pos->pstPrev != &mapping->page_list) &&
+           (LOS_DL_LIST_ENTRY(pos->pstPrev, LosFilePage, node)->pgoff >= start)) {
+        pos = pos->pstPrev;
+    }
+    return pos;
+}
+
+STATIC VOID OsFileCachePageFlush(LosFilePage *fpage, LOS_DL_LIST *dirtyList)
+{
     UINT32 lruLock;
-    LOS_DL_LIST_HEAD(dirtyList);
     LosFilePage *ftemp = NULL;
+
+    LOS_SpinLockSave(&fpage->physSeg->lruLock, &lruLock);
+    if (OsIsPageDirty(fpage->vmPage)) {
+        ftemp = OsDumpDirtyPage(fpage);
+        if (ftemp != NULL) {
+            LOS_ListTailInsert(dirtyList, &ftemp->node);
+        }
+    }
+    LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, lruLock);
+}
+
+STATIC VOID OsFileCachePageRemove(LosFilePage *fpage, LOS_DL_LIST *dirtyList)
+{
+    UINT32 lruSave;
+    SPIN_LOCK_S *lruLock = &fpage->physSeg->lruLock;
+    LosFilePage *ftemp = NULL;
+
+    LOS_SpinLockSave(lruLock, &lruSave);
+    if (OsIsPageDirty(fpage->vmPage)) {
+        ftemp = OsDumpDirtyPage(fpage);
+        if (ftemp != NULL) {
+            LOS_ListTailInsert(dirtyList, &ftemp->node);
+        }
+    }
+
+    OsDeletePageCacheLru(fpage);
+    LOS_SpinUnlockRestore(lruLock, lruSave);
+}
+
+STATIC VOID OsFileCacheDirtyFlush(LOS_DL_LIST *dirtyList)
+{
+    LosFilePage *fpage = NULL;
+    LosFilePage *fnext = NULL;
+
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, dirtyList, LosFilePage, node) {
+        OsDoFlushDirtyPage(fpage);
+    }
+}
+
+VOID OsFileCacheFlush(struct page_mapping *mapping)
+{
+    UINT32 intSave;
+    LOS_DL_LIST_HEAD(dirtyList);
     LosFilePage *fpage = NULL;
 
     if (mapping == NULL) {
@@ -444,51 +683,77 @@ VOID OsFileCacheFlush(struct page_mapping *mapping)
     }
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
     LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        LOS_SpinLockSave(&fpage->physSeg->lruLock, &lruLock);
-        if (OsIsPageDirty(fpage->vmPage)) {
-            ftemp = OsDumpDirtyPage(fpage);
-            if (ftemp != NULL) {
-                LOS_ListTailInsert(&dirtyList, &ftemp->node);
-            }
-        }
-        LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, lruLock);
+        OsFileCachePageFlush(fpage, &dirtyList);
     }
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 
-    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, ftemp, &dirtyList, LosFilePage, node) {
-        OsDoFlushDirtyPage(fpage);
+    OsFileCacheDirtyFlush(&dirtyList);
+}
+
+/* flush the pages of pgoff in [start, end) */
+VOID OsFileCacheFlushRange(struct page_mapping *mapping, VM_OFFSET_T start, VM_OFFSET_T end)
+{
+    UINT32 intSave;
+    LOS_DL_LIST_HEAD(dirtyList);
+    LOS_DL_LIST *pos = NULL;
+    LosFilePage *fpage = NULL;
+
+    if ((mapping == NULL) || (start >= end)) {
+        return;
     }
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    for (pos = OsPageCacheRangeFirst(mapping, start); pos != &mapping->page_list; pos = pos->pstNext) {
+        fpage = LOS_DL_LIST_ENTRY(pos, LosFilePage, node);
+        if (fpage->pgoff >= end) {
+            break;
+        }
+        OsFileCachePageFlush(fpage, &dirtyList);
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+    OsFileCacheDirtyFlush(&dirtyList);
 }
 
 VOID OsFileCacheRemove(struct page_mapping *mapping)
 {
     UINT32 intSave;
-    UINT32 lruSave;
-    SPIN_LOCK_S *lruLock = NULL;
     LOS_DL_LIST_HEAD(dirtyList);
-    LosFilePage *ftemp = NULL;
     LosFilePage *fpage = NULL;
     LosFilePage *fnext = NULL;
 
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, &mapping->page_list, LosFilePage, node) {
-        lruLock = &fpage->physSeg->lruLock;
-        LOS_SpinLockSave(lruLock, &lruSave);
-        if (OsIsPageDirty(fpage->vmPage)) {
-            ftemp = OsDumpDirtyPage(fpage);
-            if (ftemp != NULL) {
-                LOS_ListTailInsert(&dirtyList, &ftemp->node);
-            }
-        }
-
-        OsDeletePageCacheLru(fpage);
-        LOS_SpinUnlockRestore(lruLock, lruSave);
+        OsFileCachePageRemove(fpage, &dirtyList);
     }
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 
-    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, &dirtyList, LosFilePage, node) {
-        OsDoFlushDirtyPage(fpage);
+    OsFileCacheDirtyFlush(&dirtyList);
+}
+
+/* flush and drop the pages of pgoff in [start, end) */
+VOID OsFileCacheRemoveRange(struct page_mapping *mapping, VM_OFFSET_T start, VM_OFFSET_T end)
+{
+    UINT32 intSave;
+    LOS_DL_LIST_HEAD(dirtyList);
+    LOS_DL_LIST *pos = NULL;
+    LOS_DL_LIST *next = NULL;
+    LosFilePage *fpage = NULL;
+
+    if ((mapping == NULL) || (start >= end)) {
+        return;
     }
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    for (pos = OsPageCacheRangeFirst(mapping, start); pos != &mapping->page_list; pos = next) {
+        next = pos->pstNext;
+        fpage = LOS_DL_LIST_ENTRY(pos, LosFilePage, node);
+        if (fpage->pgoff >= end) {
+            break;
+        }
+        OsFileCachePageRemove(fpage, &dirtyList);
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+    OsFileCacheDirtyFlush(&dirtyList);
 }
 
 LosVmFileOps g_commVmOps = {
@@ -540,16 +805,10 @@ STATUS_T OsNamedMMap(struct file *filep, LosVmMapRegion *region)
 
 LosFilePage *OsFindGetEntry(struct page_mapping *mapping, VM_OFFSET_T pgoff)
 {
-    LosFilePage *fpage = NULL;
+    LosRbNode *pstRbNode = NULL;
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        if (fpage->pgoff == pgoff) {
-            return fpage;
-        }
-
-        if (fpage->pgoff > pgoff) {
-            break;
-        }
+    if (LOS_RbGetNode(OsPageCacheTreeGet(mapping), &pgoff, &pstRbNode)) {
+        return LOS_DL_LIST_ENTRY(pstRbNode, LosFilePage, rbNode);
     }
 
     return NULL;
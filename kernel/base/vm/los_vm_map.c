@@ -140,6 +140,12 @@ STATIC BOOL OsVmSpaceInitCommon(LosVmSpace *vmSpace, VADDR_T *virtTtb)
         VM_ERR("Create mutex for vm space failed, status: %d", retval);
         return FALSE;
     }
+    retval = LOS_RwlockInit(&vmSpace->regionRwlock);
+    if (retval != LOS_OK) {
+        VM_ERR("Create rwlock for vm space failed, status: %d", retval);
+        (VOID)LOS_MuxDestroy(&vmSpace->regionMux);
+        return FALSE;
+    }
 
     (VOID)LOS_MuxAcquire(&g_vmSpaceListMux);
     LOS_ListAdd(&g_vmSpaceList, &vmSpace->node);
@@ -148,6 +154,46 @@ STATIC BOOL OsVmSpaceInitCommon(LosVmSpace *vmSpace, VADDR_T *virtTtb)
     return OsArchMmuInit(&vmSpace->archMmu, virtTtb);
 }
 
+/*
+ * Region changes take regionMux, then the write side of regionRwlock to keep page faults out. Both are recursive
+ * for the owner, so the nested acquires of mmap and munmap keep working. System tasks can not wait on a rwlock and
+ * only take regionMux, they never race with the faults of a live user space.
+ */
+VOID OsVmSpaceWrLock(LosVmSpace *space)
+{
+    (VOID)LOS_MuxAcquire(&space->regionMux);
+    (VOID)LOS_RwlockWrLock(&space->regionRwlock, LOS_WAIT_FOREVER);
+}
+
+VOID OsVmSpaceWrUnlock(LosVmSpace *space)
+{
+    (VOID)LOS_RwlockUnLock(&space->regionRwlock);
+    (VOID)LOS_MuxRelease(&space->regionMux);
+}
+
+/*
+ * Page faults take the read side, so threads faulting on different pages run in parallel and only serialize on the
+ * page table lock of LOS_ArchMmuMapReplace. A fault taken while this task already holds the write side, or from a
+ * system task, falls back to regionMux and returns FALSE. Holders of the read side must not take regionMux.
+ */
+BOOL OsVmSpaceRdLock(LosVmSpace *space)
+{
+    if (LOS_RwlockRdLock(&space->regionRwlock, LOS_WAIT_FOREVER) == LOS_OK) {
+        return TRUE;
+    }
+    (VOID)LOS_MuxAcquire(&space->regionMux);
+    return FALSE;
+}
+
+VOID OsVmSpaceRdUnlock(LosVmSpace *space, BOOL shared)
+{
+    if (shared) {
+        (VOID)LOS_RwlockUnLock(&space->regionRwlock);
+    } else {
+        (VOID)LOS_MuxRelease(&space->regionMux);
+    }
+}
+
 VOID OsVmMapInit(VOID)
 {
     status_t retval = LOS_MuxInit(&g_vmSpaceListMux, NULL);
@@ -241,15 +287,41 @@ STATIC BOOL OsVmSpaceParamCheck(const LosVmSpace *vmSpace)
     return TRUE;
 }
 
+#ifdef LOSCFG_FS_VFS
+/* record the file pages shared by the cloned region, cow pages are not file pages any more */
+STATIC VOID OsVmRegionFileMapClone(LosVmMapRegion *oldRegion, LosVmMapRegion *newRegion, LosArchMmu *archMmu)
+{
+    struct page_mapping *mapping = &oldRegion->unTypeData.rf.vnode->mapping;
+    UINT32 numPages = newRegion->range.size >> PAGE_SHIFT;
+    LosFilePage *fpage = NULL;
+    LosVmPage *page = NULL;
+    PADDR_T paddr;
+    VADDR_T vaddr;
+    UINT32 i, intSave;
+
+    for (i = 0; i < numPages; i++) {
+        vaddr = newRegion->range.base + (i << PAGE_SHIFT);
+        if (LOS_ArchMmuQuery(archMmu, vaddr, &paddr, NULL) != LOS_OK) {
+            continue;
+        }
+
+        page = LOS_VmPageGet(paddr);
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        fpage = OsFindGetEntry(mapping, newRegion->pgOff + i);
+        if ((fpage != NULL) && (fpage->vmPage == page)) { /* cow page no need map */
+            OsAddMapInfo(fpage, archMmu, vaddr);
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    }
+}
+#endif
+
 STATUS_T LOS_VmSpaceClone(UINT32 cloneFlags, LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
 {
     LosRbNode *pstRbNode = NULL;
     LosRbNode *pstRbNodeNext = NULL;
     STATUS_T ret = LOS_OK;
-    PADDR_T paddr;
-    VADDR_T vaddr;
-    LosVmPage *page = NULL;
-    UINT32 flags, i, intSave, numPages;
+    UINT32 numPages;
 
     if ((OsVmSpaceParamCheck(oldVmSpace) == FALSE) || (OsVmSpaceParamCheck(newVmSpace) == FALSE)) {
         return LOS_ERRNO_VM_INVALID_ARGS;
@@ -263,7 +335,7 @@ STATUS_T LOS_VmSpaceClone(UINT32 cloneFlags, LosVmSpace *oldVmSpace, LosVmSpace
     newVmSpace->mapBase = oldVmSpace->mapBase;
     newVmSpace->heapBase = oldVmSpace->heapBase;
     newVmSpace->heapNow = oldVmSpace->heapNow;
-    (VOID)LOS_MuxAcquire(&oldVmSpace->regionMux);
+    OsVmSpaceWrLock(oldVmSpace);
     RB_SCAN_SAFE(&oldVmSpace->regionRbTree, pstRbNode, pstRbNodeNext)
         LosVmMapRegion *oldRegion = (LosVmMapRegion *)pstRbNode;
 #if defined(LOSCFG_KERNEL_SHM) && defined(LOSCFG_IPC_CONTAINER)
@@ -290,36 +362,19 @@ STATUS_T LOS_VmSpaceClone(UINT32 cloneFlags, LosVmSpace *oldVmSpace, LosVmSpace
         }
 
         numPages = newRegion->range.size >> PAGE_SHIFT;
-        for (i = 0; i < numPages; i++) {
-            vaddr = newRegion->range.base + (i << PAGE_SHIFT);
-            if (LOS_ArchMmuQuery(&oldVmSpace->archMmu, vaddr, &paddr, &flags) != LOS_OK) {
-                continue;
-            }
-
-            page = LOS_VmPageGet(paddr);
-            if (page != NULL) {
-                LOS_AtomicInc(&page->refCounts);
-            }
-            if (flags & VM_MAP_REGION_FLAG_PERM_WRITE) {
-                LOS_ArchMmuUnmap(&oldVmSpace->archMmu, vaddr, 1);
-                LOS_ArchMmuMap(&oldVmSpace->archMmu, vaddr, paddr, 1, flags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
-            }
-            LOS_ArchMmuMap(&newVmSpace->archMmu, vaddr, paddr, 1, flags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
+        ret = LOS_ArchMmuCowClone(&oldVmSpace->archMmu, &newVmSpace->archMmu, newRegion->range.base, numPages);
+        if (ret != LOS_OK) {
+            VM_ERR("clone region page table failed");
+            break;
+        }
 
 #ifdef LOSCFG_FS_VFS
-            if (LOS_IsRegionFileValid(oldRegion)) {
-                LosFilePage *fpage = NULL;
-                LOS_SpinLockSave(&oldRegion->unTypeData.rf.vnode->mapping.list_lock, &intSave);
-                fpage = OsFindGetEntry(&oldRegion->unTypeData.rf.vnode->mapping, newRegion->pgOff + i);
-                if ((fpage != NULL) && (fpage->vmPage == page)) { /* cow page no need map */
-                    OsAddMapInfo(fpage, &newVmSpace->archMmu, vaddr);
-                }
-                LOS_SpinUnlockRestore(&oldRegion->unTypeData.rf.vnode->mapping.list_lock, intSave);
-            }
-#endif
+        if (LOS_IsRegionFileValid(oldRegion)) {
+            OsVmRegionFileMapClone(oldRegion, newRegion, &newVmSpace->archMmu);
         }
+#endif
     RB_SCAN_SAFE_END(&oldVmSpace->regionRbTree, pstRbNode, pstRbNodeNext)
-    (VOID)LOS_MuxRelease(&oldVmSpace->regionMux);
+    OsVmSpaceWrUnlock(oldVmSpace);
     return ret;
 }
 
@@ -510,7 +565,7 @@ LosVmMapRegion *LOS_RegionAlloc(LosVmSpace *vmSpace, VADDR_T vaddr, size_t len,
      * this is the most portable method of creating a new mapping.  If addr is not NULL,
      * then the kernel takes it as where to place the mapping;
      */
-    (VOID)LOS_MuxAcquire(&vmSpace->regionMux);
+    OsVmSpaceWrLock(vmSpace);
     if (vaddr == 0) {
         rstVaddr = OsAllocRange(vmSpace, len);
     } else {
@@ -537,7 +592,7 @@ LosVmMapRegion *LOS_RegionAlloc(LosVmSpace *vmSpace, VADDR_T vaddr, size_t len,
     }
 
 OUT:
-    (VOID)LOS_MuxRelease(&vmSpace->regionMux);
+    OsVmSpaceWrUnlock(vmSpace);
     return newRegion;
 }
 
@@ -610,6 +665,34 @@ STATIC VOID OsFilePagesRemove(LosVmSpace *space, LosVmMapRegion *region)
 }
 #endif
 
+/* Drop the pages mapped in [vaddr, vaddr + size) of region, the next access faults them in again */
+STATUS_T OsRegionPagesDrop(LosVmSpace *space, LosVmMapRegion *region, VADDR_T vaddr, size_t size)
+{
+    if (LOS_IsRegionTypeDev(region) ||
+        (region->regionFlags & (VM_MAP_REGION_FLAG_SHM | VM_MAP_REGION_FLAG_VDSO | VM_MAP_REGION_FLAG_LITEIPC))) {
+        return LOS_ERRNO_VM_INVALID_ARGS;
+    }
+
+#ifdef LOSCFG_FS_VFS
+    if (LOS_IsRegionFileValid(region)) {
+        VM_OFFSET_T pgoff = region->pgOff + ((vaddr - region->range.base) >> PAGE_SHIFT);
+
+        if ((region->unTypeData.rf.vmFOps == NULL) || (region->unTypeData.rf.vmFOps->remove == NULL)) {
+            return LOS_ERRNO_VM_INVALID_ARGS;
+        }
+        while (size >= PAGE_SIZE) {
+            region->unTypeData.rf.vmFOps->remove(region, &space->archMmu, pgoff);
+            pgoff++;
+            size -= PAGE_SIZE;
+        }
+        return LOS_OK;
+    }
+#endif
+
+    OsAnonPagesRemove(&space->archMmu, vaddr, size >> PAGE_SHIFT);
+    return LOS_OK;
+}
+
 STATUS_T LOS_RegionFree(LosVmSpace *space, LosVmMapRegion *region)
 {
     if ((space == NULL) || (region == NULL)) {
@@ -617,7 +700,7 @@ STATUS_T LOS_RegionFree(LosVmSpace *space, LosVmMapRegion *region)
         return LOS_ERRNO_VM_INVALID_ARGS;
     }
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
 
 #ifdef LOSCFG_FS_VFS
     if (LOS_IsRegionFileValid(region)) {
@@ -644,7 +727,7 @@ STATUS_T LOS_RegionFree(LosVmSpace *space, LosVmMapRegion *region)
     LOS_RbDelNode(&space->regionRbTree, &region->rbNode);
     /* free it */
     LOS_MemFree(m_aucSysMem0, region);
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return LOS_OK;
 }
 
@@ -653,7 +736,7 @@ LosVmMapRegion *OsVmRegionDup(LosVmSpace *space, LosVmMapRegion *oldRegion, VADD
     LosVmMapRegion *newRegion = NULL;
     UINT32 regionFlags;
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     regionFlags = oldRegion->regionFlags;
     if (vaddr == 0) {
         regionFlags &= ~(VM_MAP_REGION_FLAG_FIXED | VM_MAP_REGION_FLAG_FIXED_NOREPLACE);
@@ -666,6 +749,7 @@ LosVmMapRegion *OsVmRegionDup(LosVmSpace *space, LosVmMapRegion *oldRegion, VADD
         goto REGIONDUPOUT;
     }
     newRegion->regionType = oldRegion->regionType;
+    newRegion->advice = oldRegion->advice;
 
 #ifdef LOSCFG_KERNEL_SHM
     if (OsIsShmRegion(oldRegion)) {
@@ -685,7 +769,7 @@ LosVmMapRegion *OsVmRegionDup(LosVmSpace *space, LosVmMapRegion *oldRegion, VADD
 #endif
 
 REGIONDUPOUT:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return newRegion;
 }
 
@@ -746,7 +830,7 @@ STATUS_T OsRegionsRemove(LosVmSpace *space, VADDR_T regionBase, size_t size)
     LosRbNode *pstRbNodeTemp = NULL;
     LosRbNode *pstRbNodeNext = NULL;
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
 
     status = OsVmRegionAdjust(space, regionBase, size);
     if (status != LOS_OK) {
@@ -769,7 +853,7 @@ STATUS_T OsRegionsRemove(LosVmSpace *space, VADDR_T regionBase, size_t size)
     RB_SCAN_SAFE_END(&space->regionRbTree, pstRbNodeTemp, pstRbNodeNext)
 
 ERR_REGION_SPLIT:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return status;
 }
 
@@ -831,7 +915,7 @@ STATUS_T OsUnMMap(LosVmSpace *space, VADDR_T addr, size_t size)
 {
     size = LOS_Align(size, PAGE_SIZE);
     addr = LOS_Align(addr, PAGE_SIZE);
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     STATUS_T status = OsRegionsRemove(space, addr, size);
     if (status != LOS_OK) {
         status = -EINVAL;
@@ -840,7 +924,7 @@ STATUS_T OsUnMMap(LosVmSpace *space, VADDR_T addr, size_t size)
     }
 
 ERR_REGION_SPLIT:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return status;
 }
 
@@ -876,9 +960,9 @@ STATUS_T OsVmSpaceRegionFree(LosVmSpace *space)
         return LOS_OK;
     }
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     OsVmSpaceAllRegionFree(space);
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
 
     return LOS_OK;
 }
@@ -895,7 +979,7 @@ STATUS_T LOS_VmSpaceFree(LosVmSpace *space)
     }
 
     /* pop it out of the global aspace list */
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
 
     LOS_ListDelete(&space->node);
 
@@ -913,7 +997,8 @@ STATUS_T LOS_VmSpaceFree(LosVmSpace *space)
     /* destroy the arch portion of the space */
     LOS_ArchMmuDestroy(&space->archMmu);
 
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
+    (VOID)LOS_RwlockDestroy(&space->regionRwlock);
     (VOID)LOS_MuxDestroy(&space->regionMux);
 
     /* free the aspace */
@@ -1032,7 +1117,7 @@ VOID *LOS_VMalloc(size_t size)
     sizeCount = size >> PAGE_SHIFT;
 
     LOS_DL_LIST_HEAD(pageList);
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
 
     count = LOS_PhysPagesAlloc(sizeCount, &pageList);
     if (count < sizeCount) {
@@ -1058,12 +1143,12 @@ VOID *LOS_VMalloc(size_t size)
         va += PAGE_SIZE;
     }
 
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return (VOID *)(UINTPTR)region->range.base;
 
 ERROR:
     (VOID)LOS_PhysPagesFree(&pageList);
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return NULL;
 }
 
@@ -1078,7 +1163,7 @@ VOID LOS_VFree(const VOID *addr)
         return;
     }
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
 
     region = LOS_RegionFind(space, (VADDR_T)(UINTPTR)addr);
     if (region == NULL) {
@@ -1092,7 +1177,7 @@ VOID LOS_VFree(const VOID *addr)
     }
 
 DONE:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
 }
 
 LosMux *OsGVmSpaceMuxGet(VOID)
@@ -35,6 +35,7 @@
 #include "los_vm_map.h"
 #include "los_vm_dump.h"
 #include "los_process_pri.h"
+#include "arm_page_clear.h"
 
 
 #ifdef LOSCFG_KERNEL_VM
@@ -142,6 +143,19 @@ STATIC INLINE VOID OsVmPhysFreeListInit(struct VmPhysSeg *seg)
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
 }
 
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+STATIC VOID OsVmPhysPcpInit(struct VmPhysSeg *seg)
+{
+    UINT32 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        LOS_SpinInit(&seg->pcp[cpuid].lock);
+        LOS_ListInit(&seg->pcp[cpuid].node);
+        seg->pcp[cpuid].count = 0;
+    }
+}
+#endif
+
 VOID OsVmPhysInit(VOID)
 {
     struct VmPhysSeg *seg = NULL;
@@ -154,6 +168,9 @@ VOID OsVmPhysInit(VOID)
         nPages += seg->size >> PAGE_SHIFT;
         OsVmPhysFreeListInit(seg);
         OsVmPhysLruInit(seg);
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+        OsVmPhysPcpInit(seg);
+#endif
     }
 }
 
@@ -394,7 +411,7 @@ VOID OsVmPhysPagesFreeContiguous(LosVmPage *page, size_t nPages)
     }
 }
 
-STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
+STATIC LosVmPage *OsVmPhysBuddyPagesGet(size_t nPages)
 {
     UINT32 intSave;
     struct VmPhysSeg *seg = NULL;
@@ -417,6 +434,185 @@ STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
     return NULL;
 }
 
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+/* Move up to count single pages from the buddy lists to the tail of pcp, the caller holds pcp->lock */
+STATIC UINT32 OsVmPhysPcpRefill(struct VmPhysSeg *seg, struct VmPcpList *pcp, UINT32 count)
+{
+    UINT32 intSave;
+    LosVmPage *page = NULL;
+    UINT32 n;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    for (n = 0; n < count; n++) {
+        page = OsVmPhysPagesAlloc(seg, ONE_PAGE);
+        if (page == NULL) {
+            break;
+        }
+        LOS_ListTailInsert(&pcp->node, &page->node);
+    }
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+
+    pcp->count += n;
+    return n;
+}
+
+/* Give up to count of the coldest pages of pcp back to the buddy lists, the caller holds pcp->lock */
+STATIC VOID OsVmPhysPcpDrain(struct VmPhysSeg *seg, struct VmPcpList *pcp, UINT32 count)
+{
+    UINT32 intSave;
+    LosVmPage *page = NULL;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    while ((count > 0) && !LOS_ListEmpty(&pcp->node)) {
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_LAST(&pcp->node), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        OsVmPhysPagesFree(page, 0);
+        pcp->count--;
+        count--;
+    }
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+}
+
+STATIC VOID OsVmPhysPcpDrainAll(VOID)
+{
+    UINT32 intSave;
+    struct VmPhysSeg *seg = NULL;
+    struct VmPcpList *pcp = NULL;
+    UINT32 segID;
+    UINT32 cpuid;
+
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        seg = &g_vmPhysSeg[segID];
+        for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+            pcp = &seg->pcp[cpuid];
+            LOS_SpinLockSave(&pcp->lock, &intSave);
+            OsVmPhysPcpDrain(seg, pcp, pcp->count);
+            LOS_SpinUnlockRestore(&pcp->lock, intSave);
+        }
+    }
+}
+
+STATIC LosVmPage *OsVmPhysPcpAlloc(struct VmPhysSeg *seg)
+{
+    UINT32 intSave;
+    struct VmPcpList *pcp = NULL;
+    LosVmPage *page = NULL;
+
+    intSave = LOS_IntLock();
+    pcp = &seg->pcp[ArchCurrCpuid()];
+    LOS_SpinLock(&pcp->lock);
+    if (LOS_ListEmpty(&pcp->node) && (OsVmPhysPcpRefill(seg, pcp, VM_PCP_BATCH) == 0)) {
+        LOS_SpinUnlock(&pcp->lock);
+        LOS_IntRestore(intSave);
+        return NULL;
+    }
+    page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&pcp->node), LosVmPage, node);
+    LOS_ListDelete(&page->node);
+    pcp->count--;
+    LOS_SpinUnlock(&pcp->lock);
+    LOS_IntRestore(intSave);
+
+    LOS_AtomicSet(&page->refCounts, 0);
+    page->nPages = ONE_PAGE;
+    return page;
+}
+
+/* The page keeps order VM_LIST_ORDER_MAX while it is cached, so the buddy lists never merge with it */
+STATIC VOID OsVmPhysPcpFree(LosVmPage *page)
+{
+    UINT32 intSave;
+    struct VmPhysSeg *seg = &g_vmPhysSeg[page->segID];
+    struct VmPcpList *pcp = NULL;
+
+    intSave = LOS_IntLock();
+    pcp = &seg->pcp[ArchCurrCpuid()];
+    LOS_SpinLock(&pcp->lock);
+    LOS_AtomicSet(&page->refCounts, 0);
+    LOS_ListHeadInsert(&pcp->node, &page->node);
+    pcp->count++;
+    if (pcp->count > VM_PCP_HIGH) {
+        OsVmPhysPcpDrain(seg, pcp, VM_PCP_BATCH);
+    }
+    LOS_SpinUnlock(&pcp->lock);
+    LOS_IntRestore(intSave);
+}
+#endif
+
+STATIC VOID OsVmPhysPageRelease(LosVmPage *page)
+{
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+    OsVmPhysPcpFree(page);
+#else
+    UINT32 intSave;
+    struct VmPhysSeg *seg = &g_vmPhysSeg[page->segID];
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
+    LOS_AtomicSet(&page->refCounts, 0);
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+#endif
+}
+
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+STATIC SPIN_LOCK_INIT(g_vmZeroPoolSpin);
+STATIC LOS_DL_LIST_HEAD(g_vmZeroPoolList);
+STATIC UINT32 g_vmZeroPoolCount;
+STATIC UINT32 g_vmZeroPoolHit;
+STATIC UINT32 g_vmZeroPoolMiss;
+
+STATIC VOID OsVmZeroPoolDrain(VOID)
+{
+    UINT32 intSave;
+    LosVmPage *page = NULL;
+
+    while (TRUE) {
+        LOS_SpinLockSave(&g_vmZeroPoolSpin, &intSave);
+        if (LOS_ListEmpty(&g_vmZeroPoolList)) {
+            LOS_SpinUnlockRestore(&g_vmZeroPoolSpin, intSave);
+            return;
+        }
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&g_vmZeroPoolList), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        g_vmZeroPoolCount--;
+        LOS_SpinUnlockRestore(&g_vmZeroPoolSpin, intSave);
+
+        OsVmPhysPageRelease(page);
+    }
+}
+#endif
+
+STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
+{
+    LosVmPage *page = NULL;
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+    UINT32 segID;
+
+    if (nPages == ONE_PAGE) {
+        for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+            page = OsVmPhysPcpAlloc(&g_vmPhysSeg[segID]);
+            if (page != NULL) {
+                return page;
+            }
+        }
+    }
+#endif
+
+    page = OsVmPhysBuddyPagesGet(nPages);
+#if defined(LOSCFG_VM_PHYS_PERCPU_PAGES) || defined(LOSCFG_VM_ZERO_PAGE_POOL)
+    if (page == NULL) {
+        /* The missing pages may be parked in the zeroed pool or the per-cpu lists, give them back and retry */
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+        OsVmZeroPoolDrain();
+#endif
+#ifdef LOSCFG_VM_PHYS_PERCPU_PAGES
+        OsVmPhysPcpDrainAll();
+#endif
+        page = OsVmPhysBuddyPagesGet(nPages);
+    }
+#endif
+    return page;
+}
+
 VOID *LOS_PhysPagesAllocContiguous(size_t nPages)
 {
     LosVmPage *page = NULL;
@@ -490,21 +686,12 @@ VADDR_T *LOS_PaddrToKVaddr(PADDR_T paddr)
 
 VOID LOS_PhysPageFree(LosVmPage *page)
 {
-    UINT32 intSave;
-    struct VmPhysSeg *seg = NULL;
-
     if (page == NULL) {
         return;
     }
 
     if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
-        seg = &g_vmPhysSeg[page->segID];
-        LOS_SpinLockSave(&seg->freeListLock, &intSave);
-
-        OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
-        LOS_AtomicSet(&page->refCounts, 0);
-
-        LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+        OsVmPhysPageRelease(page);
     }
 #ifdef LOSCFG_KERNEL_PLIMITS
     OsMemLimitMemFree(PAGE_SIZE);
@@ -516,6 +703,89 @@ LosVmPage *LOS_PhysPageAlloc(VOID)
     return OsVmPhysPagesGet(ONE_PAGE);
 }
 
+LosVmPage *LOS_PhysZeroPageAlloc(VOID)
+{
+    LosVmPage *page = NULL;
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&g_vmZeroPoolSpin, &intSave);
+    if (!LOS_ListEmpty(&g_vmZeroPoolList)) {
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&g_vmZeroPoolList), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        g_vmZeroPoolCount--;
+        g_vmZeroPoolHit++;
+        LOS_SpinUnlockRestore(&g_vmZeroPoolSpin, intSave);
+        return page;
+    }
+    g_vmZeroPoolMiss++;
+    LOS_SpinUnlockRestore(&g_vmZeroPoolSpin, intSave);
+#endif
+
+    page = OsVmPhysPagesGet(ONE_PAGE);
+    if (page == NULL) {
+        return NULL;
+    }
+    ArchPageClear(OsVmPageToVaddr(page), PAGE_SIZE);
+    return page;
+}
+
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+STATIC UINT32 OsVmPhysFreePagesGet(VOID)
+{
+    UINT32 segID;
+    UINT32 freePages = 0;
+
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        freePages += OsVmPhySegPagesGet(&g_vmPhysSeg[segID]);
+    }
+    return freePages;
+}
+
+BOOL OsVmZeroPoolFill(VOID)
+{
+    UINT32 intSave;
+    LosVmPage *page = NULL;
+
+    if (g_vmZeroPoolCount >= VM_ZERO_POOL_HIGH) {
+        return FALSE;
+    }
+
+    /* under memory pressure the pool is drained by the allocator, refilling it would only churn */
+    if (OsVmPhysFreePagesGet() < VM_ZERO_POOL_LOW) {
+        return FALSE;
+    }
+
+    page = OsVmPhysPagesGet(ONE_PAGE);
+    if (page == NULL) {
+        return FALSE;
+    }
+    ArchPageClear(OsVmPageToVaddr(page), PAGE_SIZE);
+
+    LOS_SpinLockSave(&g_vmZeroPoolSpin, &intSave);
+    if (g_vmZeroPoolCount < VM_ZERO_POOL_HIGH) {
+        LOS_ListTailInsert(&g_vmZeroPoolList, &page->node);
+        g_vmZeroPoolCount++;
+        page = NULL;
+    }
+    LOS_SpinUnlockRestore(&g_vmZeroPoolSpin, intSave);
+
+    if (page != NULL) {
+        /* another core filled the last slot meanwhile */
+        OsVmPhysPageRelease(page);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+VOID OsVmZeroPoolInfoGet(UINT32 *count, UINT32 *hit, UINT32 *miss)
+{
+    *count = g_vmZeroPoolCount;
+    *hit = g_vmZeroPoolHit;
+    *miss = g_vmZeroPoolMiss;
+}
+#endif
+
 size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list)
 {
     LosVmPage *page = NULL;
@@ -578,6 +848,14 @@ VOID OsPhysSharePageCopy(PADDR_T oldPaddr, PADDR_T *newPaddr, LosVmPage *newPage
     return;
 }
 
+/* drop the reference of a mapping that moved to its own copy of a shared page, the last one frees it */
+VOID OsPhysSharePageDrop(LosVmPage *page)
+{
+    if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
+        OsVmPhysPageRelease(page);
+    }
+}
+
 struct VmPhysSeg *OsVmPhysSegGet(LosVmPage *page)
 {
     if ((page == NULL) || (page->segID >= VM_PHYS_SEG_MAX)) {
@@ -598,10 +876,8 @@ UINT32 OsVmPagesToOrder(size_t nPages)
 
 size_t LOS_PhysPagesFree(LOS_DL_LIST *list)
 {
-    UINT32 intSave;
     LosVmPage *page = NULL;
     LosVmPage *nPage = NULL;
-    LosVmPhysSeg *seg = NULL;
     size_t count = 0;
 
     if (list == NULL) {
@@ -611,11 +887,7 @@ size_t LOS_PhysPagesFree(LOS_DL_LIST *list)
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(page, nPage, list, LosVmPage, node) {
         LOS_ListDelete(&page->node);
         if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
-            seg = &g_vmPhysSeg[page->segID];
-            LOS_SpinLockSave(&seg->freeListLock, &intSave);
-            OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
-            LOS_AtomicSet(&page->refCounts, 0);
-            LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+            OsVmPhysPageRelease(page);
         }
         count++;
     }
@@ -129,7 +129,7 @@ VADDR_T LOS_MMap(VADDR_T vaddr, size_t len, unsigned prot, unsigned long flags,
         }
     }
 
-    (VOID)LOS_MuxAcquire(&vmSpace->regionMux);
+    OsVmSpaceWrLock(vmSpace);
     /* user mode calls mmap to release heap physical memory without releasing heap virtual space */
     status = OsUserHeapFree(vmSpace, vaddr, len);
     if (status == LOS_OK) {
@@ -159,8 +159,13 @@ VADDR_T LOS_MMap(VADDR_T vaddr, size_t len, unsigned prot, unsigned long flags,
         goto MMAP_DONE;
     }
 
+    /* populating is best effort, the pages it could not fault in are faulted on first access */
+    if (flags & MAP_POPULATE) {
+        OsVmRegionPopulate(vmSpace, newRegion, newRegion->range.base, newRegion->range.size);
+    }
+
 MMAP_DONE:
-    (VOID)LOS_MuxRelease(&vmSpace->regionMux);
+    OsVmSpaceWrUnlock(vmSpace);
     return resultVaddr;
 }
 
@@ -222,10 +227,10 @@ VOID *LOS_DoBrk(VOID *addr)
     alignAddr = (CHAR *)(UINTPTR)(space->heapBase) + size;
     PRINT_INFO("brk addr %p , size 0x%x, alignAddr %p, align %d\n", addr, size, alignAddr, PAGE_SIZE);
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     if (addr < (VOID *)(UINTPTR)space->heapNow) {
         shrinkAddr = OsShrinkHeap(addr, space);
-        (VOID)LOS_MuxRelease(&space->regionMux);
+        OsVmSpaceWrUnlock(space);
         return shrinkAddr;
     }
 
@@ -253,7 +258,7 @@ VOID *LOS_DoBrk(VOID *addr)
     ret = (VOID *)(UINTPTR)space->heapNow;
 
 REGION_ALLOC_FAILED:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return ret;
 }
 
@@ -288,7 +293,7 @@ INT32 LOS_DoMprotect(VADDR_T vaddr, size_t len, unsigned long prot)
     UINT32 count;
     int ret;
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     region = LOS_RegionFind(space, vaddr);
     if (!IS_ALIGNED(vaddr, PAGE_SIZE) || (region == NULL) || (vaddr > vaddr + len)) {
         ret = -EINVAL;
@@ -351,7 +356,71 @@ OUT_MPROTECT:
     }
 #endif
 
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
+    return ret;
+}
+
+INT32 LOS_DoMadvise(VADDR_T vaddr, size_t len, INT32 advice)
+{
+    LosVmSpace *space = OsCurrProcessGet()->vmSpace;
+    LosVmMapRegion *region = NULL;
+    INT32 ret = LOS_OK;
+
+    if (!IS_ALIGNED(vaddr, PAGE_SIZE) || (vaddr > vaddr + len)) {
+        return -EINVAL;
+    }
+    len = LOS_Align(len, PAGE_SIZE);
+    if (len == 0) {
+        return LOS_OK;
+    }
+
+    OsVmSpaceWrLock(space);
+    region = LOS_RegionFind(space, vaddr);
+    /* can't operation cross region */
+    if ((region == NULL) || ((region->range.base + region->range.size) < (vaddr + len))) {
+        ret = -ENOMEM;
+        goto OUT_MADVISE;
+    }
+
+    switch (advice) {
+        case MADV_NORMAL:
+        case MADV_RANDOM:
+        case MADV_SEQUENTIAL:
+            /* the access pattern is only a hint, keep special regions in one piece */
+            if (region->regionFlags & (VM_MAP_REGION_FLAG_HEAP | VM_MAP_REGION_FLAG_VDSO |
+                                       VM_MAP_REGION_FLAG_LITEIPC | VM_MAP_REGION_FLAG_SHM)) {
+                break;
+            }
+            /* if only advise some part of region, we need to split first */
+            if (region->range.size > len) {
+                if (OsVmRegionAdjust(space, vaddr, len) != LOS_OK) {
+                    ret = -ENOMEM;
+                    goto OUT_MADVISE;
+                }
+                region = LOS_RegionFind(space, vaddr);
+            }
+            region->advice = (UINT8)advice;
+            break;
+        case MADV_WILLNEED:
+#ifdef LOSCFG_FS_VFS
+            if (LOS_IsRegionFileValid(region)) {
+                OsVmmFileWillNeed(region, region->pgOff + ((vaddr - region->range.base) >> PAGE_SHIFT),
+                                  len >> PAGE_SHIFT);
+            }
+#endif
+            break;
+        case MADV_DONTNEED:
+            if (OsRegionPagesDrop(space, region, vaddr, len) != LOS_OK) {
+                ret = -EINVAL;
+            }
+            break;
+        default:
+            ret = -EINVAL;
+            break;
+    }
+
+OUT_MADVISE:
+    OsVmSpaceWrUnlock(space);
     return ret;
 }
 
@@ -417,7 +486,7 @@ VADDR_T LOS_DoMremap(VADDR_T oldAddress, size_t oldSize, size_t newSize, int fla
     oldSize = LOS_Align(oldSize, PAGE_SIZE);
     newSize = LOS_Align(newSize, PAGE_SIZE);
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
 
     status = OsMremapCheck(oldAddress, oldSize, newAddr, newSize, (unsigned int)flags);
     if (status) {
@@ -497,7 +566,7 @@ OUT_MREMAP:
     }
 #endif
 
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return ret;
 }
 
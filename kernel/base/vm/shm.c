@@ -542,7 +542,7 @@ LosVmMapRegion *ShmatVmmAlloc(struct shmIDSource *seg, const VOID *shmaddr,
         flags |= MAP_FIXED_NOREPLACE;
     }
     regionFlags = OsCvtProtFlagsToRegionFlags(prot, flags);
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     if (shmaddr == NULL) {
         region = LOS_RegionAlloc(space, 0, seg->ds.shm_segsz, regionFlags, 0);
     } else {
@@ -566,11 +566,11 @@ LosVmMapRegion *ShmatVmmAlloc(struct shmIDSource *seg, const VOID *shmaddr,
         goto ERROR;
     }
     ShmVmmMapping(space, &seg->node, region->range.base, regionFlags);
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return region;
 ERROR:
     set_errno(ret);
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return NULL;
 }
 
@@ -759,7 +759,7 @@ INT32 ShmDt(const VOID *shmaddr)
         goto ERROR;
     }
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     region = LOS_RegionFind(space, (VADDR_T)(UINTPTR)shmaddr);
     if ((region == NULL) || !OsIsShmRegion(region)) {
         ret = EINVAL;
@@ -775,7 +775,7 @@ INT32 ShmDt(const VOID *shmaddr)
     /* remove it from aspace */
     LOS_RbDelNode(&space->regionRbTree, &region->rbNode);
     LOS_ArchMmuUnmap(&space->archMmu, region->range.base, region->range.size >> PAGE_SHIFT);
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     /* free it */
     free(region);
 
@@ -801,7 +801,7 @@ INT32 ShmDt(const VOID *shmaddr)
     return 0;
 
 ERROR_WITH_LOCK:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
 ERROR:
     set_errno(ret);
     PRINT_DEBUG("%s %d, ret = %d\n", __FUNCTION__, __LINE__, ret);
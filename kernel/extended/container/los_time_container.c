@@ -29,6 +29,9 @@
  */
 #include "los_time_container_pri.h"
 #include "los_process_pri.h"
+#ifdef LOSCFG_KERNEL_VDSO
+#include "los_vdso.h"
+#endif
 
 #ifdef LOSCFG_TIME_CONTAINER
 STATIC UINT32 g_currentTimeContainerNum;
@@ -141,6 +144,10 @@ UINT32 OsUnshareTimeContainer(UINTPTR flags, LosProcessCB *curr, Container *newC
     newContainer->timeForChildContainer = timeForChild;
     g_currentTimeContainerNum++;
     SCHEDULER_UNLOCK(intSave);
+#ifdef LOSCFG_KERNEL_VDSO
+    /* before any process can enter the new container, send CLOCK_MONOTONIC of the vdso to the syscall */
+    OsVdsoTimevalUpdate();
+#endif
     return LOS_OK;
 }
 
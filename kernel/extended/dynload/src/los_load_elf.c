@@ -754,7 +754,7 @@ STATIC UINT32 OsStackAlloc(LosVmSpace *space, VADDR_T vaddr, UINT32 vsize, UINT3
     PADDR_T paddrTemp;
     UINT32 len;
 
-    (VOID)LOS_MuxAcquire(&space->regionMux);
+    OsVmSpaceWrLock(space);
     kvaddr = LOS_PhysPagesAllocContiguous(psize >> PAGE_SHIFT);
     if (kvaddr == NULL) {
         goto OUT;
@@ -778,13 +778,13 @@ STATIC UINT32 OsStackAlloc(LosVmSpace *space, VADDR_T vaddr, UINT32 vsize, UINT3
         vaddrTemp += PAGE_SIZE;
         len -= PAGE_SIZE;
     }
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return LOS_OK;
 
 PFREE:
     (VOID)LOS_PhysPagesFreeContiguous(kvaddr, psize >> PAGE_SHIFT);
 OUT:
-    (VOID)LOS_MuxRelease(&space->regionMux);
+    OsVmSpaceWrUnlock(space);
     return LOS_NOK;
 }
 
@@ -35,6 +35,10 @@
 #include "los_mux.h"
 #include "los_process_pri.h"
 #include "los_task_pri.h"
+#include "los_spinlock.h"
+#include "los_atomic.h"
+#include "los_swtmr.h"
+#include "los_sys.h"
 #include "fs/file.h"
 #include "fs/driver.h"
 #include "los_vm_map.h"
@@ -44,6 +48,11 @@
 #define HILOG_BUFFER LOSCFG_HILOG_BUFFER_SIZE
 #define DRIVER_MODE 0666
 #define HILOG_DRIVER "/dev/hilog"
+/* the reader is woken once this many lines are pending, or this long after the first of them */
+#define HILOG_WAKEUP_LINES 16
+#define HILOG_WAKEUP_DELAY_MS 20
+/* lines written from userspace up to this size are staged on the stack */
+#define HILOG_LINE_ON_STACK 256
 
 struct HiLogEntry {
     unsigned int len;
@@ -56,6 +65,12 @@ struct HiLogEntry {
     char msg[0];
 };
 
+/* a line as stored in a ring: the sequence number orders it among the lines of all CPUs */
+struct HiLogRecord {
+    unsigned long long seq;
+    struct HiLogEntry entry;
+};
+
 ssize_t HilogRead(struct file *filep, char __user *buf, size_t count);
 ssize_t HilogWrite(struct file *filep, const char __user *buf, size_t count);
 int HiLogOpen(struct file *filep);
@@ -78,21 +93,32 @@ STATIC struct file_operations_vfs g_hilogFops = {
     NULL, /* unlink */
 };
 
-struct HiLogCharDevice {
-    int flag;
-    LosMux mtx;
+/*
+ * Each CPU writes to its own ring with interrupts disabled, so writers never contend with each other.
+ * The ring lock is only shared with the reader, which takes the oldest line of all the rings.
+ */
+struct HiLogRing {
+    SPIN_LOCK_S lock;
     unsigned char *buffer;
-    wait_queue_head_t wq;
     size_t writeOffset;
     size_t headOffset;
     size_t size;
     size_t count;
-} g_hiLogDev;
+    unsigned int dropLines;
+};
 
-static inline unsigned char *HiLogBufferHead(void)
-{
-    return g_hiLogDev.buffer + g_hiLogDev.headOffset;
-}
+struct HiLogCharDevice {
+    int flag;
+    LosMux mtx;
+    unsigned char *buffer;
+    wait_queue_head_t wq;
+    struct HiLogRing ring[LOSCFG_KERNEL_CORE_NUM];
+    unsigned char *readBuffer;
+    Atomic64 seq;
+    Atomic pending;
+    UINT16 wakeupTimer;
+    BOOL wakeupTimerValid;
+} g_hiLogDev;
 
 int HiLogOpen(struct file *filep)
 {
@@ -106,26 +132,6 @@ int HiLogClose(struct file *filep)
     return 0;
 }
 
-static void HiLogBufferInc(size_t sz)
-{
-    if (g_hiLogDev.size + sz <= HILOG_BUFFER) {
-        g_hiLogDev.size += sz;
-        g_hiLogDev.writeOffset += sz;
-        g_hiLogDev.writeOffset %= HILOG_BUFFER;
-        g_hiLogDev.count++;
-    }
-}
-
-static void HiLogBufferDec(size_t sz)
-{
-    if (g_hiLogDev.size >= sz) {
-        g_hiLogDev.size -= sz;
-        g_hiLogDev.headOffset += sz;
-        g_hiLogDev.headOffset %= HILOG_BUFFER;
-        g_hiLogDev.count--;
-    }
-}
-
 static int HiLogBufferCopy(unsigned char *dst, unsigned dstLen, const unsigned char *src, size_t srcLen)
 {
     int retval = -1;
@@ -146,91 +152,168 @@ static int HiLogBufferCopy(unsigned char *dst, unsigned dstLen, const unsigned c
     return retval;
 }
 
-static int HiLogReadRingBuffer(unsigned char *buffer, size_t bufLen)
+static void HiLogRingCopyOut(const struct HiLogRing *ring, size_t offset, unsigned char *dst, size_t len)
 {
-    int retval;
-    size_t bufLeft = HILOG_BUFFER - g_hiLogDev.headOffset;
-    if (bufLeft > bufLen) {
-        retval = HiLogBufferCopy(buffer, bufLen, HiLogBufferHead(), bufLen);
+    size_t bufLeft = HILOG_BUFFER - offset;
+
+    if (bufLeft >= len) {
+        (VOID)memcpy_s(dst, len, ring->buffer + offset, len);
+    } else {
+        (VOID)memcpy_s(dst, len, ring->buffer + offset, bufLeft);
+        (VOID)memcpy_s(dst + bufLeft, len - bufLeft, ring->buffer, len - bufLeft);
+    }
+}
+
+static void HiLogRingCopyIn(struct HiLogRing *ring, const unsigned char *src, size_t len)
+{
+    size_t bufLeft = HILOG_BUFFER - ring->writeOffset;
+
+    if (bufLeft >= len) {
+        (VOID)memcpy_s(ring->buffer + ring->writeOffset, bufLeft, src, len);
     } else {
-        retval = HiLogBufferCopy(buffer, bufLen, HiLogBufferHead(), bufLeft);
-        if (retval < 0) {
-            return retval;
+        (VOID)memcpy_s(ring->buffer + ring->writeOffset, bufLeft, src, bufLeft);
+        (VOID)memcpy_s(ring->buffer, HILOG_BUFFER, src + bufLeft, len - bufLeft);
+    }
+    ring->writeOffset = (ring->writeOffset + len) % HILOG_BUFFER;
+    ring->size += len;
+}
+
+static void HiLogRingConsume(struct HiLogRing *ring, const struct HiLogRecord *record)
+{
+    size_t len = sizeof(*record) + record->entry.len;
+
+    ring->headOffset = (ring->headOffset + len) % HILOG_BUFFER;
+    ring->size -= len;
+    ring->count--;
+}
+
+static void HiLogRingClear(struct HiLogRing *ring)
+{
+    ring->writeOffset = 0;
+    ring->headOffset = 0;
+    ring->size = 0;
+    ring->count = 0;
+}
+
+static BOOL HiLogReadable(void)
+{
+    UINT32 cpu;
+
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        if (g_hiLogDev.ring[cpu].size > 0) {
+            return TRUE;
         }
+    }
+    return FALSE;
+}
 
-        retval = HiLogBufferCopy(buffer + bufLeft, bufLen - bufLeft, g_hiLogDev.buffer, bufLen - bufLeft);
+/* find the ring whose first line is the oldest one of all */
+static struct HiLogRing *HiLogOldestRing(unsigned long long *seq)
+{
+    struct HiLogRing *oldest = NULL;
+    unsigned long long ringSeq;
+    UINT32 intSave;
+    UINT32 cpu;
+
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        struct HiLogRing *ring = &g_hiLogDev.ring[cpu];
+        LOS_SpinLockSave(&ring->lock, &intSave);
+        if (ring->size > 0) {
+            HiLogRingCopyOut(ring, ring->headOffset, (unsigned char *)&ringSeq, sizeof(ringSeq));
+            if ((oldest == NULL) || (ringSeq < *seq)) {
+                oldest = ring;
+                *seq = ringSeq;
+            }
+        }
+        LOS_SpinUnlockRestore(&ring->lock, intSave);
     }
+    return oldest;
+}
+
+/* take the line found by HiLogOldestRing out of its ring, unless a writer has overwritten it since */
+static int HiLogRingPop(struct HiLogRing *ring, unsigned long long seq, struct HiLogRecord *record,
+                        size_t bufLen, unsigned int *dropLines)
+{
+    int retval = 0;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&ring->lock, &intSave);
+    if (ring->size == 0) {
+        retval = -EAGAIN;
+        goto out;
+    }
+
+    HiLogRingCopyOut(ring, ring->headOffset, (unsigned char *)record, sizeof(*record));
+    if (record->seq != seq) {
+        retval = -EAGAIN;
+        goto out;
+    }
+
+    *dropLines = ring->dropLines;
+    ring->dropLines = 0;
+    if (bufLen < record->entry.len + sizeof(record->entry)) {
+        // clean ring buffer
+        HiLogRingClear(ring);
+        retval = -ENOMEM;
+        goto out;
+    }
+
+    HiLogRingCopyOut(ring, (ring->headOffset + sizeof(*record)) % HILOG_BUFFER, g_hiLogDev.readBuffer,
+                     record->entry.len);
+    HiLogRingConsume(ring, record);
+out:
+    LOS_SpinUnlockRestore(&ring->lock, intSave);
     return retval;
 }
 
 static ssize_t HiLogRead(struct file *filep, char *buffer, size_t bufLen)
 {
     int retval;
-    struct HiLogEntry header;
+    struct HiLogRecord record;
+    struct HiLogRing *ring = NULL;
+    unsigned long long seq = 0;
+    unsigned int dropLines = 0;
 
     (void)filep;
-    wait_event_interruptible(g_hiLogDev.wq, (g_hiLogDev.size > 0));
+    do {
+        wait_event_interruptible(g_hiLogDev.wq, HiLogReadable());
+
+        (VOID)LOS_MuxAcquire(&g_hiLogDev.mtx);
+        ring = HiLogOldestRing(&seq);
+        retval = (ring != NULL) ? HiLogRingPop(ring, seq, &record, bufLen, &dropLines) : -EAGAIN;
+        if (retval == -EAGAIN) {
+            (VOID)LOS_MuxRelease(&g_hiLogDev.mtx);
+        }
+    } while (retval == -EAGAIN);
 
-    (VOID)LOS_MuxAcquire(&g_hiLogDev.mtx);
-    retval = HiLogReadRingBuffer((unsigned char *)&header, sizeof(header));
-    if (retval < 0) {
-        retval = -EINVAL;
-        goto out;
+    if (dropLines > 0) {
+        PRINTK("hilog ringbuffer full, drop %u line(s) log\n", dropLines);
     }
 
-    if (bufLen < header.len + sizeof(header)) {
-        PRINTK("buffer too small,bufLen=%d, header.len=%d,%d\n", bufLen, header.len, header.hdrSize);
-        retval = -ENOMEM;
+    if (retval == -ENOMEM) {
+        PRINTK("buffer too small,bufLen=%d, header.len=%d,%d\n", bufLen, record.entry.len, record.entry.hdrSize);
         goto out;
     }
 
-    HiLogBufferDec(sizeof(header));
-
-    retval = HiLogBufferCopy((unsigned char *)buffer, bufLen, (unsigned char *)&header, sizeof(header));
-    if (retval < 0) {
+    retval = HiLogBufferCopy((unsigned char *)buffer, bufLen, (unsigned char *)&record.entry, sizeof(record.entry));
+    if (retval != 0) {
         retval = -EINVAL;
         goto out;
     }
 
-    retval = HiLogReadRingBuffer((unsigned char *)(buffer + sizeof(header)), header.len);
-    if (retval < 0) {
+    retval = HiLogBufferCopy((unsigned char *)(buffer + sizeof(record.entry)), bufLen - sizeof(record.entry),
+                             g_hiLogDev.readBuffer, record.entry.len);
+    if (retval != 0) {
         retval = -EINVAL;
         goto out;
     }
 
-    HiLogBufferDec(header.len);
-    retval = header.len + sizeof(header);
+    retval = record.entry.len + sizeof(record.entry);
 out:
-    if (retval == -ENOMEM) {
-        // clean ring buffer
-        g_hiLogDev.writeOffset = 0;
-        g_hiLogDev.headOffset = 0;
-        g_hiLogDev.size = 0;
-        g_hiLogDev.count = 0;
-    }
     (VOID)LOS_MuxRelease(&g_hiLogDev.mtx);
     return (ssize_t)retval;
 }
 
-static int HiLogWriteRingBuffer(unsigned char *buffer, size_t bufLen)
-{
-    int retval;
-    size_t bufLeft = HILOG_BUFFER - g_hiLogDev.writeOffset;
-    if (bufLen > bufLeft) {
-        retval = HiLogBufferCopy(g_hiLogDev.buffer + g_hiLogDev.writeOffset, bufLeft, buffer, bufLeft);
-        if (retval) {
-            return -1;
-        }
-        retval = HiLogBufferCopy(g_hiLogDev.buffer, HILOG_BUFFER, buffer + bufLeft, bufLen - bufLeft);
-    } else {
-        retval = HiLogBufferCopy(g_hiLogDev.buffer + g_hiLogDev.writeOffset, bufLeft, buffer, bufLen);
-    }
-    if (retval < 0) {
-        return -1;
-    }
-    return 0;
-}
-
 static void HiLogHeadInit(struct HiLogEntry *header, size_t len)
 {
     struct timespec now = {0};
@@ -244,95 +327,119 @@ static void HiLogHeadInit(struct HiLogEntry *header, size_t len)
     header->hdrSize = sizeof(struct HiLogEntry);
 }
 
-static void HiLogCoverOldLog(size_t bufLen)
+static void HiLogWakeup(void)
 {
-    int retval;
-    struct HiLogEntry header;
-    size_t totalSize = bufLen + sizeof(struct HiLogEntry);
-    static int dropLogLines = 0;
-    static int isLastTimeFull = 0;
-    int isThisTimeFull = 0;
-
-    while (totalSize + g_hiLogDev.size > HILOG_BUFFER) {
-        retval = HiLogReadRingBuffer((unsigned char *)&header, sizeof(header));
-        if (retval < 0) {
-            break;
-        }
+    LOS_AtomicSet(&g_hiLogDev.pending, 0);
+    wake_up_interruptible(&g_hiLogDev.wq);
+}
 
-        dropLogLines++;
-        isThisTimeFull = 1;
-        isLastTimeFull = 1;
-        HiLogBufferDec(sizeof(header));
-        HiLogBufferDec(header.len);
+static void HiLogWakeupTimeout(UINTPTR arg)
+{
+    (void)arg;
+    if (LOS_AtomicRead(&g_hiLogDev.pending) != 0) {
+        HiLogWakeup();
     }
-    if (isLastTimeFull == 1 && isThisTimeFull == 0) {
-        /* so we can only print one log if hilog ring buffer is full in a short time */
-        if (dropLogLines > 0) {
-            PRINTK("hilog ringbuffer full, drop %d line(s) log\n", dropLogLines);
-        }
-        isLastTimeFull = 0;
-        dropLogLines = 0;
+}
+
+/* wake the reader once for a batch of lines rather than for every line */
+static void HiLogWakeupReader(void)
+{
+    INT32 pending = LOS_AtomicIncRet(&g_hiLogDev.pending);
+
+    if (!g_hiLogDev.wakeupTimerValid || (pending >= HILOG_WAKEUP_LINES)) {
+        HiLogWakeup();
+    } else if (pending == 1) {
+        (VOID)LOS_SwtmrStart(g_hiLogDev.wakeupTimer);
     }
 }
 
+static BOOL HiLogLineTooLarge(size_t bufLen)
+{
+    size_t totalBufLen = bufLen + sizeof(struct HiLogRecord);
+
+    return (totalBufLen < bufLen) || (totalBufLen > HILOG_BUFFER);
+}
+
+/* buffer must be in kernel space; this may be called from any context, including interrupts */
 int HiLogWriteInternal(const char *buffer, size_t bufLen)
 {
-    struct HiLogEntry header = {0};
-    int retval;
-    LosTaskCB *runTask =  (LosTaskCB *)OsCurrTaskGet();
+    struct HiLogRecord record = {0};
+    struct HiLogRing *ring = NULL;
+    size_t totalSize = bufLen + sizeof(record);
+    UINT32 intSave;
 
-    if ((g_hiLogDev.buffer == NULL) || (OS_INT_ACTIVE) || (runTask->taskStatus & OS_TASK_FLAG_SYSTEM_TASK)) {
+    if (g_hiLogDev.buffer == NULL) {
         PRINTK("%s\n", buffer);
         return -EAGAIN;
     }
 
-    (VOID)LOS_MuxAcquire(&g_hiLogDev.mtx);
-    HiLogCoverOldLog(bufLen);
-    HiLogHeadInit(&header, bufLen);
-
-    retval = HiLogWriteRingBuffer((unsigned char *)&header, sizeof(header));
-    if (retval) {
-        retval = -ENODATA;
-        goto out;
+    if (HiLogLineTooLarge(bufLen)) {
+        PRINTK("input bufLen %lld too large\n", bufLen);
+        return -ENOMEM;
     }
-    HiLogBufferInc(sizeof(header));
 
-    retval = HiLogWriteRingBuffer((unsigned char *)(buffer), header.len);
-    if (retval) {
-        retval = -ENODATA;
-        goto out;
-    }
+    HiLogHeadInit(&record.entry, bufLen);
 
-    HiLogBufferInc(header.len);
+    intSave = LOS_IntLock();
+    ring = &g_hiLogDev.ring[ArchCurrCpuid()];
+    LOS_SpinLock(&ring->lock);
+    while (totalSize + ring->size > HILOG_BUFFER) {
+        struct HiLogRecord oldest;
+        HiLogRingCopyOut(ring, ring->headOffset, (unsigned char *)&oldest, sizeof(oldest));
+        HiLogRingConsume(ring, &oldest);
+        ring->dropLines++;
+    }
 
-    retval = header.len;
+    record.seq = (unsigned long long)LOS_Atomic64IncRet(&g_hiLogDev.seq);
+    HiLogRingCopyIn(ring, (const unsigned char *)&record, sizeof(record));
+    HiLogRingCopyIn(ring, (const unsigned char *)buffer, bufLen);
+    ring->count++;
+    LOS_SpinUnlock(&ring->lock);
+    LOS_IntRestore(intSave);
 
-out:
-    (VOID)LOS_MuxRelease(&g_hiLogDev.mtx);
-    if (retval > 0) {
-        wake_up_interruptible(&g_hiLogDev.wq);
-    }
-    if (retval < 0) {
-        PRINTK("write fail retval=%d\n", retval);
-    }
-    return retval;
+    HiLogWakeupReader();
+    return (int)bufLen;
 }
 
 static ssize_t HiLogWrite(struct file *filep, const char *buffer, size_t bufLen)
 {
+    char line[HILOG_LINE_ON_STACK];
+    char *kbuf = line;
+    int retval;
+
     (void)filep;
-    size_t totalBufLen = bufLen + sizeof(struct HiLogEntry);
-    if ((totalBufLen < bufLen) || (totalBufLen > HILOG_BUFFER)) {
+    if (HiLogLineTooLarge(bufLen)) {
         PRINTK("input bufLen %lld too large\n", bufLen);
         return -ENOMEM;
     }
 
-    return HiLogWriteInternal(buffer, bufLen);
+    /* the rings are written with interrupts disabled, so the line is brought into the kernel first */
+    if (bufLen > sizeof(line)) {
+        kbuf = LOS_MemAlloc((VOID *)OS_SYS_MEM_ADDR, bufLen);
+        if (kbuf == NULL) {
+            return -ENOMEM;
+        }
+    }
+
+    retval = HiLogBufferCopy((unsigned char *)kbuf, bufLen, (const unsigned char *)buffer, bufLen);
+    if (retval != 0) {
+        retval = -EFAULT;
+    } else {
+        retval = HiLogWriteInternal(kbuf, bufLen);
+    }
+
+    if (kbuf != line) {
+        (VOID)LOS_MemFree((VOID *)OS_SYS_MEM_ADDR, kbuf);
+    }
+    return retval;
 }
 
 static void HiLogDeviceInit(void)
 {
-    g_hiLogDev.buffer = LOS_MemAlloc((VOID *)OS_SYS_MEM_ADDR, HILOG_BUFFER);
+    UINT32 cpu;
+
+    /* one ring per CPU, followed by the buffer a line is read into */
+    g_hiLogDev.buffer = LOS_MemAlloc((VOID *)OS_SYS_MEM_ADDR, HILOG_BUFFER * (LOSCFG_KERNEL_CORE_NUM + 1));
     if (g_hiLogDev.buffer == NULL) {
         PRINTK("In %s line %d,LOS_MemAlloc fail\n", __FUNCTION__, __LINE__);
     }
@@ -340,10 +447,21 @@ static void HiLogDeviceInit(void)
     init_waitqueue_head(&g_hiLogDev.wq);
     LOS_MuxInit(&g_hiLogDev.mtx, NULL);
 
-    g_hiLogDev.writeOffset = 0;
-    g_hiLogDev.headOffset = 0;
-    g_hiLogDev.size = 0;
-    g_hiLogDev.count = 0;
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        struct HiLogRing *ring = &g_hiLogDev.ring[cpu];
+        LOS_SpinInit(&ring->lock);
+        ring->buffer = (g_hiLogDev.buffer != NULL) ? (g_hiLogDev.buffer + cpu * HILOG_BUFFER) : NULL;
+        ring->dropLines = 0;
+        HiLogRingClear(ring);
+    }
+    g_hiLogDev.readBuffer = (g_hiLogDev.buffer != NULL) ?
+                            (g_hiLogDev.buffer + LOSCFG_KERNEL_CORE_NUM * HILOG_BUFFER) : NULL;
+
+    LOS_Atomic64Set(&g_hiLogDev.seq, 0);
+    LOS_AtomicSet(&g_hiLogDev.pending, 0);
+    g_hiLogDev.wakeupTimerValid = (LOS_SwtmrCreate(LOS_MS2Tick(HILOG_WAKEUP_DELAY_MS), LOS_SWTMR_MODE_NO_SELFDELETE,
+                                                   (SWTMR_PROC_FUNC)HiLogWakeupTimeout, &g_hiLogDev.wakeupTimer,
+                                                   0) == LOS_OK);
 }
 
 int OsHiLogDriverInit(VOID)
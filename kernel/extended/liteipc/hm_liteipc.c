@@ -160,7 +160,7 @@ LITE_OS_SEC_TEXT STATIC INT32 DoIpcMmap(LosProcessCB *pcb, LosVmMapRegion *regio
     VADDR_T uva = (VADDR_T)(UINTPTR)pcb->ipcInfo->pool.uvaddr;
     VADDR_T kva = (VADDR_T)(UINTPTR)pcb->ipcInfo->pool.kvaddr;
 
-    (VOID)LOS_MuxAcquire(&pcb->vmSpace->regionMux);
+    OsVmSpaceWrLock(pcb->vmSpace);
 
     for (i = 0; i < (region->range.size >> PAGE_SHIFT); i++) {
         pa = LOS_PaddrQuery((VOID *)(UINTPTR)(kva + (i << PAGE_SHIFT)));
@@ -192,7 +192,7 @@ LITE_OS_SEC_TEXT STATIC INT32 DoIpcMmap(LosProcessCB *pcb, LosVmMapRegion *regio
         }
     }
 
-    (VOID)LOS_MuxRelease(&pcb->vmSpace->regionMux);
+    OsVmSpaceWrUnlock(pcb->vmSpace);
     return ret;
 }
 
@@ -1098,7 +1098,6 @@ LITE_OS_SEC_TEXT STATIC UINT32 LiteIpcWrite(IpcContent *content)
         OsTaskWakeClearPendMask(tcb);
         tcb->ops->wake(tcb);
         SCHEDULER_UNLOCK(intSave);
-        LOS_MpSchedule(OS_MP_CPU_ALL);
         LOS_Schedule();
     } else {
         SCHEDULER_UNLOCK(intSave);
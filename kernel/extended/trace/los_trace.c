@@ -38,6 +38,7 @@
 #include "los_init.h"
 #include "los_process.h"
 #include "los_sched_pri.h"
+#include "los_atomic.h"
 
 #ifdef LOSCFG_KERNEL_SMP
 #include "los_mp.h"
@@ -48,7 +49,7 @@
 #include "shell.h"
 #endif
 
-LITE_OS_SEC_BSS STATIC UINT32 g_traceEventCount;
+LITE_OS_SEC_BSS STATIC Atomic g_traceEventCount;
 LITE_OS_SEC_BSS STATIC volatile enum TraceState g_traceState = TRACE_UNINIT;
 LITE_OS_SEC_DATA_INIT STATIC volatile BOOL g_enableTrace = FALSE;
 LITE_OS_SEC_BSS STATIC UINT32 g_traceMask = TRACE_DEFAULT_MASK;
@@ -93,7 +94,8 @@ STATIC VOID OsTraceSetFrame(TraceEventFrame *frame, UINT32 eventType, UINTPTR id
         paramCount = LOSCFG_TRACE_FRAME_MAX_PARAMS;
     }
 
-    TRACE_LOCK(intSave);
+    /* nothing here is shared between cpus, keep the current cpu and task stable while sampling them */
+    intSave = LOS_IntLock();
     frame->curTask   = OsTraceGetMaskTid(LOS_CurTaskIDGet());
     frame->curPid    = LOS_GetCurrProcessID();
     frame->identity  = identity;
@@ -113,10 +115,9 @@ STATIC VOID OsTraceSetFrame(TraceEventFrame *frame, UINT32 eventType, UINTPTR id
 #endif
 
 #ifdef LOSCFG_TRACE_FRAME_EVENT_COUNT
-    frame->eventCount = g_traceEventCount;
-    g_traceEventCount++;
+    frame->eventCount = (UINT32)LOS_AtomicIncRet(&g_traceEventCount) - 1;
 #endif
-    TRACE_UNLOCK(intSave);
+    LOS_IntRestore(intSave);
 
     for (i = 0; i < paramCount; i++) {
         frame->params[i] = params[i];
@@ -281,7 +282,7 @@ STATIC UINT32 OsTraceInit(VOID)
     OsTraceHookInstall();
     OsTraceCnvInit();
 
-    g_traceEventCount = 0;
+    LOS_AtomicSet(&g_traceEventCount, 0);
 
 #ifdef LOSCFG_RECORDER_MODE_ONLINE  /* Wait trace client to start trace */
     g_enableTrace = FALSE;
@@ -359,6 +360,11 @@ OfflineHead *LOS_TraceRecordGet(VOID)
     return OsTraceRecordGet();
 }
 
+UINT32 LOS_TraceRecordExport(VOID *buf, UINT32 size)
+{
+    return OsTraceRecordExport((UINT8 *)buf, size);
+}
+
 VOID LOS_TraceReset(VOID)
 {
     if (g_traceState == TRACE_UNINIT) {
@@ -107,8 +107,8 @@ typedef struct {
  */
 typedef struct {
     struct WriteCtrl {
-        UINT16 curIndex;            /* The current record index */
-        UINT16 maxRecordCount;      /* The max num of track items */
+        UINT16 curIndex[LOSCFG_KERNEL_CORE_NUM]; /* The current record index of each cpu */
+        UINT16 maxRecordCount;      /* The max num of track items of each cpu */
         UINT16 curObjIndex;         /* The current obj index */
         UINT16 maxObjCount;         /* The max num of obj index */
         ObjData *objBuf;            /* Pointer to obj info data */
@@ -123,6 +123,7 @@ extern VOID OsTraceWriteOrSendEvent(const TraceEventFrame *frame);
 extern VOID OsTraceObjAdd(UINT32 eventType, UINT32 taskId);
 extern BOOL OsTraceIsEnable(VOID);
 extern OfflineHead *OsTraceRecordGet(VOID);
+extern UINT32 OsTraceRecordExport(UINT8 *buf, UINT32 size);
 
 #ifdef LOSCFG_RECORDER_MODE_ONLINE
 extern VOID OsTraceSendHead(VOID);
@@ -34,6 +34,16 @@
 
 #define BITS_NUM_FOR_TASK_ID 16
 
+/* every cpu records its events to its own ring of maxRecordCount frames */
+#define OS_TRACE_CPU_FRAME(cpuid, index) \
+    (&g_traceRecoder.ctrl.frameBuf[(UINT32)(cpuid) * g_traceRecoder.ctrl.maxRecordCount + (index)])
+
+/* walks the frames of all the cpu rings in timestamp order */
+typedef struct {
+    UINT16 next[LOSCFG_KERNEL_CORE_NUM];    /* The next frame index of each cpu */
+    UINT16 left[LOSCFG_KERNEL_CORE_NUM];    /* The number of frames of each cpu not walked yet */
+} TraceMergeCursor;
+
 LITE_OS_SEC_BSS STATIC TraceOfflineHeaderInfo g_traceRecoder;
 LITE_OS_SEC_BSS STATIC UINT32 g_tidMask[LOSCFG_BASE_CORE_TSK_LIMIT] = {0};
 
@@ -45,10 +55,12 @@ UINT32 OsTraceGetMaskTid(UINT32 tid)
 UINT32 OsTraceBufInit(UINT32 size)
 {
     UINT32 headSize;
+    UINT32 cpuid;
     VOID *buf = NULL;
     headSize = sizeof(OfflineHead) + sizeof(ObjData) * LOSCFG_TRACE_OBJ_MAX_NUM;
-    if (size <= headSize) {
-        TRACE_ERROR("trace buf size not enough than 0x%x\n", headSize);
+    if (size < headSize + sizeof(TraceEventFrame) * LOSCFG_KERNEL_CORE_NUM) {
+        TRACE_ERROR("trace buf size not enough than 0x%x\n",
+                    headSize + sizeof(TraceEventFrame) * LOSCFG_KERNEL_CORE_NUM);
         return LOS_ERRNO_TRACE_BUF_TOO_SMALL;
     }
 
@@ -69,10 +81,12 @@ UINT32 OsTraceBufInit(UINT32 size)
     g_traceRecoder.head->frameOffset              = headSize;
     g_traceRecoder.head->totalLen                 = size;
 
-    g_traceRecoder.ctrl.curIndex       = 0;
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        g_traceRecoder.ctrl.curIndex[cpuid] = 0;
+    }
     g_traceRecoder.ctrl.curObjIndex    = 0;
     g_traceRecoder.ctrl.maxObjCount    = LOSCFG_TRACE_OBJ_MAX_NUM;
-    g_traceRecoder.ctrl.maxRecordCount = (size - headSize) / sizeof(TraceEventFrame);
+    g_traceRecoder.ctrl.maxRecordCount = (size - headSize) / sizeof(TraceEventFrame) / LOSCFG_KERNEL_CORE_NUM;
     g_traceRecoder.ctrl.objBuf         = (ObjData *)((UINTPTR)buf + g_traceRecoder.head->objOffset);
     g_traceRecoder.ctrl.frameBuf       = (TraceEventFrame *)((UINTPTR)buf + g_traceRecoder.head->frameOffset);
 
@@ -108,34 +122,87 @@ VOID OsTraceObjAdd(UINT32 eventType, UINT32 taskId)
     TRACE_UNLOCK(intSave);
 }
 
+/* only the current cpu writes to its ring, so disabling interrupts is enough */
 VOID OsTraceWriteOrSendEvent(const TraceEventFrame *frame)
 {
     UINT16 index;
+    UINT32 cpuid;
     UINT32 intSave;
 
-    TRACE_LOCK(intSave);
-    index = g_traceRecoder.ctrl.curIndex;
-    (VOID)memcpy_s(&g_traceRecoder.ctrl.frameBuf[index], sizeof(TraceEventFrame), frame, sizeof(TraceEventFrame));
+    intSave = LOS_IntLock();
+    cpuid = ArchCurrCpuid();
+    index = g_traceRecoder.ctrl.curIndex[cpuid];
+    (VOID)memcpy_s(OS_TRACE_CPU_FRAME(cpuid, index), sizeof(TraceEventFrame), frame, sizeof(TraceEventFrame));
 
-    g_traceRecoder.ctrl.curIndex++;
-    if (g_traceRecoder.ctrl.curIndex >= g_traceRecoder.ctrl.maxRecordCount) {
-        g_traceRecoder.ctrl.curIndex = 0;
+    index++;
+    if (index >= g_traceRecoder.ctrl.maxRecordCount) {
+        index = 0;
     }
-    TRACE_UNLOCK(intSave);
+    g_traceRecoder.ctrl.curIndex[cpuid] = index;
+    LOS_IntRestore(intSave);
 }
 
 VOID OsTraceReset(VOID)
 {
     UINT32 intSave;
     UINT32 bufLen;
+    UINT32 cpuid;
 
     TRACE_LOCK(intSave);
-    bufLen = sizeof(TraceEventFrame) * g_traceRecoder.ctrl.maxRecordCount;
+    bufLen = sizeof(TraceEventFrame) * g_traceRecoder.ctrl.maxRecordCount * LOSCFG_KERNEL_CORE_NUM;
     (VOID)memset_s(g_traceRecoder.ctrl.frameBuf, bufLen, 0, bufLen);
-    g_traceRecoder.ctrl.curIndex = 0;
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        g_traceRecoder.ctrl.curIndex[cpuid] = 0;
+    }
     TRACE_UNLOCK(intSave);
 }
 
+STATIC VOID OsTraceMergeInit(TraceMergeCursor *cursor)
+{
+    UINT32 cpuid;
+    UINT16 index;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        index = g_traceRecoder.ctrl.curIndex[cpuid];
+        if (OS_TRACE_CPU_FRAME(cpuid, index)->curTime != 0) {
+            /* the ring has wrapped, the oldest frame is the next one to be overwritten */
+            cursor->next[cpuid] = index;
+            cursor->left[cpuid] = g_traceRecoder.ctrl.maxRecordCount;
+        } else {
+            cursor->next[cpuid] = 0;
+            cursor->left[cpuid] = index;
+        }
+    }
+}
+
+STATIC TraceEventFrame *OsTraceMergeNext(TraceMergeCursor *cursor)
+{
+    TraceEventFrame *oldest = NULL;
+    TraceEventFrame *frame = NULL;
+    UINT32 oldestCpu = 0;
+    UINT32 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        if (cursor->left[cpuid] == 0) {
+            continue;
+        }
+        frame = OS_TRACE_CPU_FRAME(cpuid, cursor->next[cpuid]);
+        if ((oldest == NULL) || (frame->curTime < oldest->curTime)) {
+            oldest = frame;
+            oldestCpu = cpuid;
+        }
+    }
+
+    if (oldest != NULL) {
+        cursor->next[oldestCpu]++;
+        if (cursor->next[oldestCpu] >= g_traceRecoder.ctrl.maxRecordCount) {
+            cursor->next[oldestCpu] = 0;
+        }
+        cursor->left[oldestCpu]--;
+    }
+    return oldest;
+}
+
 STATIC VOID OsTraceInfoObj(VOID)
 {
     UINT32 i;
@@ -153,7 +220,11 @@ STATIC VOID OsTraceInfoObj(VOID)
 
 STATIC VOID OsTraceInfoEventTitle(VOID)
 {
-    PRINTK("CurEvtIndex = %u\n", g_traceRecoder.ctrl.curIndex);
+    UINT32 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        PRINTK("Cpu%u CurEvtIndex = %u\n", cpuid, g_traceRecoder.ctrl.curIndex[cpuid]);
+    }
 
     PRINTK("Index   Time(cycles)      EventType      CurPid   CurTask   Identity      ");
 #ifdef LOSCFG_TRACE_FRAME_CORE_MSG
@@ -178,20 +249,15 @@ STATIC VOID OsTraceInfoEventTitle(VOID)
 STATIC VOID OsTraceInfoEventData(VOID)
 {
     UINT32 i, j;
-    TraceEventFrame *frame = &g_traceRecoder.ctrl.frameBuf[0];
+    TraceEventFrame *frame = NULL;
+    TraceMergeCursor cursor;
 
-    for (i = 0; i < g_traceRecoder.ctrl.maxRecordCount; i++, frame++) {
+    OsTraceMergeInit(&cursor);
+    for (i = 0; (frame = OsTraceMergeNext(&cursor)) != NULL; i++) {
         PRINTK("%-7u 0x%-15llx 0x%-12x 0x%-7x 0x%-7x 0x%-11x ", i, frame->curTime, frame->eventType,
             frame->curPid, frame->curTask, frame->identity);
 #ifdef LOSCFG_TRACE_FRAME_CORE_MSG
         UINT32 taskLockCnt = frame->core.taskLockCnt;
-#ifdef LOSCFG_KERNEL_SMP
-        /*
-         * For smp systems, TRACE_LOCK will request taskLock, and this counter
-         * will increase by 1 in that case.
-         */
-        taskLockCnt -= 1;
-#endif
         PRINTK("%-11u %-11u %-11u", frame->core.cpuid, frame->core.hwiActive, taskLockCnt);
 #endif
 #ifdef LOSCFG_TRACE_FRAME_EVENT_COUNT
@@ -230,6 +296,7 @@ STATIC VOID OsTraceSendInfo(VOID)
     UINT32 i;
     ObjData *obj = NULL;
     TraceEventFrame *frame = NULL;
+    TraceMergeCursor cursor;
 
     OsTraceDataSend(HEAD, sizeof(OfflineHead), (UINT8 *)g_traceRecoder.head);
 
@@ -238,9 +305,9 @@ STATIC VOID OsTraceSendInfo(VOID)
         OsTraceDataSend(OBJ, sizeof(ObjData), (UINT8 *)(obj + i));
     }
 
-    frame = &g_traceRecoder.ctrl.frameBuf[0];
-    for (i = 0; i < g_traceRecoder.ctrl.maxRecordCount; i++) {
-        OsTraceDataSend(EVENT, sizeof(TraceEventFrame), (UINT8 *)(frame + i));
+    OsTraceMergeInit(&cursor);
+    while ((frame = OsTraceMergeNext(&cursor)) != NULL) {
+        OsTraceDataSend(EVENT, sizeof(TraceEventFrame), (UINT8 *)frame);
     }
 }
 #endif
@@ -261,3 +328,41 @@ OfflineHead *OsTraceRecordGet(VOID)
 {
     return g_traceRecoder.head;
 }
+
+STATIC VOID OsTraceExportCopy(UINT8 *buf, UINT32 size, UINT32 *pos, const VOID *src, UINT32 len)
+{
+    len = (len < (size - *pos)) ? len : (size - *pos);
+    if (len == 0) {
+        return;
+    }
+
+    if (src != NULL) {
+        (VOID)memcpy_s(buf + *pos, size - *pos, src, len);
+    } else {
+        (VOID)memset_s(buf + *pos, size - *pos, 0, len);
+    }
+    *pos += len;
+}
+
+/* the record laid out as by OsTraceRecordGet, but with the events of all the cpus in timestamp order */
+UINT32 OsTraceRecordExport(UINT8 *buf, UINT32 size)
+{
+    UINT32 pos = 0;
+    TraceEventFrame *frame = NULL;
+    TraceMergeCursor cursor;
+    OfflineHead *head = g_traceRecoder.head;
+
+    if ((head == NULL) || (buf == NULL)) {
+        return 0;
+    }
+
+    size = (size < head->totalLen) ? size : head->totalLen;
+    OsTraceExportCopy(buf, size, &pos, head, head->frameOffset);
+
+    OsTraceMergeInit(&cursor);
+    while ((pos < size) && ((frame = OsTraceMergeNext(&cursor)) != NULL)) {
+        OsTraceExportCopy(buf, size, &pos, frame, sizeof(TraceEventFrame));
+    }
+    OsTraceExportCopy(buf, size, &pos, NULL, size - pos);
+    return pos;
+}
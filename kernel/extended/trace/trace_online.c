@@ -96,3 +96,10 @@ OfflineHead *OsTraceRecordGet(VOID)
 {
     return NULL;
 }
+
+UINT32 OsTraceRecordExport(UINT8 *buf, UINT32 size)
+{
+    (VOID)buf;
+    (VOID)size;
+    return 0;
+}
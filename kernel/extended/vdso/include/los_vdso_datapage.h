@@ -46,8 +46,19 @@ typedef struct {
     INT64 realTimeNsec;
     INT64 monoTimeSec;
     INT64 monoTimeNsec;
-    /* lock DataPage  0:Unlock State  1:Lock State */
-    UINT64 lockCount;
+    /* cycle counter value the timevals above were taken at */
+    UINT64 cycleLast;
+    /* largest cycle delta user space may extrapolate over */
+    UINT64 cycleMax;
+    /* cycles to nanoseconds: ns = (cycles * mult) >> shift */
+    UINT32 mult;
+    UINT32 shift;
+    /* 1: the cycle counter is readable from user mode */
+    UINT32 highRes;
+    /* 1: a time container may offset CLOCK_MONOTONIC, which the data page does not know per process */
+    UINT32 monoOffset;
+    /* odd while the kernel updates DataPage */
+    UINT32 seq;
 } VdsoDataPage;
 
 #define ELF_HEAD "\177ELF"
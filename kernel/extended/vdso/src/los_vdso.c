@@ -36,19 +36,60 @@
 #include "los_vm_lock.h"
 #include "los_vm_phys.h"
 #include "los_process_pri.h"
+#include "los_spinlock.h"
+
+/* longest stretch without a tick that user space still extrapolates over */
+#define VDSO_CYCLE_MAX_SEC  10
 
 LITE_VDSO_DATAPAGE VdsoDataPage g_vdsoDataPage __attribute__((__used__));
 
 STATIC size_t g_vdsoSize;
+STATIC SPIN_LOCK_INIT(g_vdsoSpin);
+
+/*
+ * Pick the largest shift whose mult keeps (cycleMax * mult) within 64 bits. mult is
+ * rounded down, so an extrapolated time never runs ahead of the next tick's snapshot.
+ */
+STATIC VOID OsVdsoMultShiftCalc(VdsoDataPage *vdsoDataPage, UINT32 freq)
+{
+    UINT64 cycleMax = (UINT64)VDSO_CYCLE_MAX_SEC * freq;
+    UINT64 tmp = cycleMax >> 32; /* 32: bits of mult */
+    UINT32 shiftAcc = 32;        /* 32: bits of mult */
+    UINT32 shift;
+
+    while (tmp) {
+        tmp >>= 1;
+        shiftAcc--;
+    }
+
+    for (shift = 32; shift > 0; shift--) { /* 32: bits of mult */
+        tmp = ((UINT64)OS_SYS_NS_PER_SECOND << shift) / freq;
+        if ((tmp >> shiftAcc) == 0) {
+            break;
+        }
+    }
+
+    vdsoDataPage->cycleMax = cycleMax;
+    vdsoDataPage->mult = (UINT32)tmp;
+    vdsoDataPage->shift = shift;
+}
 
 UINT32 OsVdsoInit(VOID)
 {
+    VdsoDataPage *kVdsoDataPage = (VdsoDataPage *)(&__vdso_data_start);
+
     g_vdsoSize = &__vdso_text_end - &__vdso_data_start;
 
     if (memcmp((CHAR *)(&__vdso_text_start), ELF_HEAD, ELF_HEAD_LEN)) {
         PRINT_ERR("VDSO Init Failed!\n");
         return LOS_NOK;
     }
+
+    if (g_sysClock != 0) {
+        OsVdsoMultShiftCalc(kVdsoDataPage, g_sysClock);
+        /* HalClockStart opens the cycle counter to user mode on every core */
+        kVdsoDataPage->highRes = 1;
+    }
     return LOS_OK;
 }
 
@@ -81,7 +122,7 @@ vaddr_t OsVdsoLoad(const LosProcessCB *processCB)
         return 0;
     }
 
-    (VOID)LOS_MuxAcquire(&processCB->vmSpace->regionMux);
+    OsVmSpaceWrLock(processCB->vmSpace);
 
     vdsoRegion = LOS_RegionAlloc(processCB->vmSpace, 0, g_vdsoSize, flag, 0);
     if (vdsoRegion == NULL) {
@@ -101,7 +142,7 @@ vaddr_t OsVdsoLoad(const LosProcessCB *processCB)
     }
 
 LOCK_RELEASE:
-    (VOID)LOS_MuxRelease(&processCB->vmSpace->regionMux);
+    OsVmSpaceWrUnlock(processCB->vmSpace);
     if (ret == LOS_OK) {
         return (vdsoRegion->range.base + PAGE_SIZE);
     }
@@ -110,21 +151,25 @@ LOCK_RELEASE:
 
 STATIC VOID LockVdsoDataPage(VdsoDataPage *vdsoDataPage)
 {
-    vdsoDataPage->lockCount = 1;
+    vdsoDataPage->seq++;
     DMB;
 }
 
 STATIC VOID UnlockVdsoDataPage(VdsoDataPage *vdsoDataPage)
 {
     DMB;
-    vdsoDataPage->lockCount = 0;
+    vdsoDataPage->seq++;
 }
 
 VOID OsVdsoTimevalUpdate(VOID)
 {
+    UINT32 intSave;
     VdsoDataPage *kVdsoDataPage = (VdsoDataPage *)(&__vdso_data_start);
 
+    /* every core updates DataPage from its own tick */
+    LOS_SpinLockSave(&g_vdsoSpin, &intSave);
     LockVdsoDataPage(kVdsoDataPage);
     OsVdsoTimeGet(kVdsoDataPage);
     UnlockVdsoDataPage(kVdsoDataPage);
+    LOS_SpinUnlockRestore(&g_vdsoSpin, intSave);
 }
@@ -35,26 +35,92 @@
 #include "los_typedef.h"
 #include "los_vdso_datapage.h"
 
-STATIC INT32 VdsoGetRealtimeCoarse(struct timespec *ts, const VdsoDataPage *usrVdsoDataPage)
+#define VDSO_NS_PER_SECOND 1000000000L
+
+#define VDSO_DMB() __asm__ __volatile__("dmb" : : : "memory")
+
+STATIC INLINE UINT32 VdsoReadBegin(const volatile VdsoDataPage *usrVdsoDataPage)
 {
+    UINT32 seq;
+
     do {
-        if (!usrVdsoDataPage->lockCount) {
-            ts->tv_sec = usrVdsoDataPage->realTimeSec;
-            ts->tv_nsec = usrVdsoDataPage->realTimeNsec;
-            return 0;
-        }
-    } while (1);
+        seq = usrVdsoDataPage->seq;
+    } while (seq & 1);
+    VDSO_DMB();
+    return seq;
+}
+
+STATIC INLINE BOOL VdsoReadRetry(const volatile VdsoDataPage *usrVdsoDataPage, UINT32 seq)
+{
+    VDSO_DMB();
+    return (usrVdsoDataPage->seq != seq);
 }
 
-STATIC INT32 VdsoGetMonotimeCoarse(struct timespec *ts, const VdsoDataPage *usrVdsoDataPage)
+STATIC INLINE UINT64 VdsoCycleGet(VOID)
 {
+    UINT64 cycle;
+
+    /* CNTPCT, the counter the kernel tick runs on */
+    __asm__ __volatile__("isb\n"
+                         "mrrc p15, 0, %Q0, %R0, c14" : "=r"(cycle) : : "memory");
+    return cycle;
+}
+
+STATIC INT32 VdsoGetRealtimeCoarse(struct timespec *ts, const volatile VdsoDataPage *usrVdsoDataPage)
+{
+    UINT32 seq;
+
     do {
-        if (!usrVdsoDataPage->lockCount) {
-            ts->tv_sec = usrVdsoDataPage->monoTimeSec;
-            ts->tv_nsec = usrVdsoDataPage->monoTimeNsec;
-            return 0;
+        seq = VdsoReadBegin(usrVdsoDataPage);
+        ts->tv_sec = usrVdsoDataPage->realTimeSec;
+        ts->tv_nsec = usrVdsoDataPage->realTimeNsec;
+    } while (VdsoReadRetry(usrVdsoDataPage, seq));
+    return 0;
+}
+
+STATIC INT32 VdsoGetMonotimeCoarse(struct timespec *ts, const volatile VdsoDataPage *usrVdsoDataPage)
+{
+    UINT32 seq;
+
+    do {
+        seq = VdsoReadBegin(usrVdsoDataPage);
+        ts->tv_sec = usrVdsoDataPage->monoTimeSec;
+        ts->tv_nsec = usrVdsoDataPage->monoTimeNsec;
+    } while (VdsoReadRetry(usrVdsoDataPage, seq));
+    return 0;
+}
+
+STATIC INT32 VdsoGetTime(struct timespec *ts, const volatile VdsoDataPage *usrVdsoDataPage, BOOL realTime)
+{
+    UINT32 seq;
+    UINT64 delta;
+    INT64 sec;
+    INT64 nsec;
+
+    do {
+        seq = VdsoReadBegin(usrVdsoDataPage);
+        if (!usrVdsoDataPage->highRes || (!realTime && usrVdsoDataPage->monoOffset)) {
+            /* the syscall adds the monotonic offset of the caller's time container */
+            return -1;
+        }
+        delta = VdsoCycleGet() - usrVdsoDataPage->cycleLast;
+        if (delta > usrVdsoDataPage->cycleMax) {
+            /* the tick has been stopped for too long, let the syscall work it out */
+            return -1;
         }
-    } while (1);
+        sec = realTime ? usrVdsoDataPage->realTimeSec : usrVdsoDataPage->monoTimeSec;
+        nsec = realTime ? usrVdsoDataPage->realTimeNsec : usrVdsoDataPage->monoTimeNsec;
+        nsec += (INT64)((delta * usrVdsoDataPage->mult) >> usrVdsoDataPage->shift);
+    } while (VdsoReadRetry(usrVdsoDataPage, seq));
+
+    /* no libgcc here, and delta is bounded by cycleMax, so subtract instead of divide */
+    while (nsec >= VDSO_NS_PER_SECOND) {
+        nsec -= VDSO_NS_PER_SECOND;
+        sec++;
+    }
+    ts->tv_sec = sec;
+    ts->tv_nsec = nsec;
+    return 0;
 }
 
 STATIC size_t LocVdsoStart(size_t vdsoStart, const CHAR *elfHead, const size_t len)
@@ -104,6 +170,12 @@ INT32 VdsoClockGettime(clockid_t clk, struct timespec *ts)
         case CLOCK_MONOTONIC_COARSE:
             ret = VdsoGetMonotimeCoarse(ts, usrVdsoDataPage);
             break;
+        case CLOCK_REALTIME:
+            ret = VdsoGetTime(ts, usrVdsoDataPage, TRUE);
+            break;
+        case CLOCK_MONOTONIC:
+            ret = VdsoGetTime(ts, usrVdsoDataPage, FALSE);
+            break;
         default:
             ret = -1;
             break;
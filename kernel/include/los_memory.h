@@ -131,6 +131,11 @@ typedef struct {
 #ifdef LOSCFG_MEM_WATERLINE
     UINT32 usageWaterLine;
 #endif
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+    UINT32 cacheHitNum;     /* Allocations served by the per-cpu cache */
+    UINT32 cacheMissNum;    /* Allocations that had to refill the per-cpu cache */
+    UINT32 cacheNodeNum;    /* Free blocks held by the per-cpu cache, counted as used nodes */
+#endif
 } LOS_MEM_POOL_STATUS;
 
 /**
@@ -52,6 +52,7 @@ typedef enum {
 #ifdef LOSCFG_KERNEL_SMP_CALL
     LOS_MP_IPI_FUNC_CALL,
 #endif
+    LOS_MP_IPI_TYPE_NUM,
 } MP_IPI_TYPE;
 
 typedef VOID (*SMP_FUNC_CALL)(VOID *args);
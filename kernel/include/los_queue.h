@@ -331,6 +331,42 @@ extern "C" {
  */
 #define LOS_ERRNO_QUEUE_READ_SIZE_TOO_SMALL LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x1f)
 
+/**
+ * @ingroup los_queue
+ * Queue error code: The operation is not supported by the queue mode, or the buffer committed does not
+ * belong to the queue.
+ *
+ * Value: 0x02000620
+ *
+ * Solution: Do not write to the head of a LOS_QUEUE_SPSC or LOS_QUEUE_PRIO queue, do not combine the two
+ * modes, keep message priorities below LOS_QUEUE_PRIO_NUM, and commit only buffers returned by LOS_QueueReserve.
+ */
+#define LOS_ERRNO_QUEUE_OPERATE_INVALID     LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x20)
+
+/**
+ * @ingroup los_queue
+ * Queue mode: the queue has a single writing task and a single reading task.
+ *
+ * Reads and writes take the scheduler lock only when they have to wait or to wake the other side.
+ * Writing to the head of the queue is not supported.
+ */
+#define LOS_QUEUE_SPSC                      0x1U
+
+/**
+ * @ingroup los_queue
+ * Queue mode: messages are read in priority order, first in first out among messages of the same priority.
+ *
+ * Both writing and reading take constant time whatever the number of priorities in use.
+ * Writing to the head of the queue is not supported.
+ */
+#define LOS_QUEUE_PRIO                      0x2U
+
+/**
+ * @ingroup los_queue
+ * Number of message priorities of a LOS_QUEUE_PRIO queue. Priority LOS_QUEUE_PRIO_NUM - 1 is read first.
+ */
+#define LOS_QUEUE_PRIO_NUM                  32
+
 /**
  * @ingroup los_queue
  * Structure of the block for queue information query
@@ -361,7 +397,7 @@ typedef struct tagQueueInfo {
  * @param queueName        [IN]  Message queue name. Reserved parameter, not used for now.
  * @param len              [IN]  Queue length. The value range is [1,0xffff].
  * @param queueID          [OUT] ID of the queue control structure that is successfully created.
- * @param flags            [IN]  Queue mode. Reserved parameter, not used for now.
+ * @param flags            [IN]  Queue mode, 0, #LOS_QUEUE_SPSC or #LOS_QUEUE_PRIO.
  * @param maxMsgSize       [IN]  Node size. The value range is [1,0xffff-4].
  *
  * @retval   #LOS_OK                            The message queue is successfully created.
@@ -371,6 +407,7 @@ typedef struct tagQueueInfo {
  * @retval   #LOS_ERRNO_QUEUE_PARA_ISZERO       The queue length or message node size passed in during queue
  * creation is 0.
  * @retval   #LOS_ERRNO_QUEUE_SIZE_TOO_BIG      The parameter usMaxMsgSize is larger than 0xffff - 4.
+ * @retval   #LOS_ERRNO_QUEUE_OPERATE_INVALID   #LOS_QUEUE_SPSC and #LOS_QUEUE_PRIO are both set.
  * @par Dependency:
  * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
  * @see LOS_QueueDelete
@@ -477,6 +514,72 @@ extern UINT32 LOS_QueueWriteCopy(UINT32 queueID,
                                  UINT32 bufferSize,
                                  UINT32 timeout);
 
+/**
+ * @ingroup los_queue
+ * @brief Read the message of highest priority from a queue.
+ *
+ * @par Description:
+ * This API is used to read a message like LOS_QueueReadCopy, and to return the priority it was written with.
+ * @attention
+ * <ul>
+ * <li>The specific queue should be created firstly.</li>
+ * <li>On a queue created without #LOS_QUEUE_PRIO, messages are read in FIFO order and the priority is 0.</li>
+ * <li>Do not read or write a queue in unblocking modes such as an interrupt.</li>
+ * <li>The argument timeout is a relative time.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]     Queue ID created by LOS_QueueCreate. The value range is
+ * [1,LOSCFG_BASE_IPC_QUEUE_LIMIT].
+ * @param bufferAddr     [OUT]    Starting address that stores the obtained data. It must not be null.
+ * @param bufferSize     [IN/OUT] Where to maintain the buffer wanted-size before read, and the real-size after read.
+ * @param prio           [OUT]    Priority of the message read. It may be null.
+ * @param timeout        [IN]     Expiry time. The value range is [0,LOS_WAIT_FOREVER](unit: Tick).
+ *
+ * @retval   The same values as LOS_QueueReadCopy.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueWriteCopyPrio | LOS_QueueReadCopy
+ */
+extern UINT32 LOS_QueueReadCopyPrio(UINT32 queueID,
+                                    VOID *bufferAddr,
+                                    UINT32 *bufferSize,
+                                    UINT32 *prio,
+                                    UINT32 timeout);
+
+/**
+ * @ingroup los_queue
+ * @brief Write data into a queue with a priority.
+ *
+ * @par Description:
+ * This API is used to write a message like LOS_QueueWriteCopy. On a #LOS_QUEUE_PRIO queue the message is read
+ * after every message of higher priority and after the messages of the same priority written before it.
+ * @attention
+ * <ul>
+ * <li>The specific queue should be created firstly.</li>
+ * <li>On a queue created without #LOS_QUEUE_PRIO, the priority is ignored and not checked.</li>
+ * <li>Do not read or write a queue in unblocking modes such as interrupt.</li>
+ * <li>The argument timeout is a relative time.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]  Queue ID created by LOS_QueueCreate. The value range is
+ *                             [1,LOSCFG_BASE_IPC_QUEUE_LIMIT].
+ * @param bufferAddr     [IN]  Starting address that stores the data to be written. It must not be null.
+ * @param bufferSize     [IN]  Passed-in buffer size. The value range is [1,USHRT_MAX - sizeof(UINT32)].
+ * @param prio           [IN]  Message priority. The value range is [0,LOS_QUEUE_PRIO_NUM - 1].
+ * @param timeout        [IN]  Expiry time. The value range is [0,LOS_WAIT_FOREVER](unit: Tick).
+ *
+ * @retval   #LOS_ERRNO_QUEUE_OPERATE_INVALID     The priority is out of range on a #LOS_QUEUE_PRIO queue.
+ * @retval   The other values are the same as LOS_QueueWriteCopy.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueReadCopyPrio | LOS_QueueWriteCopy
+ */
+extern UINT32 LOS_QueueWriteCopyPrio(UINT32 queueID,
+                                     VOID *bufferAddr,
+                                     UINT32 bufferSize,
+                                     UINT32 prio,
+                                     UINT32 timeout);
+
 /**
  * @ingroup los_queue
  * @brief Read a queue.
@@ -672,6 +775,99 @@ extern UINT32 LOS_QueueWriteHeadCopy(UINT32 queueID,
                                      UINT32 bufferSize,
                                      UINT32 timeout);
 
+/**
+ * @ingroup los_queue
+ * @brief Reserve a node at the tail of a queue.
+ *
+ * @par Description:
+ * This API is used to reserve a node at the tail of a queue so that the message can be built in place.
+ * The message is not visible to readers until it is committed with LOS_QueueCommit.
+ * @attention
+ * <ul>
+ * <li>The specific queue should be created firstly.</li>
+ * <li>Every node reserved must be committed, otherwise the queue cannot be deleted.</li>
+ * <li>At most maxMsgSize bytes of the node can be used.</li>
+ * <li>The argument timeout is a relative time.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]  Queue ID created by LOS_QueueCreate. The value range is
+ *                             [1,LOSCFG_BASE_IPC_QUEUE_LIMIT].
+ * @param bufferAddr     [OUT] Address of the reserved node. It must not be null.
+ * @param timeout        [IN]  Expiry time. The value range is [0,LOS_WAIT_FOREVER](unit: Tick).
+ *
+ * @retval   #LOS_OK                             A node is successfully reserved.
+ * @retval   #LOS_ERRNO_QUEUE_INVALID            The queue handle passed in is invalid.
+ * @retval   #LOS_ERRNO_QUEUE_WRITE_PTR_NULL     The pointer passed in is null.
+ * @retval   #LOS_ERRNO_QUEUE_WRITE_IN_INTERRUPT The queue cannot be waited for during an interrupt.
+ * @retval   #LOS_ERRNO_QUEUE_NOT_CREATE         The queue is not created.
+ * @retval   #LOS_ERRNO_QUEUE_ISFULL             No free node is available.
+ * @retval   #LOS_ERRNO_QUEUE_PEND_IN_LOCK       The task is forbidden to be blocked on a queue when the task is
+ * locked.
+ * @retval   #LOS_ERRNO_QUEUE_TIMEOUT            The time set for waiting to processing the queue expires.
+ * @retval   #LOS_ERRNO_QUEUE_OPERATE_INVALID    The writer of a #LOS_QUEUE_SPSC queue already holds a reserved node.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueCommit
+ */
+extern UINT32 LOS_QueueReserve(UINT32 queueID, VOID **bufferAddr, UINT32 timeout);
+
+/**
+ * @ingroup los_queue
+ * @brief Commit a node reserved by LOS_QueueReserve.
+ *
+ * @par Description:
+ * This API is used to make a message built in a reserved node visible to the readers of the queue.
+ * The message is committed with priority 0, use LOS_QueueCommitPrio to give it another one.
+ * @attention
+ * <ul>
+ * <li>The node must have been reserved by LOS_QueueReserve on the same queue.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]  Queue ID created by LOS_QueueCreate. The value range is
+ *                             [1,LOSCFG_BASE_IPC_QUEUE_LIMIT].
+ * @param bufferAddr     [IN]  Address of the node returned by LOS_QueueReserve.
+ * @param bufferSize     [IN]  Size of the message in the node. The value range is [1,maxMsgSize].
+ *
+ * @retval   #LOS_OK                             The message is successfully committed.
+ * @retval   #LOS_ERRNO_QUEUE_INVALID            The queue handle passed in is invalid.
+ * @retval   #LOS_ERRNO_QUEUE_WRITE_PTR_NULL     The pointer passed in is null.
+ * @retval   #LOS_ERRNO_QUEUE_WRITESIZE_ISZERO   The message size is 0.
+ * @retval   #LOS_ERRNO_QUEUE_NOT_CREATE         The queue is not created.
+ * @retval   #LOS_ERRNO_QUEUE_WRITE_SIZE_TOO_BIG The message size is bigger than the queue size.
+ * @retval   #LOS_ERRNO_QUEUE_OPERATE_INVALID    The node is not a reservation of the queue waiting to be committed.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueReserve | LOS_QueueCommitPrio
+ */
+extern UINT32 LOS_QueueCommit(UINT32 queueID, VOID *bufferAddr, UINT32 bufferSize);
+
+/**
+ * @ingroup los_queue
+ * @brief Commit a node reserved by LOS_QueueReserve with a priority.
+ *
+ * @par Description:
+ * This API is used to commit a reserved node like LOS_QueueCommit. On a #LOS_QUEUE_PRIO queue the message is read
+ * after every message of higher priority and after the messages of the same priority written before it.
+ * @attention
+ * <ul>
+ * <li>The node must have been reserved by LOS_QueueReserve on the same queue.</li>
+ * <li>On a queue created without #LOS_QUEUE_PRIO, the priority is ignored and not checked.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]  Queue ID created by LOS_QueueCreate. The value range is
+ *                             [1,LOSCFG_BASE_IPC_QUEUE_LIMIT].
+ * @param bufferAddr     [IN]  Address of the node returned by LOS_QueueReserve.
+ * @param bufferSize     [IN]  Size of the message in the node. The value range is [1,maxMsgSize].
+ * @param prio           [IN]  Message priority. The value range is [0,LOS_QUEUE_PRIO_NUM - 1].
+ *
+ * @retval   #LOS_ERRNO_QUEUE_OPERATE_INVALID    The priority is out of range on a #LOS_QUEUE_PRIO queue.
+ * @retval   The other values are the same as LOS_QueueCommit.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueCommit | LOS_QueueWriteCopyPrio
+ */
+extern UINT32 LOS_QueueCommitPrio(UINT32 queueID, VOID *bufferAddr, UINT32 bufferSize, UINT32 prio);
+
 /**
  * @ingroup los_queue
  * @brief Delete a queue.
@@ -692,7 +888,8 @@ extern UINT32 LOS_QueueWriteHeadCopy(UINT32 queueID,
  * @retval   #LOS_ERRNO_QUEUE_NOT_FOUND   The queue cannot be found.
  * @retval   #LOS_ERRNO_QUEUE_NOT_CREATE  The queue handle passed in when the queue is being deleted is
  * incorrect.
- * @retval   #LOS_ERRNO_QUEUE_IN_TSKUSE   The queue that blocks a task cannot be deleted.
+ * @retval   #LOS_ERRNO_QUEUE_IN_TSKUSE   The queue that blocks a task, or a #LOS_QUEUE_SPSC queue that is being
+ * read, written or has a node reserved, cannot be deleted.
  * @retval   #LOS_ERRNO_QUEUE_IN_TSKWRITE Queue reading and writing are not synchronous.
  * @par Dependency:
  * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
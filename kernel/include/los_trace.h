@@ -601,6 +601,29 @@ extern VOID LOS_TraceRecordDump(BOOL toClient);
  */
 extern OfflineHead *LOS_TraceRecordGet(VOID);
 
+/**
+ * @ingroup los_trace
+ * @brief Offline trace buffer copy in timestamp order.
+ *
+ * @par Description:
+ * Copy the trace buf laid out as #LOS_TraceRecordGet returns it, but with the events recorded by all cpus
+ * merged in timestamp order, only at offline mode.
+ * @attention
+ * <ul>
+ * <li>Stop trace first, events recorded during the copy may be inconsistent.</li>
+ * <li>Unused event frames are zero-filled at the end of the copy.</li>
+ * </ul>
+ *
+ * @param buf                [OUT] Type #VOID *. The buffer the trace data is copied to.
+ * @param size               [IN] Type #UINT32. The size of buf.
+ * @retval #UINT32           The number of bytes copied, 0 if trace is not at offline mode.
+ *
+ * @par Dependency:
+ * <ul><li>los_trace.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_TraceRecordGet
+ */
+extern UINT32 LOS_TraceRecordExport(VOID *buf, UINT32 size);
+
 /**
  * @ingroup los_trace
  * @brief Hwi num filter hook.
@@ -32,6 +32,7 @@
 #ifndef _LWIP_PORTING_SYS_ARCH_H_
 #define _LWIP_PORTING_SYS_ARCH_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include "los_mux.h"
 
@@ -63,6 +64,23 @@ typedef uint32_t sys_mbox_t;
  */
 typedef void *sys_prot_t;
 
+/* Protectors of the socket layer, the memp pools and the pbuf reference counts, kept apart from
+ * the global sys_arch_protect() */
+sys_prot_t sys_arch_sock_protect(void);
+void sys_arch_sock_unprotect(sys_prot_t pval);
+sys_prot_t sys_arch_memp_protect(void);
+void sys_arch_memp_unprotect(sys_prot_t pval);
+sys_prot_t sys_arch_pbuf_protect(void);
+void sys_arch_pbuf_unprotect(sys_prot_t pval);
+
+
+/**
+ * Memory of mem_malloc, with MTU sized blocks cached per cpu, see mem_clib_malloc in lwipopts.h
+ */
+void *sys_arch_mem_malloc(size_t size);
+void *sys_arch_mem_calloc(size_t count, size_t size);
+void sys_arch_mem_free(void *mem);
+
 
 /**
  * Thread
@@ -144,6 +144,9 @@
 #define LWIP_SO_SNDTIMEO                1
 #define LWIP_STATS_DISPLAY              1
 #define MEM_LIBC_MALLOC                 1
+#define mem_clib_malloc                 sys_arch_mem_malloc
+#define mem_clib_calloc                 sys_arch_mem_calloc
+#define mem_clib_free                   sys_arch_mem_free
 #define MEMP_NUM_ARP_QUEUE              (65535 * LWIP_CONFIG_NUM_SOCKETS / (IP_FRAG_MAX_MTU - 20 - 8))
 #define MEMP_NUM_NETBUF                 (65535 * 3 * LWIP_CONFIG_NUM_SOCKETS / (IP_FRAG_MAX_MTU - 20 - 8))
 #define MEMP_NUM_NETCONN                LWIP_CONFIG_NUM_SOCKETS
@@ -48,6 +48,7 @@
 void veth_init(struct netif *netif, struct net_group *group);
 #define linkoutput      linkoutput; \
                         void (*drv_send)(struct netif *netif, struct pbuf *p); \
+                        void (*drv_send_batch)(struct netif *netif, struct pbuf **p, u16_t num); \
                         u8_t (*drv_set_hwaddr)(struct netif *netif, u8_t *addr, u8_t len); \
                         void (*drv_config)(struct netif *netif, u32_t config_flags, u8_t setBit); \
                         char full_name[IFNAMSIZ]; \
@@ -57,6 +58,7 @@ void veth_init(struct netif *netif, struct net_group *group);
 #else
 #define linkoutput      linkoutput; \
                         void (*drv_send)(struct netif *netif, struct pbuf *p); \
+                        void (*drv_send_batch)(struct netif *netif, struct pbuf **p, u16_t num); \
                         u8_t (*drv_set_hwaddr)(struct netif *netif, u8_t *addr, u8_t len); \
                         void (*drv_config)(struct netif *netif, u32_t config_flags, u8_t setBit); \
                         char full_name[IFNAMSIZ]; \
@@ -84,6 +86,7 @@ extern "C" {
 
 err_t driverif_init(struct netif *netif);
 void driverif_input(struct netif *netif, struct pbuf *p);
+void driverif_input_batch(struct netif *netif, struct pbuf **pkts, u16_t num);
 
 #ifndef __LWIP__
 #define PF_PKT_SUPPORT              LWIP_NETIF_PROMISC
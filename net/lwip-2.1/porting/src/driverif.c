@@ -35,9 +35,9 @@
 #include <lwip/etharp.h>
 #include <lwip/sockets.h>
 #include <lwip/ethip6.h>
-#ifdef LOSCFG_NET_CONTAINER
+#include <lwip/ip.h>
 #include <lwip/tcpip.h>
-#endif
+#include <netif/ethernet.h>
 
 #define LWIP_NETIF_HOSTNAME_DEFAULT         "default"
 #define LINK_SPEED_OF_YOUR_NETIF_IN_BPS     100000000 // 100Mbps
@@ -51,6 +51,24 @@
 #define LWIP_NETIF_IFINDEX_MAX_EX 255
 #endif
 
+/* Maximum packets carried by one batched input message, or rung through one drv_send_batch doorbell */
+#define DRIVERIF_BATCH_MAX 32
+
+struct driverif_input_msg {
+    struct netif *netif;
+    u16_t num;
+    struct pbuf *pkts[];
+};
+
+/*
+ * Packets sent while a batch of input is processed are staged here and handed to drv_send_batch
+ * in one call. Only the thread holding the lwIP core touches it, so no lock is needed.
+ */
+static struct netif *driverif_tx_netif;
+static struct pbuf *driverif_tx_pkts[DRIVERIF_BATCH_MAX];
+static u16_t driverif_tx_num;
+static u16_t driverif_tx_window;
+
 LWIP_STATIC void
 driverif_init_ifname(struct netif *netif)
 {
@@ -81,6 +99,61 @@ driverif_init_ifname(struct netif *netif)
     netif->full_name[0] = '\0';
 }
 
+LWIP_STATIC void
+driverif_tx_flush(void)
+{
+    struct netif *netif = driverif_tx_netif;
+    u16_t num = driverif_tx_num;
+    u16_t i;
+
+    if (num == 0) {
+        return;
+    }
+    driverif_tx_netif = NULL;
+    driverif_tx_num = 0;
+
+#if ETH_PAD_SIZE
+    if (netif->flags & NETIF_FLAG_ETHARP) {
+        for (i = 0; i < num; i++) {
+            (void)pbuf_header(driverif_tx_pkts[i], -ETH_PAD_SIZE); /* drop the padding word */
+        }
+    }
+#endif
+
+    netif->drv_send_batch(netif, driverif_tx_pkts, num);
+
+    for (i = 0; i < num; i++) {
+#if ETH_PAD_SIZE
+        if (netif->flags & NETIF_FLAG_ETHARP) {
+            (void)pbuf_header(driverif_tx_pkts[i], ETH_PAD_SIZE); /* reclaim the padding word */
+        }
+#endif
+        (void)pbuf_free(driverif_tx_pkts[i]);
+    }
+}
+
+/*
+ * Stage p for drv_send_batch if a batch of input is being processed, the doorbell is rung
+ * once the batch is done. Returns 0 if the caller has to send p right away.
+ */
+LWIP_STATIC int
+driverif_tx_stage(struct netif *netif, struct pbuf *p)
+{
+    if ((driverif_tx_window == 0) || (netif->drv_send_batch == NULL)) {
+        return 0;
+    }
+
+    if ((driverif_tx_netif != netif) || (driverif_tx_num == DRIVERIF_BATCH_MAX)) {
+        driverif_tx_flush();
+    }
+
+    /* The driver may hold the packet like a DMA queue would, see tcp_output_segment_busy() */
+    pbuf_ref(p);
+    driverif_tx_netif = netif;
+    driverif_tx_pkts[driverif_tx_num++] = p;
+    return 1;
+}
+
 /*
  * This function should do the actual transmission of the packet. The packet is
  * contained in the pbuf that is passed to the function. This pbuf
@@ -111,15 +184,17 @@ driverif_output(struct netif *netif, struct pbuf *p)
     }
 #endif
 
+    if (!driverif_tx_stage(netif, p)) {
 #if ETH_PAD_SIZE
-    (void)pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
+        (void)pbuf_header(p, -ETH_PAD_SIZE); /* drop the padding word */
 #endif
 
-    netif->drv_send(netif, p);
+        netif->drv_send(netif, p);
 
 #if ETH_PAD_SIZE
-    (void)pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
+        (void)pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
 #endif
+    }
     MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
     LINK_STATS_INC(link.xmit);
 
@@ -127,18 +202,11 @@ driverif_output(struct netif *netif, struct pbuf *p)
 }
 
 /*
- * This function should be called by network driver to pass the input packet to LwIP.
- * Before calling this API, driver has to keep the packet in pbuf structure. Driver has to
- * call pbuf_alloc() with type as PBUF_RAM to create pbuf structure. Then driver
- * has to pass the pbuf structure to this API. This will add the pbuf into the TCPIP thread.
- * Once this packet is processed by TCPIP thread, pbuf will be freed. Driver is not required to
- * free the pbuf.
- *
- * @param netif the lwip network interface structure for this driverif
- * @param p packet in pbuf structure format
+ * Check that an ethernet packet is one the stack takes. Returns ERR_OK if so, otherwise
+ * the packet has been freed and accounted as dropped.
  */
-void
-driverif_input(struct netif *netif, struct pbuf *p)
+LWIP_STATIC err_t
+driverif_input_accept(struct netif *netif, struct pbuf *p)
 {
 #if PF_PKT_SUPPORT
 #if  (DRIVERIF_DEBUG & LWIP_DBG_OFF)
@@ -149,9 +217,6 @@ driverif_input(struct netif *netif, struct pbuf *p)
     u16_t ethhdr_type;
     struct eth_hdr *ethhdr = NULL;
 #endif
-    err_t ret = ERR_VAL;
-
-    LWIP_ERROR("driverif_input : invalid arguments", ((netif != NULL) && (p != NULL)), return);
 
     LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input : going to receive input packet. netif 0x%p, pbuf 0x%p, \
                                packet_length %"U16_F"\n", (void *)netif, (void *)p, p->tot_len));
@@ -162,7 +227,7 @@ driverif_input(struct netif *netif, struct pbuf *p)
         (void)pbuf_free(p);
         LINK_STATS_INC(link.drop);
         LINK_STATS_INC(link.link_rx_drop);
-        return;
+        return ERR_VAL;
     }
 
 #if PF_PKT_SUPPORT
@@ -173,20 +238,7 @@ driverif_input(struct netif *netif, struct pbuf *p)
 #endif
 
     /* full packet send to tcpip_thread to process */
-    if (netif->input) {
-        ret = netif->input(p, netif);
-    }
-    if (ret != ERR_OK) {
-        LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input: IP input error\n"));
-        (void)pbuf_free(p);
-        LINK_STATS_INC(link.drop);
-        LINK_STATS_INC(link.link_rx_drop);
-        if (ret == ERR_MEM) {
-            LINK_STATS_INC(link.link_rx_overrun);
-        }
-    } else {
-        LINK_STATS_INC(link.recv);
-    }
+    return ERR_OK;
 
 #else
     ethhdr = (struct eth_hdr *)p->payload;
@@ -202,36 +254,191 @@ driverif_input(struct netif *netif, struct pbuf *p)
 #endif /* ETHARP_SUPPORT_VLAN */
             LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input : received packet of type %"U16_F"\n", ethhdr_type));
             /* full packet send to tcpip_thread to process */
-            if (netif->input != NULL) {
-                ret = netif->input(p, netif);
-            }
-
-            if (ret != ERR_OK) {
-                LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input: IP input error\n"));
-                (void)pbuf_free(p);
-                LINK_STATS_INC(link.drop);
-                LINK_STATS_INC(link.link_rx_drop);
-                if (ret == ERR_MEM) {
-                    MIB2_STATS_NETIF_INC(netif, ifinoverruns);
-                    LINK_STATS_INC(link.link_rx_overrun);
-                }
-            } else {
-                LINK_STATS_INC(link.recv);
-            }
-            break;
+            return ERR_OK;
 
         default:
             LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input : received packet is of unsupported type %"U16_F"\n", ethhdr_type));
             (void)pbuf_free(p);
             LINK_STATS_INC(link.drop);
             LINK_STATS_INC(link.link_rx_drop);
-            break;
+            return ERR_VAL;
     }
 #endif
+}
+
+/* Account the result of handing p to the stack, and free it if the stack did not take it */
+LWIP_STATIC void
+driverif_input_done(struct netif *netif, struct pbuf *p, err_t ret)
+{
+    LWIP_UNUSED_ARG(netif);
+
+    if (ret != ERR_OK) {
+        LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input: IP input error\n"));
+        (void)pbuf_free(p);
+        LINK_STATS_INC(link.drop);
+        LINK_STATS_INC(link.link_rx_drop);
+        if (ret == ERR_MEM) {
+            MIB2_STATS_NETIF_INC(netif, ifinoverruns);
+            LINK_STATS_INC(link.link_rx_overrun);
+        }
+    } else {
+        LINK_STATS_INC(link.recv);
+    }
+}
+
+/*
+ * This function should be called by network driver to pass the input packet to LwIP.
+ * Before calling this API, driver has to keep the packet in pbuf structure. Driver has to
+ * call pbuf_alloc() with type as PBUF_RAM to create pbuf structure. Then driver
+ * has to pass the pbuf structure to this API. This will add the pbuf into the TCPIP thread.
+ * Once this packet is processed by TCPIP thread, pbuf will be freed. Driver is not required to
+ * free the pbuf.
+ *
+ * @param netif the lwip network interface structure for this driverif
+ * @param p packet in pbuf structure format
+ */
+void
+driverif_input(struct netif *netif, struct pbuf *p)
+{
+    err_t ret = ERR_VAL;
+
+    LWIP_ERROR("driverif_input : invalid arguments", ((netif != NULL) && (p != NULL)), return);
+
+    if (driverif_input_accept(netif, p) != ERR_OK) {
+        return;
+    }
+
+    if (netif->input != NULL) {
+        ret = netif->input(p, netif);
+    }
+    driverif_input_done(netif, p, ret);
 
     LWIP_DEBUGF(DRIVERIF_DEBUG, ("driverif_input : received packet is processed\n"));
 }
 
+/* Runs with the lwIP core held: feeds a batch to the stack, then rings the TX doorbell once */
+LWIP_STATIC void
+driverif_input_batch_fn(void *arg)
+{
+    struct driverif_input_msg *msg = (struct driverif_input_msg *)arg;
+    struct netif *netif = msg->netif;
+    struct pbuf *p = NULL;
+    err_t ret;
+    u16_t i;
+
+    driverif_tx_window++;
+    for (i = 0; i < msg->num; i++) {
+        p = msg->pkts[i];
+#if LWIP_ETHERNET
+        if (netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
+            ret = ethernet_input(p, netif);
+        } else
+#endif /* LWIP_ETHERNET */
+        {
+            ret = ip_input(p, netif);
+        }
+        if (ret != ERR_OK) {
+            (void)pbuf_free(p);
+        }
+    }
+    driverif_tx_window--;
+
+    if (driverif_tx_window == 0) {
+        driverif_tx_flush();
+    }
+    mem_free(msg);
+}
+
+LWIP_STATIC void
+driverif_input_post(struct driverif_input_msg *msg)
+{
+    struct netif *netif = msg->netif;
+    u16_t num = msg->num;
+    err_t ret = ERR_OK;
+    u16_t i;
+
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+    LOCK_TCPIP_CORE();
+    driverif_input_batch_fn(msg);
+    UNLOCK_TCPIP_CORE();
+#else
+    ret = tcpip_try_callback(driverif_input_batch_fn, msg);
+#endif
+    if (ret == ERR_OK) {
+        for (i = 0; i < num; i++) {
+            LINK_STATS_INC(link.recv);
+        }
+        return;
+    }
+
+    for (i = 0; i < num; i++) {
+        driverif_input_done(netif, msg->pkts[i], ERR_MEM);
+    }
+    mem_free(msg);
+}
+
+/*
+ * Batched form of driverif_input(), for drivers that reap several packets per interrupt or
+ * poll. The accepted packets reach the TCPIP thread in one message instead of one each, and
+ * what the stack sends in response is handed to drv_send_batch in one call if the netif has it.
+ * Ownership of every pbuf passes to this API, as with driverif_input().
+ *
+ * @param netif the lwip network interface structure for this driverif
+ * @param pkts array of packets in pbuf structure format
+ * @param num number of packets in pkts
+ */
+void
+driverif_input_batch(struct netif *netif, struct pbuf **pkts, u16_t num)
+{
+    struct driverif_input_msg *msg = NULL;
+    u16_t chunk;
+    u16_t i;
+
+    LWIP_ERROR("driverif_input_batch : invalid arguments", ((netif != NULL) && (pkts != NULL)), return);
+
+    /* only the TCPIP thread input can be batched */
+    if (netif->input != tcpip_input) {
+        for (i = 0; i < num; i++) {
+            driverif_input(netif, pkts[i]);
+        }
+        return;
+    }
+
+    while (num > 0) {
+        chunk = LWIP_MIN(num, DRIVERIF_BATCH_MAX);
+        msg = (struct driverif_input_msg *)mem_malloc(sizeof(struct driverif_input_msg) +
+                                                      (chunk * sizeof(struct pbuf *)));
+        if (msg != NULL) {
+            msg->netif = netif;
+            msg->num = 0;
+        }
+        for (i = 0; i < chunk; i++) {
+            if (pkts[i] == NULL) {
+                continue;
+            }
+            if ((netif->flags & NETIF_FLAG_ETHARP) && (driverif_input_accept(netif, pkts[i]) != ERR_OK)) {
+                continue;
+            }
+            if (msg == NULL) {
+                driverif_input_done(netif, pkts[i], ERR_MEM);
+                continue;
+            }
+            msg->pkts[msg->num++] = pkts[i];
+        }
+        pkts += chunk;
+        num -= chunk;
+
+        if (msg == NULL) {
+            continue;
+        }
+        if (msg->num == 0) {
+            mem_free(msg);
+            continue;
+        }
+        driverif_input_post(msg);
+    }
+}
+
 /*
  * Should be called at the beginning of the program to set up the
  * network interface. It calls the function low_level_init() to do the
@@ -323,10 +530,40 @@ driverif_init(struct netif *netif)
 }
 
 #ifdef LOSCFG_NET_CONTAINER
+/* The peer gets its own copies, since the sender may still modify the packets, as netif_loop_output() does */
+static void veth_send_batch(struct netif *netif, struct pbuf **pkts, u16_t num)
+{
+    struct pbuf *copies[DRIVERIF_BATCH_MAX];
+    u16_t cnt = 0;
+
+    for (u16_t i = 0; (i < num) && (cnt < DRIVERIF_BATCH_MAX); i++) {
+        copies[cnt] = pbuf_clone(PBUF_LINK, PBUF_RAM, pkts[i]);
+        if (copies[cnt] == NULL) {
+            LINK_STATS_INC(link.memerr);
+            LINK_STATS_INC(link.drop);
+            continue;
+        }
+        cnt++;
+    }
+    driverif_input_batch(netif->peer, copies, cnt);
+}
+
+static void veth_send(struct netif *netif, struct pbuf *p)
+{
+    veth_send_batch(netif, &p, 1);
+}
+
 static err_t netif_veth_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *addr)
 {
     LWIP_UNUSED_ARG(addr);
-    return netif_loop_output(netif->peer, p);
+
+    if (!driverif_tx_stage(netif, p)) {
+        netif->drv_send(netif, p);
+    }
+    MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
+    LINK_STATS_INC(link.xmit);
+
+    return ERR_OK;
 }
 
 static void veth_init_fullname(struct netif *netif)
@@ -365,6 +602,8 @@ static err_t netif_vethif_init(struct netif *netif)
 
     veth_init_fullname(netif);
     netif->output = netif_veth_output;
+    netif->drv_send = veth_send;
+    netif->drv_send_batch = veth_send_batch;
 
     netif_set_flags(netif, NETIF_FLAG_IGMP);
     NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_DISABLE_ALL);
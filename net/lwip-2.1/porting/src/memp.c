@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2022 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/sys.h>
+#include <lwip/memp.h>
+#include <los_spinlock.h>
+
+/* The memp pools are only touched in this file, so they are guarded by their own protector */
+#undef SYS_ARCH_PROTECT
+#undef SYS_ARCH_UNPROTECT
+#define SYS_ARCH_PROTECT(lev)   lev = sys_arch_memp_protect()
+#define SYS_ARCH_UNPROTECT(lev) sys_arch_memp_unprotect(lev)
+
+/*
+ * Every cpu keeps a small magazine of freed objects per memp type in front of the pools. The
+ * objects in a magazine still belong to their pool, so each type keeps its MEMP_NUM_* limit, and
+ * an allocation that finds its pool empty drains the magazines of that type before failing.
+ */
+#if !MEMP_MEM_MALLOC && !MEMP_OVERFLOW_CHECK && !defined(LWIP_HOOK_MEMP_AVAILABLE)
+#define MEMP_MAG_ENABLE 1
+#else
+#define MEMP_MAG_ENABLE 0
+#endif
+
+#if MEMP_MAG_ENABLE
+static void memp_pools_init(void);
+static void *memp_pools_malloc(memp_t type);
+static void memp_pools_free(memp_t type, void *mem);
+
+#define memp_init   memp_pools_init
+#define memp_malloc memp_pools_malloc
+#define memp_free   memp_pools_free
+#endif
+
+#include "../core/memp.c"
+
+#if MEMP_MAG_ENABLE
+#undef memp_init
+#undef memp_malloc
+#undef memp_free
+
+#define MEMP_MAG_SIZE   8
+
+struct memp_mag {
+    SPIN_LOCK_S lock;
+    u16_t count[MEMP_MAX];
+    void *objs[MEMP_MAX][MEMP_MAG_SIZE];
+};
+
+static struct memp_mag memp_mags[LOSCFG_KERNEL_CORE_NUM];
+
+/* Give the objects of one type cached on every cpu back to their pool, returns how many */
+static u32_t memp_mags_drain(memp_t type)
+{
+    struct memp_mag *mag = NULL;
+    void *objs[MEMP_MAG_SIZE];
+    u32_t drained = 0;
+    u32_t count;
+    UINT32 intSave;
+    u32_t cpu;
+
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        mag = &memp_mags[cpu];
+        LOS_SpinLockSave(&mag->lock, &intSave);
+        for (count = 0; mag->count[type] > 0; count++) {
+            objs[count] = mag->objs[type][--mag->count[type]];
+        }
+        LOS_SpinUnlockRestore(&mag->lock, intSave);
+
+        drained += count;
+        while (count > 0) {
+            memp_pools_free(type, objs[--count]);
+        }
+    }
+    return drained;
+}
+
+void memp_init(void)
+{
+    u32_t cpu;
+
+    for (cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        LOS_SpinInit(&memp_mags[cpu].lock);
+    }
+    memp_pools_init();
+}
+
+void *memp_malloc(memp_t type)
+{
+    struct memp_mag *mag = NULL;
+    void *mem = NULL;
+    UINT32 intSave;
+
+    LWIP_ERROR("memp_malloc: type < MEMP_MAX", (type < MEMP_MAX), return NULL;);
+
+    mag = &memp_mags[ArchCurrCpuid()];
+    LOS_SpinLockSave(&mag->lock, &intSave);
+    if (mag->count[type] > 0) {
+        mem = mag->objs[type][--mag->count[type]];
+    }
+    LOS_SpinUnlockRestore(&mag->lock, intSave);
+    if (mem != NULL) {
+        return mem;
+    }
+
+    mem = memp_pools_malloc(type);
+    if ((mem == NULL) && (memp_mags_drain(type) > 0)) {
+        mem = memp_pools_malloc(type);
+    }
+    return mem;
+}
+
+void memp_free(memp_t type, void *mem)
+{
+    struct memp_mag *mag = NULL;
+    u32_t cached = 0;
+    UINT32 intSave;
+
+    LWIP_ERROR("memp_free: type < MEMP_MAX", (type < MEMP_MAX), return;);
+
+    if (mem == NULL) {
+        return;
+    }
+
+    mag = &memp_mags[ArchCurrCpuid()];
+    LOS_SpinLockSave(&mag->lock, &intSave);
+    if (mag->count[type] < MEMP_MAG_SIZE) {
+        mag->objs[type][mag->count[type]++] = mem;
+        cached = 1;
+    }
+    LOS_SpinUnlockRestore(&mag->lock, intSave);
+
+    if (!cached) {
+        memp_pools_free(type, mem);
+    }
+}
+#endif /* MEMP_MAG_ENABLE */
@@ -33,6 +33,12 @@
 #include <lwip/priv/tcpip_priv.h>
 #include <lwip/fixme.h>
 
+/* Socket state is only touched in this file, so it is guarded by its own protector */
+#undef SYS_ARCH_PROTECT
+#undef SYS_ARCH_UNPROTECT
+#define SYS_ARCH_PROTECT(lev)   lev = sys_arch_sock_protect()
+#define SYS_ARCH_UNPROTECT(lev) sys_arch_sock_unprotect(lev)
+
 #if LWIP_ENABLE_NET_CAPABILITY
 #include "capability_type.h"
 #include "capability_api.h"
@@ -39,13 +39,56 @@
 #include <los_sem.h>
 #include <los_mux.h>
 #include <los_spinlock.h>
+#include <los_memory.h>
+#include <securec.h>
 
 #ifdef LOSCFG_KERNEL_SMP
-SPIN_LOCK_INIT(arch_protect_spin);
-static u32_t lwprot_thread = LOS_ERRNO_TSK_ID_INVALID;
-static int lwprot_count = 0;
+/* Recursive spinlock, owned by one thread at a time */
+struct sys_arch_prot {
+    SPIN_LOCK_S spin;
+    u32_t thread;
+    int count;
+};
+
+#define SYS_ARCH_PROT_INIT(name) \
+    static struct sys_arch_prot name = { SPIN_LOCK_INITIALIZER(name.spin), LOS_ERRNO_TSK_ID_INVALID, 0 }
+
+/*
+ * Global lwIP protector, and separate ones for the state only touched by one file:
+ * sockets in sockets.c, memp pools in memp.c and pbuf reference counts in pbuf.c
+ */
+SYS_ARCH_PROT_INIT(arch_protect);
+SYS_ARCH_PROT_INIT(sock_protect);
+SYS_ARCH_PROT_INIT(memp_protect);
+SYS_ARCH_PROT_INIT(pbuf_protect);
+
+#define SYS_ARCH_PROT_ENTER(name)   sys_arch_prot_enter(&(name))
+#define SYS_ARCH_PROT_EXIT(name)    sys_arch_prot_exit(&(name))
+#else
+#define SYS_ARCH_PROT_ENTER(name)   LOS_TaskLock()
+#define SYS_ARCH_PROT_EXIT(name)    LOS_TaskUnlock()
 #endif /* LOSCFG_KERNEL_SMP */
 
+/*
+ * mem_malloc serves the PBUF_RAM pbufs, and those of about one MTU are allocated at packet
+ * rate: keep a few of them on every cpu. Smaller blocks are already served by the system
+ * pool's per-cpu cache. The memp pools are not routed here, they keep their per-type limits.
+ */
+#define SYS_ARCH_MEM_CACHE_SIZE     2048
+#define SYS_ARCH_MEM_CACHE_NUM      16
+
+struct sys_arch_mem_head {
+    u32_t cached;
+    u32_t reserved; /* keeps the payload 8 bytes aligned */
+};
+
+struct sys_arch_mem_cache {
+    struct sys_arch_mem_head *blocks[SYS_ARCH_MEM_CACHE_NUM];
+    u32_t count;
+};
+
+static struct sys_arch_mem_cache mem_cache[LOSCFG_KERNEL_CORE_NUM];
+
 #define ROUND_UP_DIV(val, div) (((val) + (div) - 1) / (div))
 
 /**
@@ -88,7 +131,25 @@ u32_t sys_now(void)
     return (u32_t)((LOS_TickCountGet() * OS_SYS_MS_PER_SECOND) / LOSCFG_BASE_CORE_TICK_PER_SECOND);
 }
 
-#if (LWIP_CHKSUM_ALGORITHM == 4) /* version #4, asm based */
+#if defined(LOSCFG_ARCH_FPU_VFP_NEON)
+#include "in_cksum.h"
+static inline u16_t lwip_neon_fold(unsigned int sum)
+{
+    sum = (sum & 0xFFFF) + (sum >> 16); /* 16: end-around carry */
+    sum = (sum & 0xFFFF) + (sum >> 16); /* 16: end-around carry */
+    return (u16_t)sum;
+}
+
+u16_t lwip_neon_chksum(const void *dataptr, int len)
+{
+    return lwip_neon_fold(csum_partial_neon(dataptr, len, 0));
+}
+
+u16_t lwip_neon_chksum_copy(void *dst, const void *src, u16_t len)
+{
+    return lwip_neon_fold(csum_partial_copy_neon(src, dst, len, 0));
+}
+#elif (LWIP_CHKSUM_ALGORITHM == 4) /* version #4, asm based */
 #include "in_cksum.h"
 u16_t lwip_standard_chksum(const void *dataptr, int len)
 {
@@ -101,44 +162,162 @@ u16_t lwip_standard_chksum(const void *dataptr, int len)
  * Protector
  */
 
-sys_prot_t sys_arch_protect(void)
-{
 #ifdef LOSCFG_KERNEL_SMP
+static void sys_arch_prot_enter(struct sys_arch_prot *prot)
+{
     /* Note that we are using spinlock instead of mutex for LiteOS-SMP here:
      * 1. spinlock is more effective for short critical region protection.
      * 2. this function is called only in task context, not in interrupt handler.
      *    so it's not needed to disable interrupt.
      */
-    if (lwprot_thread != LOS_CurTaskIDGet()) {
+    if (prot->thread != LOS_CurTaskIDGet()) {
         /* We are locking the spinlock where it has not been locked before
          * or is being locked by another thread */
-        LOS_SpinLock(&arch_protect_spin);
-        lwprot_thread = LOS_CurTaskIDGet();
-        lwprot_count = 1;
+        LOS_SpinLock(&prot->spin);
+        prot->thread = LOS_CurTaskIDGet();
+        prot->count = 1;
     } else {
         /* It is already locked by THIS thread */
-        lwprot_count++;
+        prot->count++;
     }
-#else
-    LOS_TaskLock();
+}
+
+static void sys_arch_prot_exit(struct sys_arch_prot *prot)
+{
+    if (prot->thread == LOS_CurTaskIDGet()) {
+        prot->count--;
+        if (prot->count == 0) {
+            prot->thread = LOS_ERRNO_TSK_ID_INVALID;
+            LOS_SpinUnlock(&prot->spin);
+        }
+    }
+}
 #endif /* LOSCFG_KERNEL_SMP */
+
+sys_prot_t sys_arch_protect(void)
+{
+    SYS_ARCH_PROT_ENTER(arch_protect);
     return 0; /* return value is unused */
 }
 
 void sys_arch_unprotect(sys_prot_t pval)
 {
     LWIP_UNUSED_ARG(pval);
-#ifdef LOSCFG_KERNEL_SMP
-    if (lwprot_thread == LOS_CurTaskIDGet()) {
-        lwprot_count--;
-        if (lwprot_count == 0) {
-            lwprot_thread = LOS_ERRNO_TSK_ID_INVALID;
-            LOS_SpinUnlock(&arch_protect_spin);
+    SYS_ARCH_PROT_EXIT(arch_protect);
+}
+
+sys_prot_t sys_arch_sock_protect(void)
+{
+    SYS_ARCH_PROT_ENTER(sock_protect);
+    return 0; /* return value is unused */
+}
+
+void sys_arch_sock_unprotect(sys_prot_t pval)
+{
+    LWIP_UNUSED_ARG(pval);
+    SYS_ARCH_PROT_EXIT(sock_protect);
+}
+
+sys_prot_t sys_arch_memp_protect(void)
+{
+    SYS_ARCH_PROT_ENTER(memp_protect);
+    return 0; /* return value is unused */
+}
+
+void sys_arch_memp_unprotect(sys_prot_t pval)
+{
+    LWIP_UNUSED_ARG(pval);
+    SYS_ARCH_PROT_EXIT(memp_protect);
+}
+
+sys_prot_t sys_arch_pbuf_protect(void)
+{
+    SYS_ARCH_PROT_ENTER(pbuf_protect);
+    return 0; /* return value is unused */
+}
+
+void sys_arch_pbuf_unprotect(sys_prot_t pval)
+{
+    LWIP_UNUSED_ARG(pval);
+    SYS_ARCH_PROT_EXIT(pbuf_protect);
+}
+
+
+/**
+ * Memory
+ */
+
+void *sys_arch_mem_malloc(size_t size)
+{
+    struct sys_arch_mem_head *head = NULL;
+    struct sys_arch_mem_cache *cache = NULL;
+    u32_t cached = (size > (SYS_ARCH_MEM_CACHE_SIZE >> 1)) && (size <= SYS_ARCH_MEM_CACHE_SIZE);
+    UINT32 intSave;
+
+    if (size > (UINT32_MAX - sizeof(struct sys_arch_mem_head))) {
+        return NULL;
+    }
+
+    if (cached) {
+        intSave = LOS_IntLock();
+        cache = &mem_cache[ArchCurrCpuid()];
+        if (cache->count > 0) {
+            head = cache->blocks[--cache->count];
         }
+        LOS_IntRestore(intSave);
+        size = SYS_ARCH_MEM_CACHE_SIZE;
+    }
+
+    if (head == NULL) {
+        head = (struct sys_arch_mem_head *)LOS_MemAlloc(OS_SYS_MEM_ADDR, sizeof(struct sys_arch_mem_head) + size);
+        if (head == NULL) {
+            return NULL;
+        }
+    }
+
+    head->cached = cached;
+    return head + 1;
+}
+
+void *sys_arch_mem_calloc(size_t count, size_t size)
+{
+    void *mem = NULL;
+
+    if ((size != 0) && (count > (UINT32_MAX / size))) {
+        return NULL;
+    }
+
+    mem = sys_arch_mem_malloc(count * size);
+    if (mem != NULL) {
+        (void)memset_s(mem, count * size, 0, count * size);
+    }
+    return mem;
+}
+
+void sys_arch_mem_free(void *mem)
+{
+    struct sys_arch_mem_head *head = NULL;
+    struct sys_arch_mem_cache *cache = NULL;
+    UINT32 intSave;
+
+    if (mem == NULL) {
+        return;
+    }
+
+    head = (struct sys_arch_mem_head *)mem - 1;
+    if (head->cached) {
+        intSave = LOS_IntLock();
+        cache = &mem_cache[ArchCurrCpuid()];
+        if (cache->count < SYS_ARCH_MEM_CACHE_NUM) {
+            cache->blocks[cache->count++] = head;
+            head = NULL;
+        }
+        LOS_IntRestore(intSave);
+    }
+
+    if (head != NULL) {
+        (void)LOS_MemFree(OS_SYS_MEM_ADDR, head);
     }
-#else
-    LOS_TaskUnlock();
-#endif /* LOSCFG_KERNEL_SMP */
 }
 
 
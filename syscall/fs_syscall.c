@@ -135,19 +135,25 @@ static int GetFullpathNull(int fd, const char *path, char **filePath)
     return ret;
 }
 
+/* readv and writev may hand the segments to the filesystem as they are, so they are checked like CHECK_ASPACE */
 static int UserIovItemCheck(const struct iovec *iov, const int iovcnt)
 {
+    LosVmSpace *space = OsCurrProcessGet()->vmSpace;
     int i;
+
+    (VOID)LOS_MuxAcquire(&space->regionMux);
     for (i = 0; i < iovcnt; ++i) {
         if (iov[i].iov_len == 0) {
             continue;
         }
 
-        if (!LOS_IsUserAddressRange((vaddr_t)(UINTPTR)iov[i].iov_base, iov[i].iov_len)) {
-            return i;
+        if (!LOS_IsUserAddressRange((vaddr_t)(UINTPTR)iov[i].iov_base, iov[i].iov_len) ||
+            (CheckRegion(space, (VADDR_T)(UINTPTR)iov[i].iov_base, iov[i].iov_len) == -1)) {
+            break;
         }
     }
-    return iovcnt;
+    (VOID)LOS_MuxRelease(&space->regionMux);
+    return i;
 }
 
 static int UserIovCopy(struct iovec **iovBuf, const struct iovec *iov, const int iovcnt, int *valid_iovcnt)
@@ -198,6 +198,7 @@ SYSCALL_HAND_DEF(__NR_ohoscapset, SysCapSet, UINT32, ARG_NUM_1)
 #endif
 
 SYSCALL_HAND_DEF(__NR_mmap2, SysMmap, void*, ARG_NUM_6)
+SYSCALL_HAND_DEF(__NR_madvise, SysMadvise, int, ARG_NUM_3)
 SYSCALL_HAND_DEF(__NR_getuid32, SysGetUserID, int, ARG_NUM_0)
 SYSCALL_HAND_DEF(__NR_getgid32, SysGetGroupID, unsigned int, ARG_NUM_0)
 SYSCALL_HAND_DEF(__NR_geteuid32, SysGetEffUserID, int, ARG_NUM_0)
@@ -60,6 +60,11 @@ int SysMprotect(void *vaddr, size_t len, int prot)
     return LOS_DoMprotect((uintptr_t)vaddr, len, (unsigned long)prot);
 }
 
+int SysMadvise(void *addr, size_t len, int advice)
+{
+    return LOS_DoMadvise((uintptr_t)addr, len, advice);
+}
+
 void *SysBrk(void *addr)
 {
     return LOS_DoBrk(addr);
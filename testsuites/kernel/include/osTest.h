@@ -323,6 +323,8 @@ extern UINT32 TEST_SemDelete(UINT32 semHandle);
 extern VOID ItSuiteLosQueue(VOID);
 extern VOID ItSuiteLosSwtmr(VOID);
 extern VOID ItSuiteLosTask(VOID);
+extern VOID ItSuiteLosMem(VOID);
+extern VOID ItSuiteLosCsum(VOID);
 extern VOID ItSuiteLosEvent(VOID);
 
 extern VOID ItSuiteLosMux(VOID);
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_csum.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#ifdef LOSCFG_ARCH_FPU_VFP_NEON
+static UINT8 g_csumSrc[CSUM_TEST_MAX_LEN + CSUM_TEST_ALIGN];
+static UINT8 g_csumDst[CSUM_TEST_MAX_LEN + CSUM_TEST_ALIGN];
+
+/* Byte-wise RFC 1071 sum, the way the wire defines it */
+static UINT16 CsumReference(const UINT8 *buf, UINT32 len)
+{
+    UINT32 sum = 0;
+    UINT32 i;
+
+    for (i = 0; (i + 1) < len; i += 2) { /* 2: one halfword */
+        sum += (UINT32)buf[i] | ((UINT32)buf[i + 1] << 8); /* 8: little-endian halfword */
+    }
+    if (len & 1) {
+        sum += buf[len - 1];
+    }
+    while (sum >> 16) { /* 16: end-around carry */
+        sum = (sum & 0xFFFF) + (sum >> 16); /* 16: end-around carry */
+    }
+    return (UINT16)sum;
+}
+
+static UINT16 CsumFold(UINT32 sum)
+{
+    sum = (sum & 0xFFFF) + (sum >> 16); /* 16: end-around carry */
+    sum = (sum & 0xFFFF) + (sum >> 16); /* 16: end-around carry */
+    return (UINT16)sum;
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 loop;
+    UINT32 len;
+    UINT32 head;
+    UINT32 srcOff;
+    UINT32 dstOff;
+    UINT32 i;
+    UINT16 expect;
+    UINT16 result;
+
+    for (i = 0; i < sizeof(g_csumSrc); i++) {
+        g_csumSrc[i] = (UINT8)rand();
+    }
+
+    for (loop = 0; loop < CSUM_TEST_LOOP_NUM; loop++) {
+        len = (UINT32)rand() % (CSUM_TEST_MAX_LEN + 1);
+        srcOff = (UINT32)rand() % CSUM_TEST_ALIGN;
+        dstOff = (UINT32)rand() % CSUM_TEST_ALIGN;
+        if ((loop % 8) == 0) { /* 8: every eighth round uses all-ones data to stress the carries */
+            (VOID)memset_s(g_csumSrc + srcOff, len, 0xFF, len);
+        }
+        expect = CsumReference(g_csumSrc + srcOff, len);
+
+        result = CsumFold(csum_partial_neon(g_csumSrc + srcOff, (INT32)len, 0));
+        ICUNIT_ASSERT_EQUAL(result, expect, len);
+
+        /* Chaining through the unfolded sum has to match a single pass */
+        head = ((len != 0) ? ((UINT32)rand() % len) : 0) & ~1U;
+        result = CsumFold(csum_partial_neon(g_csumSrc + srcOff + head, (INT32)(len - head),
+                                            csum_partial_neon(g_csumSrc + srcOff, (INT32)head, 0)));
+        ICUNIT_ASSERT_EQUAL(result, expect, head);
+
+        (VOID)memset_s(g_csumDst, sizeof(g_csumDst), 0, sizeof(g_csumDst));
+        result = CsumFold(csum_partial_copy_neon(g_csumSrc + srcOff, g_csumDst + dstOff, (INT32)len, 0));
+        ICUNIT_ASSERT_EQUAL(result, expect, len);
+        ICUNIT_ASSERT_EQUAL(memcmp(g_csumSrc + srcOff, g_csumDst + dstOff, len), 0, dstOff);
+
+        if ((loop % 8) == 0) { /* 8: restore random data after the all-ones round */
+            for (i = 0; i < len; i++) {
+                g_csumSrc[srcOff + i] = (UINT8)rand();
+            }
+        }
+    }
+
+    return LOS_OK;
+}
+
+VOID ItLosCsum001(VOID)
+{
+    TEST_ADD_CASE("ItLosCsum001", Testcase, TEST_LOS, TEST_MISC, TEST_LEVEL0, TEST_FUNCTION);
+}
+#endif
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mem.h"
+#include "los_vm_phys.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+static UINT32 PageIsZero(LosVmPage *page)
+{
+    UINT32 *word = (UINT32 *)OsVmPageToVaddr(page);
+    UINT32 index;
+
+    for (index = 0; index < (PAGE_SIZE / sizeof(UINT32)); index++) {
+        if (word[index] != 0) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static UINT32 Testcase(VOID)
+{
+    LosVmPage *page = NULL;
+    UINT32 ret;
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+    UINT32 count, hit, miss;
+    UINT32 hitBefore;
+#endif
+
+    /* leave a dirty page behind for the next allocation to pick up */
+    page = LOS_PhysPageAlloc();
+    ICUNIT_ASSERT_NOT_EQUAL(page, NULL, page);
+    LOS_AtomicInc(&page->refCounts);
+    (VOID)memset_s(OsVmPageToVaddr(page), PAGE_SIZE, 0x5A, PAGE_SIZE); /* 0x5A, dirty pattern */
+    LOS_PhysPageFree(page);
+
+    page = LOS_PhysZeroPageAlloc();
+    ICUNIT_ASSERT_NOT_EQUAL(page, NULL, page);
+    LOS_AtomicInc(&page->refCounts);
+    ret = PageIsZero(page);
+    LOS_PhysPageFree(page);
+    ICUNIT_ASSERT_EQUAL(ret, TRUE, ret);
+
+#ifdef LOSCFG_VM_ZERO_PAGE_POOL
+    (VOID)OsVmZeroPoolFill();
+    OsVmZeroPoolInfoGet(&count, &hitBefore, &miss);
+    ICUNIT_ASSERT_NOT_EQUAL(count, 0, count);
+
+    page = LOS_PhysZeroPageAlloc();
+    ICUNIT_ASSERT_NOT_EQUAL(page, NULL, page);
+    LOS_AtomicInc(&page->refCounts);
+    ret = PageIsZero(page);
+    LOS_PhysPageFree(page);
+    ICUNIT_ASSERT_EQUAL(ret, TRUE, ret);
+
+    OsVmZeroPoolInfoGet(&count, &hit, &miss);
+    ICUNIT_ASSERT_NOT_EQUAL(hit, hitBefore, hit);
+#endif
+
+    return LOS_OK;
+}
+
+VOID ItLosMem001(VOID)
+{
+    TEST_ADD_CASE("ItLosMem001", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mem.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define MEM_DOUBLE_FREE_SIZE 32
+
+static UINT32 Testcase(VOID)
+{
+    VOID *ptr = NULL;
+    VOID *ptr1 = NULL;
+    VOID *ptr2 = NULL;
+    UINT32 ret;
+
+    ptr = LOS_MemAlloc(m_aucSysMem0, MEM_DOUBLE_FREE_SIZE);
+    ICUNIT_ASSERT_NOT_EQUAL(ptr, NULL, ptr);
+
+    ret = LOS_MemFree(m_aucSysMem0, ptr);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    /* the block may sit in the per-cpu cache now, a second free must still be refused */
+    ret = LOS_MemFree(m_aucSysMem0, ptr);
+    ICUNIT_ASSERT_NOT_EQUAL(ret, LOS_OK, ret);
+
+    ptr1 = LOS_MemAlloc(m_aucSysMem0, MEM_DOUBLE_FREE_SIZE);
+    ICUNIT_ASSERT_NOT_EQUAL(ptr1, NULL, ptr1);
+    ptr2 = LOS_MemAlloc(m_aucSysMem0, MEM_DOUBLE_FREE_SIZE);
+    ICUNIT_GOTO_NOT_EQUAL(ptr2, NULL, ptr2, EXIT);
+    ICUNIT_GOTO_NOT_EQUAL(ptr1, ptr2, ptr2, EXIT);
+
+    /* a pointer into the middle of a block is not a block, it must neither be cached nor freed */
+    (VOID)memset_s(ptr2, MEM_DOUBLE_FREE_SIZE, 0, MEM_DOUBLE_FREE_SIZE);
+    ret = LOS_MemFree(m_aucSysMem0, (UINT8 *)ptr2 + (MEM_DOUBLE_FREE_SIZE >> 1));
+    ICUNIT_GOTO_NOT_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_MemFree(m_aucSysMem0, ptr2);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_MemFree(m_aucSysMem0, ptr1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    return LOS_OK;
+
+EXIT:
+    (VOID)LOS_MemFree(m_aucSysMem0, ptr1);
+    return LOS_NOK;
+}
+
+VOID ItLosMem002(VOID)
+{
+    TEST_ADD_CASE("ItLosMem002", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mem.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+static UINT32 g_memBenchTaskID[LOSCFG_KERNEL_CORE_NUM];
+static UINT32 g_memBenchFail;
+
+static VOID TaskF01(VOID)
+{
+    VOID *ptr[MEM_BENCH_BATCH];
+    UINT32 loop;
+    UINT32 index;
+
+    for (loop = 0; loop < MEM_BENCH_LOOP_NUM; loop++) {
+        for (index = 0; index < MEM_BENCH_BATCH; index++) {
+            ptr[index] = LOS_MemAlloc(m_aucSysMem0, 16 << (index & 0x3)); /* 16, 32, 64, 128 bytes */
+            if (ptr[index] == NULL) {
+                g_memBenchFail++;
+            }
+        }
+        for (index = 0; index < MEM_BENCH_BATCH; index++) {
+            (VOID)LOS_MemFree(m_aucSysMem0, ptr[index]);
+        }
+    }
+
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(VOID)
+{
+    TSK_INIT_PARAM_S task = { 0 };
+    LOS_MEM_POOL_STATUS status = { 0 };
+    UINT32 ret;
+    UINT32 cpuid;
+    UINT64 startTime;
+    UINT64 costTime;
+
+    g_testCount = 0;
+    g_memBenchFail = 0;
+
+    ret = LOS_MemInfoGet(m_aucSysMem0, &status);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+    UINT32 hitNum = status.cacheHitNum;
+#endif
+
+    startTime = LOS_CurrNanosec();
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        TEST_TASK_PARAM_INIT_AFFI(task, "it_smp_mem_001", TaskF01, TASK_PRIO_TEST - 1, CPUID_TO_AFFI_MASK(cpuid));
+        ret = LOS_TaskCreate(&g_memBenchTaskID[cpuid], &task);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    }
+
+    while (g_testCount < LOSCFG_KERNEL_CORE_NUM) {
+        (VOID)LOS_TaskDelay(10); /* 10, poll the result every 10 ticks */
+    }
+    costTime = LOS_CurrNanosec() - startTime;
+
+    ICUNIT_ASSERT_EQUAL(g_memBenchFail, 0, g_memBenchFail);
+    PRINTK("mem alloc storm: %u cores, %llu alloc/free pairs per second\n", LOSCFG_KERNEL_CORE_NUM,
+           ((UINT64)LOSCFG_KERNEL_CORE_NUM * MEM_BENCH_LOOP_NUM * MEM_BENCH_BATCH * OS_SYS_NS_PER_SECOND) /
+           (costTime + 1));
+
+    ret = LOS_MemInfoGet(m_aucSysMem0, &status);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+#ifdef LOSCFG_MEM_PERCPU_CACHE
+    PRINTK("per-cpu cache: hit %u, miss %u\n", status.cacheHitNum - hitNum, status.cacheMissNum);
+    ICUNIT_ASSERT_NOT_EQUAL(status.cacheHitNum, hitNum, status.cacheHitNum);
+#endif
+
+    return LOS_OK;
+
+EXIT:
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        (VOID)LOS_TaskDelete(g_memBenchTaskID[cpuid]);
+    }
+    return LOS_NOK;
+}
+
+VOID ItSmpLosMem001(VOID)
+{
+    TEST_ADD_CASE("ItSmpLosMem001", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL3, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mem.h"
+#include "los_vm_phys.h"
+#include "los_vm_dump.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+static UINT32 g_pageBenchTaskID[LOSCFG_KERNEL_CORE_NUM];
+static UINT32 g_pageBenchFail;
+
+static VOID TaskF01(VOID)
+{
+    LosVmPage *page[MEM_BENCH_BATCH];
+    UINT32 loop;
+    UINT32 index;
+
+    for (loop = 0; loop < PAGE_BENCH_LOOP_NUM; loop++) {
+        for (index = 0; index < MEM_BENCH_BATCH; index++) {
+            page[index] = LOS_PhysPageAlloc();
+            if (page[index] == NULL) {
+                g_pageBenchFail++;
+                continue;
+            }
+            LOS_AtomicInc(&page[index]->refCounts);
+            /* touch the page like a fault handler filling it would */
+            *(volatile UINT32 *)OsVmPageToVaddr(page[index]) = loop;
+        }
+        for (index = 0; index < MEM_BENCH_BATCH; index++) {
+            LOS_PhysPageFree(page[index]);
+        }
+    }
+
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(VOID)
+{
+    TSK_INIT_PARAM_S task = { 0 };
+    UINT32 ret;
+    UINT32 cpuid;
+    UINT32 usedCount = 0;
+    UINT32 totalCount = 0;
+    UINT32 usedBefore;
+    UINT64 startTime;
+    UINT64 costTime;
+
+    g_testCount = 0;
+    g_pageBenchFail = 0;
+
+    OsVmPhysUsedInfoGet(&usedCount, &totalCount);
+    usedBefore = usedCount;
+
+    startTime = LOS_CurrNanosec();
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        TEST_TASK_PARAM_INIT_AFFI(task, "it_smp_mem_002", TaskF01, TASK_PRIO_TEST - 1, CPUID_TO_AFFI_MASK(cpuid));
+        ret = LOS_TaskCreate(&g_pageBenchTaskID[cpuid], &task);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    }
+
+    while (g_testCount < LOSCFG_KERNEL_CORE_NUM) {
+        (VOID)LOS_TaskDelay(10); /* 10, poll the result every 10 ticks */
+    }
+    costTime = LOS_CurrNanosec() - startTime;
+
+    ICUNIT_ASSERT_EQUAL(g_pageBenchFail, 0, g_pageBenchFail);
+    PRINTK("page fault storm: %u cores, %llu page alloc/free pairs per second\n", LOSCFG_KERNEL_CORE_NUM,
+           ((UINT64)LOSCFG_KERNEL_CORE_NUM * PAGE_BENCH_LOOP_NUM * MEM_BENCH_BATCH * OS_SYS_NS_PER_SECOND) /
+           (costTime + 1));
+
+    /* pages parked in the per-cpu lists still count as free */
+    OsVmPhysUsedInfoGet(&usedCount, &totalCount);
+    ICUNIT_ASSERT_EQUAL(usedCount, usedBefore, usedCount);
+
+    return LOS_OK;
+
+EXIT:
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        (VOID)LOS_TaskDelete(g_pageBenchTaskID[cpuid]);
+    }
+    return LOS_NOK;
+}
+
+VOID ItSmpLosMem002(VOID)
+{
+    TEST_ADD_CASE("ItSmpLosMem002", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL3, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
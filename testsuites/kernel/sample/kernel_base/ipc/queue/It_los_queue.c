@@ -81,6 +81,9 @@ VOID ItSuiteLosQueue(VOID)
     ItLosQueue105();
 #endif
     ItLosQueueHead002();
+    ItLosQueue117();
+    ItLosQueue118();
+    ItLosQueue124();
 #endif
 
 #if defined(LOSCFG_TEST_FULL)
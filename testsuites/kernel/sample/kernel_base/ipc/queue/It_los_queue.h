@@ -71,6 +71,9 @@ VOID ItLosQueue100(VOID);
 VOID ItLosQueue105(VOID);
 #endif
 VOID ItLosQueueHead002(VOID);
+VOID ItLosQueue117(VOID);
+VOID ItLosQueue118(VOID);
+VOID ItLosQueue124(VOID);
 #endif
 
 #if defined(LOSCFG_TEST_FULL)
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_queue.h"
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret;
+    UINT32 queueID;
+    VOID *node1 = NULL;
+    VOID *node2 = NULL;
+    CHAR buff[QUEUE_SHORT_BUFFER_LENGTH] = "";
+    UINT32 readSize;
+
+    ret = LOS_QueueCreate("Q1", 3, &queueID, 0, QUEUE_SHORT_BUFFER_LENGTH); // 3, Set the queue length.
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_QueueReserve(queueID, &node1, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_QueueReserve(queueID, &node2, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_QueueDelete(queueID);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_IN_TSKWRITE, ret, EXIT);
+
+    ret = strcpy_s((CHAR *)node2, QUEUE_SHORT_BUFFER_LENGTH, "second");
+    ICUNIT_GOTO_EQUAL(ret, EOK, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, node2, strlen("second") + 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* node2 was committed already and the node after it was never reserved */
+    ret = LOS_QueueCommit(queueID, node2, strlen("second") + 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, (UINT8 *)node2 + QUEUE_SHORT_BUFFER_LENGTH + sizeof(UINT32), 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, (UINT8 *)node1 + 1, 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+
+    /* the first commit takes the oldest position: node2 is read first */
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopy(queueID, buff, &readSize, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(readSize, strlen("second") + 1, readSize, EXIT);
+    ICUNIT_GOTO_STRING_EQUAL(buff, "second", buff, EXIT);
+
+    ret = strcpy_s((CHAR *)node1, QUEUE_SHORT_BUFFER_LENGTH, "first");
+    ICUNIT_GOTO_EQUAL(ret, EOK, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, node1, strlen("first") + 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopy(queueID, buff, &readSize, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_STRING_EQUAL(buff, "first", buff, EXIT);
+
+    ret = LOS_QueueDelete(queueID);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    return LOS_OK;
+
+EXIT:
+    LOS_QueueDelete(queueID);
+    return LOS_OK;
+}
+
+VOID ItLosQueue117(VOID)
+{
+    TEST_ADD_CASE("ItLosQueue117", Testcase, TEST_LOS, TEST_QUE, TEST_LEVEL0, TEST_FUNCTION);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
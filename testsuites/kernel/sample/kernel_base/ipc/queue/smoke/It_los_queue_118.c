@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_queue.h"
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret;
+    UINT32 queueID;
+    VOID *node = NULL;
+    VOID *other = NULL;
+    CHAR buff1[QUEUE_SHORT_BUFFER_LENGTH] = "abc";
+    CHAR buff2[QUEUE_SHORT_BUFFER_LENGTH] = "";
+    UINT32 readSize;
+
+    ret = LOS_QueueCreate("Q1", 2, &queueID, LOS_QUEUE_SPSC, QUEUE_SHORT_BUFFER_LENGTH); // 2, Set the queue length.
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_QueueWriteHeadCopy(queueID, buff1, QUEUE_SHORT_BUFFER_LENGTH, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+
+    ret = LOS_QueueWriteCopy(queueID, buff1, QUEUE_SHORT_BUFFER_LENGTH, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_QueueReserve(queueID, &node, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* the writer holds the tail node until it commits it */
+    ret = LOS_QueueReserve(queueID, &other, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+    ret = LOS_QueueWriteCopy(queueID, buff1, QUEUE_SHORT_BUFFER_LENGTH, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+    ret = LOS_QueueDelete(queueID);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_IN_TSKUSE, ret, EXIT);
+
+    /* only the reserved tail node can be committed */
+    ret = LOS_QueueCommit(queueID, (UINT8 *)node + QUEUE_SHORT_BUFFER_LENGTH + sizeof(UINT32), 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, (UINT8 *)node - QUEUE_SHORT_BUFFER_LENGTH - sizeof(UINT32), 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+
+    ret = strcpy_s((CHAR *)node, QUEUE_SHORT_BUFFER_LENGTH, "def");
+    ICUNIT_GOTO_EQUAL(ret, EOK, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, node, strlen("def") + 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_QueueCommit(queueID, node, strlen("def") + 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+
+    ret = LOS_QueueWriteCopy(queueID, buff1, QUEUE_SHORT_BUFFER_LENGTH, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_ISFULL, ret, EXIT);
+
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopy(queueID, buff2, &readSize, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_STRING_EQUAL(buff2, "abc", buff2, EXIT);
+
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopy(queueID, buff2, &readSize, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(readSize, strlen("def") + 1, readSize, EXIT);
+    ICUNIT_GOTO_STRING_EQUAL(buff2, "def", buff2, EXIT);
+
+    /* the wait ends when the whole timeout has passed */
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopy(queueID, buff2, &readSize, 2); // 2, Set the timeout in ticks.
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_TIMEOUT, ret, EXIT);
+
+    ret = LOS_QueueDelete(queueID);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    return LOS_OK;
+
+EXIT:
+    LOS_QueueDelete(queueID);
+    return LOS_OK;
+}
+
+VOID ItLosQueue118(VOID)
+{
+    TEST_ADD_CASE("ItLosQueue118", Testcase, TEST_LOS, TEST_QUE, TEST_LEVEL0, TEST_FUNCTION);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_queue.h"
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret;
+    UINT32 queueID;
+    UINT32 prio;
+    VOID *node = NULL;
+    CHAR buff[QUEUE_SHORT_BUFFER_LENGTH] = "";
+    UINT32 readSize;
+
+    /* the priority is neither used nor checked on a FIFO queue */
+    ret = LOS_QueueCreate("Q1", 3, &queueID, 0, QUEUE_SHORT_BUFFER_LENGTH); // 3, Set the queue length.
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_QueueWriteCopyPrio(queueID, "fifo", strlen("fifo") + 1, LOS_QUEUE_PRIO_NUM, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopyPrio(queueID, buff, &readSize, &prio, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(prio, 0, prio, EXIT);
+    ICUNIT_GOTO_STRING_EQUAL(buff, "fifo", buff, EXIT);
+    ret = LOS_QueueDelete(queueID);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_QueueCreate("Q1", 3, &queueID, LOS_QUEUE_PRIO, QUEUE_SHORT_BUFFER_LENGTH); // 3, Set the queue length.
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_QueueWriteCopyPrio(queueID, "bad", strlen("bad") + 1, LOS_QUEUE_PRIO_NUM, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+
+    ret = LOS_QueueWriteCopyPrio(queueID, "low", strlen("low") + 1, 1, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_QueueReserve(queueID, &node, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = strcpy_s((CHAR *)node, QUEUE_SHORT_BUFFER_LENGTH, "high");
+    ICUNIT_GOTO_EQUAL(ret, EOK, ret, EXIT);
+    ret = LOS_QueueCommitPrio(queueID, node, strlen("high") + 1, LOS_QUEUE_PRIO_NUM);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_INVALID, ret, EXIT);
+    ret = LOS_QueueCommitPrio(queueID, node, strlen("high") + 1, 5); // 5, a priority above the first message.
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* the committed message overtakes the one written before it */
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopyPrio(queueID, buff, &readSize, &prio, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(prio, 5, prio, EXIT); // 5, the priority given at commit.
+    ICUNIT_GOTO_STRING_EQUAL(buff, "high", buff, EXIT);
+
+    readSize = QUEUE_SHORT_BUFFER_LENGTH;
+    ret = LOS_QueueReadCopyPrio(queueID, buff, &readSize, &prio, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(prio, 1, prio, EXIT);
+    ICUNIT_GOTO_STRING_EQUAL(buff, "low", buff, EXIT);
+
+    ret = LOS_QueueDelete(queueID);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    return LOS_OK;
+
+EXIT:
+    LOS_QueueDelete(queueID);
+    return LOS_OK;
+}
+
+VOID ItLosQueue124(VOID)
+{
+    TEST_ADD_CASE("ItLosQueue124", Testcase, TEST_LOS, TEST_QUE, TEST_LEVEL0, TEST_FUNCTION);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -379,6 +379,8 @@ VOID TestKernelBase(VOID)
     ItSuiteLosTask();
     ItSuiteLosSwtmr();
     ItSuiteLosMux();
+    ItSuiteLosMem();
+    ItSuiteLosCsum();
 #endif
 }
 
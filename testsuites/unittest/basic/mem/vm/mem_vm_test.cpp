@@ -112,6 +112,26 @@ HWTEST_F(MemVmTest, ItTestMmap010, TestSize.Level0)
     ItTestMmap010();
 }
 
+/* *
+ * @tc.name: it_test_mmap_011
+ * @tc.desc: function for MemVmTest
+ * @tc.type: FUNC
+ */
+HWTEST_F(MemVmTest, ItTestMmap011, TestSize.Level0)
+{
+    ItTestMmap011();
+}
+
+/* *
+ * @tc.name: it_test_mmap_012
+ * @tc.desc: function for MemVmTest
+ * @tc.type: FUNC
+ */
+HWTEST_F(MemVmTest, ItTestMmap012, TestSize.Level0)
+{
+    ItTestMmap012();
+}
+
 /* *
  * @tc.name: it_test_mprotect_001
  * @tc.desc: function for MemVmTest
@@ -144,6 +164,16 @@ HWTEST_F(MemVmTest, ItTestMremap001, TestSize.Level0)
     ItTestMremap001();
 }
 
+/* *
+ * @tc.name: it_test_madvise_001
+ * @tc.desc: function for MemVmTest
+ * @tc.type: FUNC
+ */
+HWTEST_F(MemVmTest, ItTestMadvise001, TestSize.Level0)
+{
+    ItTestMadvise001();
+}
+
 /* *
  * @tc.name: it_test_user_copy_001
  * @tc.desc: function for MemVmTest
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vm.h"
+
+#define MADVISE_TEST_PAGES 4
+
+static int Testcase(void)
+{
+    char *p = NULL;
+    int pageSize;
+    int ret;
+    int i;
+
+    pageSize = getpagesize();
+
+    p = (char *)mmap(NULL, pageSize * MADVISE_TEST_PAGES, PROT_READ | PROT_WRITE,
+                     MAP_ANONYMOUS | MAP_PRIVATE | MAP_POPULATE, -1, 0);
+    ICUNIT_ASSERT_NOT_EQUAL(p, MAP_FAILED, p);
+    for (i = 0; i < pageSize * MADVISE_TEST_PAGES; i++) {
+        ICUNIT_GOTO_EQUAL(p[i], 0, p[i], EXIT);
+    }
+    (void)memset_s(p, pageSize * MADVISE_TEST_PAGES, 0xf, pageSize * MADVISE_TEST_PAGES);
+
+    ret = madvise(p + 1, pageSize, MADV_NORMAL);
+    ICUNIT_GOTO_EQUAL(ret, -1, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(errno, EINVAL, errno, EXIT);
+
+    ret = madvise(p, pageSize, 0xffff);
+    ICUNIT_GOTO_EQUAL(ret, -1, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(errno, EINVAL, errno, EXIT);
+
+    ret = madvise(p, pageSize * (MADVISE_TEST_PAGES + 1), MADV_NORMAL);
+    ICUNIT_GOTO_EQUAL(ret, -1, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(errno, ENOMEM, errno, EXIT);
+
+    ret = madvise(p + pageSize, pageSize, MADV_SEQUENTIAL);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ret = madvise(p + pageSize * 2, pageSize, MADV_RANDOM);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ret = madvise(p, pageSize * MADVISE_TEST_PAGES, MADV_WILLNEED);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(p[pageSize * 2], 0xf, p[pageSize * 2], EXIT);
+
+    /* the dropped page reads back as zero, its neighbours keep their data */
+    ret = madvise(p + pageSize * 3, pageSize, MADV_DONTNEED);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(p[pageSize * 3], 0, p[pageSize * 3], EXIT);
+    ICUNIT_GOTO_EQUAL(p[pageSize * 3 - 1], 0xf, p[pageSize * 3 - 1], EXIT);
+
+    ret = munmap(p, pageSize * MADVISE_TEST_PAGES);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    return 0;
+
+EXIT:
+    (void)munmap(p, pageSize * MADVISE_TEST_PAGES);
+    return -1;
+}
+
+void ItTestMadvise001(void)
+{
+    TEST_ADD_CASE("IT_MEM_MADVISE_001", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vm.h"
+#include <pthread.h>
+
+#define FAULT_TEST_THREADS 4
+#define FAULT_TEST_PAGES   64
+#define FAULT_TEST_LOOPS   16
+
+static char *g_faultBuf = NULL;
+static int g_faultPageSize;
+
+static void *FaultThread(void *arg)
+{
+    int index = (int)(intptr_t)arg;
+    int i;
+
+    /* every thread touches every page, so the faults race on the same pages as well as on different ones */
+    for (i = 0; i < FAULT_TEST_PAGES; i++) {
+        g_faultBuf[(((i + index) % FAULT_TEST_PAGES) * g_faultPageSize) + index] = (char)(index + 1);
+    }
+    return NULL;
+}
+
+static int Testcase(void)
+{
+    pthread_t threads[FAULT_TEST_THREADS];
+    size_t len;
+    char *p = NULL;
+    int ret;
+    int i;
+    int j;
+
+    g_faultPageSize = getpagesize();
+    len = (size_t)g_faultPageSize * FAULT_TEST_PAGES;
+    g_faultBuf = (char *)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    ICUNIT_ASSERT_NOT_EQUAL(g_faultBuf, MAP_FAILED, g_faultBuf);
+
+    for (i = 0; i < FAULT_TEST_THREADS; i++) {
+        ret = pthread_create(&threads[i], NULL, FaultThread, (void *)(intptr_t)i);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    }
+
+    /* address space changes take the exclusive side while the faults go on */
+    for (i = 0; i < FAULT_TEST_LOOPS; i++) {
+        p = (char *)mmap(NULL, g_faultPageSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        ICUNIT_GOTO_NOT_EQUAL(p, MAP_FAILED, p, JOIN);
+        p[0] = 1;
+        ret = munmap(p, g_faultPageSize);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, JOIN);
+    }
+
+JOIN:
+    for (i = 0; i < FAULT_TEST_THREADS; i++) {
+        (void)pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < FAULT_TEST_PAGES; i++) {
+        for (j = 0; j < FAULT_TEST_THREADS; j++) {
+            ICUNIT_GOTO_EQUAL(g_faultBuf[i * g_faultPageSize + j], j + 1, g_faultBuf[i * g_faultPageSize + j], EXIT);
+        }
+    }
+
+    ret = munmap(g_faultBuf, len);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    return 0;
+
+EXIT:
+    (void)munmap(g_faultBuf, len);
+    return -1;
+}
+
+void ItTestMmap011(void)
+{
+    TEST_ADD_CASE("IT_MEM_MMAP_011", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
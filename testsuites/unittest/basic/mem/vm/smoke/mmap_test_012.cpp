@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "it_test_vm.h"
+
+#define INVALID_PROCESS_ID 100000
+#define ASID_TEST_CHILDREN 300 /* more than the 256 hardware asids, so the asid generation rolls over */
+#define PARENT_MAGIC       0x5a5a5a5a
+
+/* every child maps the same address with its own data; a stale TLB entry from an earlier asid would show */
+static int Testcase(void)
+{
+    int pageSize = getpagesize();
+    int *ptr = NULL;
+    int status = 0;
+    pid_t pid;
+    int ret;
+    int i;
+
+    ptr = (int *)mmap(NULL, pageSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    ICUNIT_ASSERT_NOT_EQUAL(ptr, MAP_FAILED, ptr);
+    *ptr = PARENT_MAGIC;
+
+    for (i = 0; i < ASID_TEST_CHILDREN; i++) {
+        pid = fork();
+        ICUNIT_GOTO_WITHIN_EQUAL(pid, 0, INVALID_PROCESS_ID, pid, EXIT);
+        if (pid == 0) {
+            if (*ptr != PARENT_MAGIC) {
+                exit(1);
+            }
+            *ptr = i;
+            exit((*ptr == i) ? 0 : 1);
+        }
+
+        ret = waitpid(pid, &status, 0);
+        ICUNIT_GOTO_EQUAL(ret, pid, ret, EXIT);
+        ret = WIFEXITED(status);
+        ICUNIT_GOTO_EQUAL(ret, 1, ret, EXIT);
+        ret = WEXITSTATUS(status);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(*ptr, PARENT_MAGIC, *ptr, EXIT);
+    }
+
+    ret = munmap(ptr, pageSize);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    return 0;
+
+EXIT:
+    (void)munmap(ptr, pageSize);
+    return -1;
+}
+
+void ItTestMmap012(void)
+{
+    TEST_ADD_CASE("IT_MEM_MMAP_012", Testcase, TEST_LOS, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -1377,6 +1377,18 @@ HWTEST_F(ContainerTest, ItNetContainer010, TestSize.Level0)
 {
     ItNetContainer010();
 }
+
+/**
+* @tc.name: Container_NET_Test_013
+* @tc.desc: net container veth throughput test case
+* @tc.type: FUNC
+* @tc.require: issueI6HPH2
+* @tc.author:
+*/
+HWTEST_F(ContainerTest, ItNetContainer013, TestSize.Level0)
+{
+    ItNetContainer013();
+}
 #endif
 #endif
 } // namespace OHOS
@@ -236,4 +236,5 @@ void ItNetContainer009(void);
 void ItNetContainer010(void);
 void ItNetContainer011(void);
 void ItNetContainer012(void);
+void ItNetContainer013(void);
 #endif /* _IT_CONTAINER_TEST_H */
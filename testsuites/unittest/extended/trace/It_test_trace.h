@@ -52,8 +52,27 @@ typedef struct {
     uintptr_t params[TRACE_USR_MAX_PARAMS];
 } UsrEventInfo;
 
+typedef struct {
+    unsigned int bigLittleEndian;
+    unsigned int clockFreq;
+    unsigned int version;
+    unsigned short totalLen;
+    unsigned short objSize;
+    unsigned short frameSize;
+    unsigned short objOffset;
+    unsigned short frameOffset;
+} TraceOfflineHead;
+
+typedef struct {
+    unsigned int eventType;
+    unsigned int curTask;
+    unsigned int curPid;
+    unsigned long long curTime;
+} TraceFrameHead;
+
 VOID ItTestTrace001(VOID);
 VOID ItTestTrace002(VOID);
 VOID ItTestTrace003(VOID);
 VOID ItTestTrace004(VOID);
+VOID ItTestTrace005(VOID);
 #endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2023 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_test_trace.h"
+#include <time.h>
+
+#define TRACE_BENCH_EVENTS  1000
+#define TRACE_BUFFER_SIZE   10000
+#define NSEC_PER_SEC_TEST   1000000000LL
+
+static long long WriteEvents(int fd, UsrEventInfo *info)
+{
+    int i;
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < TRACE_BENCH_EVENTS; i++) {
+        info->identity = i;
+        (void)write(fd, info, sizeof(UsrEventInfo));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * NSEC_PER_SEC_TEST + (end.tv_nsec - start.tv_nsec);
+}
+
+static UINT32 TestCase(VOID)
+{
+    int len;
+    int offset;
+    long long untraced, traced;
+    unsigned long long lastTime = 0;
+    char *buffer = NULL;
+    TraceOfflineHead *head = NULL;
+    UsrEventInfo info = {
+        .eventType = 0x1,
+        .identity = 0,
+        .params = {1, 2, 3},
+    };
+
+    int fd = open("/dev/trace", O_RDWR);
+    ICUNIT_GOTO_NOT_EQUAL(fd, -1, errno, EXIT);
+
+    ioctl(fd, TRACE_STOP, NULL);
+    ioctl(fd, TRACE_RESET, NULL);
+    untraced = WriteEvents(fd, &info);
+
+    ioctl(fd, TRACE_START, NULL);
+    traced = WriteEvents(fd, &info);
+    ioctl(fd, TRACE_STOP, NULL);
+    printf("trace overhead per event: %lld ns\n", (traced - untraced) / TRACE_BENCH_EVENTS);
+
+    buffer = static_cast<char *>(malloc(TRACE_BUFFER_SIZE));
+    ICUNIT_GOTO_NOT_EQUAL(buffer, NULL, buffer, EXIT);
+
+    /* the events of all cpus are read back in timestamp order */
+    len = read(fd, buffer, TRACE_BUFFER_SIZE);
+    ICUNIT_GOTO_NOT_EQUAL(len, -1, len, EXIT1);
+    head = reinterpret_cast<TraceOfflineHead *>(buffer);
+    for (offset = head->frameOffset; offset + head->frameSize <= len; offset += head->frameSize) {
+        TraceFrameHead *frame = reinterpret_cast<TraceFrameHead *>(buffer + offset);
+        if (frame->curTime == 0) {
+            break;
+        }
+        ICUNIT_GOTO_EQUAL(frame->curTime >= lastTime, TRUE, frame->curTime, EXIT1);
+        lastTime = frame->curTime;
+    }
+    ICUNIT_GOTO_NOT_EQUAL(lastTime, 0, lastTime, EXIT1);
+
+EXIT1:
+    free(buffer);
+EXIT:
+    close(fd);
+    return 0;
+}
+
+VOID ItTestTrace005(VOID)
+{
+    TEST_ADD_CASE("IT_TEST_TRACE_005", TestCase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_PERFORMANCE);
+}
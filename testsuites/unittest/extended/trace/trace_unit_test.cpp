@@ -82,5 +82,15 @@ HWTEST_F(TraceTest, ItTestTrace004, TestSize.Level0)
 {
     ItTestTrace004();
 }
+
+/* *
+ * @tc.name: IT_TEST_TRACE_005
+ * @tc.desc: per event overhead of trace, and events read back in timestamp order
+ * @tc.type: PERF
+ */
+HWTEST_F(TraceTest, ItTestTrace005, TestSize.Level0)
+{
+    ItTestTrace005();
+}
 #endif
 } // namespace OHOS
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_test_IO.h"
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static UINT32 testcase(VOID)
+{
+    int pipeFd[2]; /* 2, pipe id num */
+    int pipeFd2[2]; /* 2, pipe id num */
+    int epFd;
+    int retval;
+    int i;
+    BOOL found = FALSE;
+    char buf[16]; /* 16, more than one write */
+    struct epoll_event ev;
+    struct epoll_event evWait[2]; /* 2, evs num */
+
+    retval = pipe(pipeFd);
+    ICUNIT_ASSERT_EQUAL(retval, 0, retval);
+
+    epFd = epoll_create1(0);
+    ICUNIT_GOTO_NOT_EQUAL(epFd, -1, epFd, OUT2);
+
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.fd = pipeFd[0];
+    retval = epoll_ctl(epFd, EPOLL_CTL_ADD, pipeFd[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+
+    retval = epoll_ctl(epFd, EPOLL_CTL_ADD, pipeFd[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, -1, retval, OUT1);
+    ICUNIT_GOTO_EQUAL(errno, EEXIST, errno, OUT1);
+
+    retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+
+    retval = write(pipeFd[1], "0123456789", 10); /* 10, write size */
+    ICUNIT_GOTO_EQUAL(retval, 10, retval, OUT1); /* 10, write size */
+
+    retval = epoll_wait(epFd, evWait, 2, 1000); /* 2, num of wait fd. 1000, wait time */
+    ICUNIT_GOTO_EQUAL(retval, 1, retval, OUT1);
+    ICUNIT_GOTO_EQUAL(evWait[0].data.fd, pipeFd[0], evWait[0].data.fd, OUT1);
+    ICUNIT_GOTO_NOT_EQUAL(evWait[0].events & EPOLLIN, 0, evWait[0].events, OUT1);
+
+    /* the oneshot fd is disabled after reported, though the data is not read */
+    retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+
+    /* rearm it as level triggered, it is reported by each wait while readable */
+    ev.events = EPOLLIN;
+    retval = epoll_ctl(epFd, EPOLL_CTL_MOD, pipeFd[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+
+    retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+    ICUNIT_GOTO_EQUAL(retval, 1, retval, OUT1);
+    retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+    ICUNIT_GOTO_EQUAL(retval, 1, retval, OUT1);
+
+    /* the level triggered fd that stays readable does not hide a fd that becomes readable later */
+    retval = pipe(pipeFd2);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+    ev.events = EPOLLIN;
+    ev.data.fd = pipeFd2[0];
+    retval = epoll_ctl(epFd, EPOLL_CTL_ADD, pipeFd2[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT3);
+    retval = write(pipeFd2[1], "0123456789", 10); /* 10, write size */
+    ICUNIT_GOTO_EQUAL(retval, 10, retval, OUT3); /* 10, write size */
+
+    for (i = 0; (i < 2) && !found; i++) { /* 2, the ready list is scanned for one lap at most */
+        retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+        ICUNIT_GOTO_NOT_EQUAL(retval, 0, retval, OUT3);
+        found = (evWait[0].data.fd == pipeFd2[0]) || ((retval > 1) && (evWait[1].data.fd == pipeFd2[0]));
+    }
+    ICUNIT_GOTO_EQUAL(found, TRUE, found, OUT3);
+
+    /* edge triggered: the data already there is reported once, then only new data after it was all read */
+    ev.events = EPOLLIN | EPOLLET;
+    retval = epoll_ctl(epFd, EPOLL_CTL_MOD, pipeFd2[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT3);
+    found = FALSE;
+    for (i = 0; i < 3; i++) { /* 3, more waits than one lap of the ready list and a full scan */
+        retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+        ICUNIT_GOTO_NOT_EQUAL(retval, -1, retval, OUT3);
+        if ((evWait[0].data.fd == pipeFd2[0]) || ((retval > 1) && (evWait[1].data.fd == pipeFd2[0]))) {
+            ICUNIT_GOTO_EQUAL(found, FALSE, found, OUT3);
+            found = TRUE;
+        }
+    }
+    ICUNIT_GOTO_EQUAL(found, TRUE, found, OUT3);
+
+    retval = read(pipeFd2[0], buf, sizeof(buf));
+    ICUNIT_GOTO_EQUAL(retval, 10, retval, OUT3); /* 10, write size */
+    retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+    ICUNIT_GOTO_NOT_EQUAL(retval, -1, retval, OUT3);
+    retval = write(pipeFd2[1], "0123456789", 10); /* 10, write size */
+    ICUNIT_GOTO_EQUAL(retval, 10, retval, OUT3); /* 10, write size */
+    found = FALSE;
+    for (i = 0; (i < 2) && !found; i++) { /* 2, the ready list is scanned for one lap at most */
+        retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+        ICUNIT_GOTO_NOT_EQUAL(retval, -1, retval, OUT3);
+        found = (evWait[0].data.fd == pipeFd2[0]) || ((retval > 1) && (evWait[1].data.fd == pipeFd2[0]));
+    }
+    ICUNIT_GOTO_EQUAL(found, TRUE, found, OUT3);
+
+    retval = epoll_ctl(epFd, EPOLL_CTL_DEL, pipeFd2[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT3);
+    close(pipeFd2[0]);
+    close(pipeFd2[1]);
+
+    retval = epoll_ctl(epFd, EPOLL_CTL_DEL, pipeFd[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+    retval = epoll_ctl(epFd, EPOLL_CTL_DEL, pipeFd[0], &ev);
+    ICUNIT_GOTO_EQUAL(retval, -1, retval, OUT1);
+    ICUNIT_GOTO_EQUAL(errno, ENOENT, errno, OUT1);
+
+    retval = epoll_wait(epFd, evWait, 2, 0); /* 2, num of wait fd */
+    ICUNIT_GOTO_EQUAL(retval, 0, retval, OUT1);
+
+    close(epFd);
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+    return LOS_OK;
+OUT3:
+    close(pipeFd2[0]);
+    close(pipeFd2[1]);
+OUT1:
+    close(epFd);
+OUT2:
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+    return LOS_NOK;
+}
+
+VOID IO_TEST_EPOLL_003(VOID)
+{
+    TEST_ADD_CASE(__FUNCTION__, testcase, TEST_LIB, TEST_LIBC, TEST_LEVEL1, TEST_FUNCTION);
+}
@@ -160,6 +160,16 @@ HWTEST_F(IoTest, IO_TEST_EPOLL_002, TestSize.Level0)
     IO_TEST_EPOLL_002();
 }
 
+/* *
+ * @tc.name: IO_TEST_EPOLL_003
+ * @tc.desc: function for IoTest
+ * @tc.type: FUNC
+ */
+HWTEST_F(IoTest, IO_TEST_EPOLL_003, TestSize.Level0)
+{
+    IO_TEST_EPOLL_003();
+}
+
 /* *
  * @tc.name: IT_STDLIB_POLL_002
  * @tc.desc: function for IoTest
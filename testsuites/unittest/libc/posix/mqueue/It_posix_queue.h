@@ -274,5 +274,6 @@ VOID ItPosixQueue206(VOID);
 VOID ItPosixQueue207(VOID);
 VOID ItPosixQueue208(VOID);
 VOID ItPosixQueue209(VOID);
+VOID ItPosixQueue210(VOID);
 #endif
 #endif
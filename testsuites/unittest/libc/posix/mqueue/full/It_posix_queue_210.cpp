@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2023 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_posix_queue.h"
+
+#define MQUEUE_BACKLOG_PRIO_TEST 0
+#define NSEC_PER_SEC_TEST 1000000000LL
+
+static UINT32 Testcase(VOID)
+{
+    INT32 ret, i;
+    UINT32 prio;
+    INT64 latency;
+    CHAR mqname[MQUEUE_STANDARD_NAME_LENGTH] = "";
+    CHAR msgrcd[MQUEUE_STANDARD_NAME_LENGTH] = {0};
+    struct timespec start, end;
+    struct mq_attr attr = {0};
+    mqd_t mqueue;
+    UINT32 highPrio = (UINT32)sysconf(_SC_MQ_PRIO_MAX) - 1;
+
+    ret = snprintf_s(mqname, MQUEUE_STANDARD_NAME_LENGTH, MQUEUE_STANDARD_NAME_LENGTH - 1,
+                     "/mq210_%d", LosCurTaskIDGet());
+    ICUNIT_GOTO_NOT_EQUAL(ret, MQUEUE_IS_ERROR, ret, EXIT2);
+
+    attr.mq_msgsize = MQUEUE_STANDARD_NAME_LENGTH;
+    attr.mq_maxmsg = MQ_MAX_MSG_NUM;
+    mqueue = mq_open(mqname, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, &attr);
+    ICUNIT_GOTO_NOT_EQUAL(mqueue, (mqd_t)-1, mqueue, EXIT);
+
+    /* saturate the queue with low priority messages, leaving room for one more */
+    for (i = 0; i < MQ_MAX_MSG_NUM - 1; i++) {
+        ret = mq_send(mqueue, g_mqueueMsessage[i % MQUEUE_SHORT_ARRAY_LENGTH], MQUEUE_SHORT_ARRAY_LENGTH,
+                      MQUEUE_BACKLOG_PRIO_TEST);
+        ICUNIT_GOTO_EQUAL(ret, MQUEUE_NO_ERROR, ret, EXIT1);
+    }
+
+    /* the high priority message overtakes the whole backlog */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = mq_send(mqueue, MQUEUE_SEND_STRING_TEST, MQUEUE_SHORT_ARRAY_LENGTH, highPrio);
+    ICUNIT_GOTO_EQUAL(ret, MQUEUE_NO_ERROR, ret, EXIT1);
+    ret = mq_receive(mqueue, msgrcd, MQUEUE_STANDARD_NAME_LENGTH, &prio);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ICUNIT_GOTO_EQUAL(ret, MQUEUE_SHORT_ARRAY_LENGTH, ret, EXIT1);
+    ICUNIT_GOTO_EQUAL(prio, highPrio, prio, EXIT1);
+    ICUNIT_GOTO_STRING_EQUAL(msgrcd, MQUEUE_SEND_STRING_TEST, msgrcd, EXIT1);
+
+    latency = (end.tv_sec - start.tv_sec) * NSEC_PER_SEC_TEST + (end.tv_nsec - start.tv_nsec);
+    printf("high priority message behind %d queued messages: %lld ns\n", MQ_MAX_MSG_NUM - 1, latency);
+
+    /* the backlog is still received in FIFO order */
+    for (i = 0; i < MQ_MAX_MSG_NUM - 1; i++) {
+        ret = mq_receive(mqueue, msgrcd, MQUEUE_STANDARD_NAME_LENGTH, &prio);
+        ICUNIT_GOTO_EQUAL(ret, MQUEUE_SHORT_ARRAY_LENGTH, ret, EXIT1);
+        ICUNIT_GOTO_EQUAL(prio, MQUEUE_BACKLOG_PRIO_TEST, prio, EXIT1);
+        ret = strncmp(msgrcd, g_mqueueMsessage[i % MQUEUE_SHORT_ARRAY_LENGTH], MQUEUE_SHORT_ARRAY_LENGTH);
+        ICUNIT_GOTO_EQUAL(ret, MQUEUE_NO_ERROR, ret, EXIT1);
+    }
+
+    ret = mq_close(mqueue);
+    ICUNIT_GOTO_EQUAL(ret, MQUEUE_NO_ERROR, ret, EXIT);
+
+    ret = mq_unlink(mqname);
+    ICUNIT_GOTO_EQUAL(ret, MQUEUE_NO_ERROR, ret, EXIT2);
+
+    return MQUEUE_NO_ERROR;
+EXIT1:
+    mq_close(mqueue);
+EXIT:
+    mq_unlink(mqname);
+EXIT2:
+    return MQUEUE_NO_ERROR;
+}
+
+VOID ItPosixQueue210(VOID)
+{
+    TEST_ADD_CASE("IT_POSIX_QUEUE_210", Testcase, TEST_POSIX, TEST_QUE, TEST_LEVEL2, TEST_FUNCTION);
+}
@@ -130,4 +130,5 @@ extern void ItTestProcessSmp005(void);
 extern void ItTestProcessSmp006(void);
 extern void ItTestProcessSmp007(void);
 extern void ItTestProcessSmp008(void);
+extern void ItTestProcessSmp009(void);
 #endif
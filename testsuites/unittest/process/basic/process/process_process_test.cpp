@@ -521,6 +521,16 @@ HWTEST_F(ProcessProcessTest, ItTestProcessSmp008, TestSize.Level0)
 {
     ItTestProcessSmp008();
 }
+
+/* *
+ * @tc.name: it_test_process_smp_009
+ * @tc.desc: function for ProcessProcessTest
+ * @tc.type: FUNC
+ */
+HWTEST_F(ProcessProcessTest, ItTestProcessSmp009, TestSize.Level0)
+{
+    ItTestProcessSmp009();
+}
 #endif
 #endif
 
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2023 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "it_test_process.h"
+
+#define PINGPONG_MAX_CPUS   16
+#define PINGPONG_TEST_SEC   1
+
+struct PingPong {
+    sem_t ping;
+    sem_t pong;
+    int cpu;
+    volatile int stop;
+    unsigned long rounds;
+};
+
+static struct PingPong g_pingPong[PINGPONG_MAX_CPUS];
+
+struct Yielder {
+    int cpu;
+    volatile int stop;
+    unsigned long yields;
+};
+
+static struct Yielder g_yielder[PINGPONG_MAX_CPUS];
+
+static int BindCpu(int cpu)
+{
+    cpu_set_t cpuset;
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+}
+
+static void *PingThread(void *arg)
+{
+    struct PingPong *pp = (struct PingPong *)arg;
+
+    (void)BindCpu(pp->cpu);
+    while (!pp->stop) {
+        (void)sem_post(&pp->ping);
+        (void)sem_wait(&pp->pong);
+        pp->rounds++;
+    }
+    (void)sem_post(&pp->ping);
+    return NULL;
+}
+
+static void *PongThread(void *arg)
+{
+    struct PingPong *pp = (struct PingPong *)arg;
+
+    (void)BindCpu(pp->cpu);
+    while (!pp->stop) {
+        (void)sem_wait(&pp->ping);
+        (void)sem_post(&pp->pong);
+    }
+    (void)sem_post(&pp->pong);
+    return NULL;
+}
+
+/* Every round trip is two wakeups, each pair runs on its own core */
+static unsigned long WakeupsPerSecond(int cpus)
+{
+    pthread_t ping[PINGPONG_MAX_CPUS];
+    pthread_t pong[PINGPONG_MAX_CPUS];
+    unsigned long rounds = 0;
+    int ret;
+    int i;
+
+    for (i = 0; i < cpus; i++) {
+        struct PingPong *pp = &g_pingPong[i];
+        (void)memset_s(pp, sizeof(struct PingPong), 0, sizeof(struct PingPong));
+        pp->cpu = i;
+        (void)sem_init(&pp->ping, 0, 0);
+        (void)sem_init(&pp->pong, 0, 0);
+        ret = pthread_create(&pong[i], NULL, PongThread, pp);
+        if (ret != 0) {
+            return 0;
+        }
+        ret = pthread_create(&ping[i], NULL, PingThread, pp);
+        if (ret != 0) {
+            return 0;
+        }
+    }
+
+    sleep(PINGPONG_TEST_SEC);
+
+    for (i = 0; i < cpus; i++) {
+        g_pingPong[i].stop = 1;
+    }
+
+    for (i = 0; i < cpus; i++) {
+        (void)pthread_join(ping[i], NULL);
+        (void)pthread_join(pong[i], NULL);
+        (void)sem_destroy(&g_pingPong[i].ping);
+        (void)sem_destroy(&g_pingPong[i].pong);
+        rounds += g_pingPong[i].rounds;
+    }
+
+    return (rounds * 2) / PINGPONG_TEST_SEC; /* 2: wakeups of one round trip */
+}
+
+static void *YieldThread(void *arg)
+{
+    struct Yielder *yd = (struct Yielder *)arg;
+
+    (void)BindCpu(yd->cpu);
+    while (!yd->stop) {
+        (void)sched_yield();
+        yd->yields++;
+    }
+    return NULL;
+}
+
+/* One yielding thread per core, none of them has a peer to switch to */
+static unsigned long YieldsPerSecond(int cpus)
+{
+    pthread_t thread[PINGPONG_MAX_CPUS];
+    unsigned long yields = 0;
+    int ret;
+    int i;
+
+    for (i = 0; i < cpus; i++) {
+        struct Yielder *yd = &g_yielder[i];
+        (void)memset_s(yd, sizeof(struct Yielder), 0, sizeof(struct Yielder));
+        yd->cpu = i;
+        ret = pthread_create(&thread[i], NULL, YieldThread, yd);
+        if (ret != 0) {
+            return 0;
+        }
+    }
+
+    sleep(PINGPONG_TEST_SEC);
+
+    for (i = 0; i < cpus; i++) {
+        g_yielder[i].stop = 1;
+    }
+
+    for (i = 0; i < cpus; i++) {
+        (void)pthread_join(thread[i], NULL);
+        yields += g_yielder[i].yields;
+    }
+
+    return yields / PINGPONG_TEST_SEC;
+}
+
+static int Testcase(void)
+{
+    int cpuCount = GetCpuCount();
+    unsigned long wakeups;
+    unsigned long wakeupsOne = 0;
+    unsigned long yields;
+    unsigned long yieldsOne = 0;
+
+    if (cpuCount > PINGPONG_MAX_CPUS) {
+        cpuCount = PINGPONG_MAX_CPUS;
+    }
+
+    for (int cpus = 1; cpus <= cpuCount; cpus++) {
+        wakeups = WakeupsPerSecond(cpus);
+        yields = YieldsPerSecond(cpus);
+        printf("sched wakeup benchmark: %d cores, %lu wakeups/s, %lu yields/s\n", cpus, wakeups, yields);
+        ICUNIT_ASSERT_NOT_EQUAL(wakeups, 0, wakeups);
+        ICUNIT_ASSERT_NOT_EQUAL(yields, 0, yields);
+        if (cpus == 1) {
+            wakeupsOne = wakeups;
+            yieldsOne = yields;
+            continue;
+        }
+
+        /* Independent pairs must not slow each other down below the rate of a single core */
+        ICUNIT_ASSERT_WITHIN_EQUAL(wakeups, wakeupsOne, LONG_MAX, wakeups);
+        /* A yield with nothing else to run takes no global lock, it scales at least half linearly */
+        ICUNIT_ASSERT_WITHIN_EQUAL(yields, (yieldsOne * cpus) / 2, LONG_MAX, yields); /* 2: half linear */
+    }
+
+    return 0;
+}
+
+void ItTestProcessSmp009(void)
+{
+    TEST_ADD_CASE("IT_POSIX_PROCESS_SMP_009", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_PERFORMANCE);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_mutex_test.h"
+
+static const int PING_PONG_COUNT = 10000;
+
+static pthread_mutex_t g_pingPongLock;
+static pthread_cond_t g_pingPongCond;
+static volatile int g_pingPongTurn = 0;
+static volatile int g_pingPongCount = 0;
+
+/* every round the token goes to the other thread through a futex wake and a futex wait */
+static void *ThreadFuncTest(void *arg)
+{
+    int self = (int)(intptr_t)arg;
+    int ret;
+
+    while (1) {
+        ret = pthread_mutex_lock(&g_pingPongLock);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+        while ((g_pingPongTurn != self) && (g_pingPongCount < PING_PONG_COUNT)) {
+            ret = pthread_cond_wait(&g_pingPongCond, &g_pingPongLock);
+            ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT1);
+        }
+
+        if (g_pingPongCount >= PING_PONG_COUNT) {
+            (void)pthread_cond_signal(&g_pingPongCond);
+            (void)pthread_mutex_unlock(&g_pingPongLock);
+            break;
+        }
+
+        g_pingPongCount++;
+        g_pingPongTurn = !self;
+        ret = pthread_cond_signal(&g_pingPongCond);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT1);
+        ret = pthread_mutex_unlock(&g_pingPongLock);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    }
+
+    return nullptr;
+
+EXIT1:
+    (void)pthread_mutex_unlock(&g_pingPongLock);
+EXIT:
+    return (void *)-1;
+}
+
+static int Testcase(void)
+{
+    int ret;
+    pthread_t tid[2]; /* 2, ping and pong */
+    void *result = nullptr;
+    struct timespec start = { 0 };
+    struct timespec end = { 0 };
+    long long costUs;
+
+    g_pingPongTurn = 0;
+    g_pingPongCount = 0;
+    ret = pthread_mutex_init(&g_pingPongLock, nullptr);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    ret = pthread_cond_init(&g_pingPongCond, nullptr);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < 2; i++) { /* 2, ping and pong */
+        ret = pthread_create(&tid[i], nullptr, ThreadFuncTest, (void *)(intptr_t)i);
+        ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    }
+
+    for (int i = 0; i < 2; i++) { /* 2, ping and pong */
+        ret = pthread_join(tid[i], &result);
+        ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+        ICUNIT_ASSERT_EQUAL(result, nullptr, result);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ICUNIT_ASSERT_EQUAL(g_pingPongCount, PING_PONG_COUNT, g_pingPongCount);
+    costUs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000; /* 1000000, 1000: to us */
+    printf("futex ping-pong: %d rounds in %lld us\n", PING_PONG_COUNT, costUs);
+
+    pthread_cond_destroy(&g_pingPongCond);
+    pthread_mutex_destroy(&g_pingPongLock);
+    return 0;
+}
+
+void ItTestPthreadMutex026(void)
+{
+    TEST_ADD_CASE("IT_POSIX_PTHREAD_MUTEX_026", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_PERFORMANCE);
+}
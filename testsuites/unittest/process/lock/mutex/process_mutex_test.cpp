@@ -305,5 +305,15 @@ HWTEST_F(ProcessMutexTest, ItTestPthreadMutex025, TestSize.Level0)
 {
     ItTestPthreadMutex025();
 }
+
+/* *
+ * @tc.name: it_test_pthread_mutex_026
+ * @tc.desc: test mutex and condvar ping-pong between two threads, time the futex wait and wake
+ * @tc.type: FUNC
+ */
+HWTEST_F(ProcessMutexTest, ItTestPthreadMutex026, TestSize.Level0)
+{
+    ItTestPthreadMutex026();
+}
 #endif
 } // namespace OHOS